@@ -0,0 +1,117 @@
+/* bench.c - bench_run, bench_report, bench_ns, testexit */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+uint32	bench_tsc_mhz = 1;		/* TSC ticks per microsecond	*/
+
+/* Table of benchmarks; the name is matched against bench=<name>	*/
+
+struct	benchmark benchtab[] = {
+	{ "vmfault",	bench_vmfault },
+	{ "pagecopy",	bench_pagecopy },
+	{ "sched",	bench_sched },
+	{ "timer",	bench_timer },
+	{ "fair",	bench_fair },
+	{ "lock",	bench_lock },
+	{ "alloc",	bench_alloc },
+	{ "heap",	bench_heap },
+	{ "port",	bench_port },
+	{ "spsc",	bench_spsc },
+	{ "workq",	bench_workq },
+	{ "coro",	bench_coro },
+	{ "spawn",	bench_spawn },
+};
+
+int32	nbench = sizeof(benchtab) / sizeof(struct benchmark);
+
+/*------------------------------------------------------------------------
+ * bench_calibrate - Measure the TSC rate against the real-time clock
+ *------------------------------------------------------------------------
+ */
+local	void	bench_calibrate(void)
+{
+	uint64	start;			/* TSC before sleeping		*/
+	uint32	ticks;			/* TSC ticks during the sleep	*/
+
+	start = getticks();
+	sleepms(BENCHCALMS);
+	ticks = (uint32)(getticks() - start);
+	bench_tsc_mhz = ticks / (BENCHCALMS * 1000);
+	if (bench_tsc_mhz == 0) {
+		bench_tsc_mhz = 1;
+	}
+	bench_report("tsc", "rate", bench_tsc_mhz, "MHz");
+}
+
+/*------------------------------------------------------------------------
+ * bench_run - Run the named benchmark (or all of them for "all")
+ *------------------------------------------------------------------------
+ */
+status	bench_run(
+	  char		*name		/* Benchmark name or "all"	*/
+	)
+{
+	int32	i;			/* Index into benchtab		*/
+	bool8	found = FALSE;		/* Was a benchmark selected?	*/
+
+	bench_calibrate();
+	for (i = 0; i < nbench; i++) {
+		if (strncmp(name, "all", 4) == 0
+		    || strncmp(name, benchtab[i].name, 32) == 0) {
+			kprintf(".........run BENCH %s......\n",
+						benchtab[i].name);
+			benchtab[i].bench();
+			found = TRUE;
+		}
+	}
+	if (!found) {
+		kprintf("\nUnknown benchmark %s\n", name);
+		return SYSERR;
+	}
+	kprintf("\nAll benchmarks are done!\n");
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * bench_report - Emit one result line in the form parsed by qemu-run
+ *------------------------------------------------------------------------
+ */
+void	bench_report(
+	  char		*bench,		/* Benchmark name		*/
+	  char		*metric,	/* What was measured		*/
+	  uint32	value,		/* Measured value		*/
+	  char		*unit		/* Unit of the value		*/
+	)
+{
+	kprintf("BENCH %s %s %u %s\n", bench, metric, value, unit);
+}
+
+/*------------------------------------------------------------------------
+ * bench_ns - Convert a TSC interval (below 2^32 ticks) to nanoseconds
+ *------------------------------------------------------------------------
+ */
+uint32	bench_ns(
+	  uint64	cycles		/* Interval in TSC ticks	*/
+	)
+{
+	uint32	c = (uint32)cycles;
+
+	return (c / bench_tsc_mhz) * 1000
+		+ ((c % bench_tsc_mhz) * 1000) / bench_tsc_mhz;
+}
+
+/*------------------------------------------------------------------------
+ * testexit - Power off qemu when booted by qemu-run ("qemu" argument)
+ *------------------------------------------------------------------------
+ */
+void	testexit(
+	  int32		code		/* Exit code handed to qemu	*/
+	)
+{
+	char	arg[4];			/* Unused argument value	*/
+
+	if (getbootarg("qemu", arg, sizeof(arg)) == OK) {
+		outb(QEMU_EXIT_PORT, code);
+	}
+}
@@ -0,0 +1,136 @@
+/* bench_alloc.c - bench_alloc */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BA_SLOTS	256		/* Blocks live at once (at most)	*/
+#define	BA_OPS		20000		/* Allocations and frees timed	*/
+#define	BA_NSIZES	5		/* Sizes drawn from basizes	*/
+
+/* Request sizes of the kernel's callers: small control blocks, an	*/
+/*   odd size, a buffer, an Ethernet frame and a page			*/
+
+local	uint32	basizes[BA_NSIZES] = { 32, 100, 512, 1500, 4096 };
+
+local	char	*baaddr[BA_SLOTS];	/* Block held in each slot	*/
+local	uint32	basize[BA_SLOTS];	/* Its size			*/
+
+/*------------------------------------------------------------------------
+ * alloc_freeblocks - Number of free blocks in the heap
+ *------------------------------------------------------------------------
+ */
+local	uint32	alloc_freeblocks(void)
+{
+	uint32	kfree, nblocks, largest; /* Heap statistics		*/
+
+	heapstat(&kfree, &nblocks, &largest);
+	return nblocks;
+}
+
+/*------------------------------------------------------------------------
+ * alloc_churn - Allocate into or free a pseudo-random slot BA_OPS times,
+ *		   through the slab caches or through the heap only,
+ *		   and return the TSC ticks taken
+ *------------------------------------------------------------------------
+ */
+local	uint32	alloc_churn(
+	  bool8		slab		/* Use getmem/freemem?		*/
+	)
+{
+	uint32	seed = 12345;		/* LCG state			*/
+	uint32	slot;			/* Slot picked			*/
+	int32	i;			/* Operation index		*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks;			/* TSC ticks taken		*/
+
+	for (i = 0; i < BA_SLOTS; i++) {
+		baaddr[i] = NULL;
+	}
+
+	start = getticks();
+	for (i = 0; i < BA_OPS; i++) {
+		seed = seed * 1103515245 + 12345;
+		slot = (seed >> 16) % BA_SLOTS;
+		if (baaddr[slot] != NULL) {
+			if (slab) {
+				freemem(baaddr[slot], basize[slot]);
+			} else {
+				mask = disable();
+				heapfree(baaddr[slot], basize[slot]);
+				restore(mask);
+			}
+			baaddr[slot] = NULL;
+			continue;
+		}
+		basize[slot] = basizes[(seed >> 8) % BA_NSIZES];
+		if (slab) {
+			baaddr[slot] = getmem(basize[slot]);
+		} else {
+			mask = disable();
+			baaddr[slot] = heapget(basize[slot]);
+			restore(mask);
+		}
+		if (baaddr[slot] == (char *)SYSERR) {
+			baaddr[slot] = NULL;
+		}
+	}
+	ticks = (uint32)(getticks() - start);
+
+	/* Leave the blocks in place until the heap is counted	*/
+
+	return ticks;
+}
+
+/*------------------------------------------------------------------------
+ * alloc_release - Free whatever alloc_churn left allocated
+ *------------------------------------------------------------------------
+ */
+local	void	alloc_release(
+	  bool8		slab		/* Blocks came from getmem?	*/
+	)
+{
+	int32	i;			/* Slot index			*/
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	for (i = 0; i < BA_SLOTS; i++) {
+		if (baaddr[i] == NULL) {
+			continue;
+		}
+		if (slab) {
+			freemem(baaddr[i], basize[i]);
+		} else {
+			mask = disable();
+			heapfree(baaddr[i], basize[i]);
+			restore(mask);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ * bench_alloc - ns per operation of a mixed-size allocate/free churn
+ *		 through the slab caches and through the heap alone, and
+ *		 the free heap blocks left behind by each
+ *------------------------------------------------------------------------
+ */
+void	bench_alloc(void)
+{
+	uint32	ticks;			/* TSC ticks for a churn	*/
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	slabreclaim();
+	restore(mask);
+
+	ticks = alloc_churn(FALSE);
+	bench_report("alloc", "heap_op", bench_ns(ticks / BA_OPS), "ns/op");
+	bench_report("alloc", "heap_freeblocks", alloc_freeblocks(),
+								"blocks");
+	alloc_release(FALSE);
+
+	ticks = alloc_churn(TRUE);
+	bench_report("alloc", "slab_op", bench_ns(ticks / BA_OPS), "ns/op");
+	bench_report("alloc", "slab_freeblocks", alloc_freeblocks(),
+								"blocks");
+	alloc_release(TRUE);
+}
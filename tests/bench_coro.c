@@ -0,0 +1,126 @@
+/* bench_coro.c - bench_coro */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BC_TASKS	32		/* Tasks switching among	*/
+					/*   themselves			*/
+#define	BC_ROUNDS	100		/* Yields by each of them	*/
+#define	BC_SPAWNS	1000		/* Tasks created and finished	*/
+#define	BC_MANY		2000		/* Coroutines alive at once	*/
+#define	BC_MANYROUNDS	10		/* Yields by each of those	*/
+
+local	sid32	bcdone;			/* Signaled by finished tasks	*/
+
+/*------------------------------------------------------------------------
+ * bc_proc, bc_coro - A task that yields rounds times; the process
+ *		      version signals bcdone when it finishes
+ *------------------------------------------------------------------------
+ */
+local	process	bc_proc(
+	  int32		rounds		/* Times to yield		*/
+	)
+{
+	while (rounds-- > 0) {
+		yield();
+	}
+	signal(bcdone);
+	return OK;
+}
+
+local	void	bc_coro(
+	  int32		rounds		/* Times to yield		*/
+	)
+{
+	while (rounds-- > 0) {
+		coyield();
+	}
+}
+
+/*------------------------------------------------------------------------
+ * bc_report - Report ticks spent per unit of work
+ *------------------------------------------------------------------------
+ */
+local	void	bc_report(
+	  char		*metric,	/* Name of the result		*/
+	  uint64	start,		/* TSC at the start		*/
+	  uint32	units,		/* Switches or tasks done	*/
+	  char		*unit		/* Unit of the result		*/
+	)
+{
+	uint32	ticks = (uint32)(getticks() - start);
+
+	bench_report("coro", metric, bench_ns(ticks / units), unit);
+}
+
+/*------------------------------------------------------------------------
+ * bench_coro - One process per task against coroutines in one process:
+ *		ns per switch among BC_TASKS tasks, ns to create, run and
+ *		finish a task, and ns per switch among BC_MANY coroutines
+ *		with 1 KB stacks (more than NPROC processes could hold)
+ *------------------------------------------------------------------------
+ */
+void	bench_coro(void)
+{
+	struct	cosched	cs;		/* Coroutines under test	*/
+	pid32	pids[BC_TASKS];		/* Processes under test		*/
+	int32	i;			/* Task index			*/
+	int32	n;			/* Coroutines created		*/
+	uint64	start;			/* TSC at the start		*/
+	pri16	prio = getprio(getpid());
+
+	bcdone = semcreate(0);
+	if (bcdone == SYSERR || coinit(&cs, BC_MANY, COMINSTK) == SYSERR) {
+		kprintf("coro: cannot set up\n");
+		return;
+	}
+
+	for (i = 0; i < BC_TASKS; i++) {
+		pids[i] = create(bc_proc, 4096, prio, "bcproc", 1, BC_ROUNDS);
+	}
+	start = getticks();
+	for (i = 0; i < BC_TASKS; i++) {
+		resume(pids[i]);
+	}
+	for (i = 0; i < BC_TASKS; i++) {
+		wait(bcdone);
+	}
+	bc_report("proc_yield", start, BC_TASKS * BC_ROUNDS, "ns/switch");
+
+	for (i = 0; i < BC_TASKS; i++) {
+		cocreate(&cs, bc_coro, BC_ROUNDS);
+	}
+	start = getticks();
+	corun(&cs);
+	bc_report("coro_yield", start, BC_TASKS * BC_ROUNDS, "ns/switch");
+
+	start = getticks();
+	for (i = 0; i < BC_SPAWNS; i++) {
+		resume(create(bc_proc, 4096, prio + 1, "bcproc", 1, 0));
+		wait(bcdone);
+	}
+	bc_report("proc_spawn", start, BC_SPAWNS, "ns/task");
+
+	start = getticks();
+	for (i = 0; i < BC_SPAWNS; i++) {
+		cocreate(&cs, bc_coro, 0);
+		corun(&cs);
+	}
+	bc_report("coro_spawn", start, BC_SPAWNS, "ns/task");
+
+	for (n = 0; n < BC_MANY; n++) {
+		if (cocreate(&cs, bc_coro, BC_MANYROUNDS) == SYSERR) {
+			break;
+		}
+	}
+	bench_report("coro", "many_tasks", n, "coroutines");
+	if (n > 0) {
+		start = getticks();
+		corun(&cs);
+		bc_report("many_yield", start, n * BC_MANYROUNDS,
+							"ns/switch");
+	}
+
+	codone(&cs);
+	semdelete(bcdone);
+}
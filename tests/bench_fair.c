@@ -0,0 +1,77 @@
+/* bench_fair.c - bench_fair */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BF_NPROC	3		/* Competing user processes	*/
+#define	BF_MS		2000		/* How long they compete	*/
+
+local	int32	bf_prio[BF_NPROC] = { 10, 20, 40 };	/* Weights	*/
+local	volatile uint32	bf_count[BF_NPROC];	/* Loops by each	*/
+local	uint32	bf_end;			/* ctr1000 at which to stop	*/
+local	sid32	bf_done;		/* Signalled as each finishes	*/
+
+/*------------------------------------------------------------------------
+ * bf_spin - Count loops until bf_end (a compute-bound user process)
+ *------------------------------------------------------------------------
+ */
+local	void	bf_spin(
+	  int32		idx		/* Slot in bf_count		*/
+	)
+{
+	while ((int32)(ctr1000 - bf_end) < 0) {
+		bf_count[idx]++;
+	}
+	signal(bf_done);
+}
+
+/*------------------------------------------------------------------------
+ * bench_fair - CPU share (per mille) of compute-bound user processes of
+ *		  priority 10, 20 and 40; strict priority gives it all to
+ *		  the highest, the fair class ("fair" boot argument) about
+ *		  1:2:4
+ *------------------------------------------------------------------------
+ */
+void	bench_fair(void)
+{
+	pid32	pids[BF_NPROC];		/* Competing processes		*/
+	char	metric[16];		/* Metric name			*/
+	uint32	total;			/* Loops by all of them		*/
+	int32	i;			/* Process index		*/
+
+	bf_done = semcreate(0);
+	for (i = 0; i < BF_NPROC; i++) {
+		bf_count[i] = 0;
+		pids[i] = vcreate(bf_spin, BENCHSTK, 1, bf_prio[i], "bfspin",
+								1, i);
+		if (pids[i] == SYSERR) {
+			kprintf("fair: vcreate failed\n");
+			while (--i >= 0) {
+				kill(pids[i]);
+			}
+			semdelete(bf_done);
+			return;
+		}
+	}
+	bf_end = ctr1000 + BF_MS;
+	for (i = 0; i < BF_NPROC; i++) {
+		resume(pids[i]);
+	}
+	for (i = 0; i < BF_NPROC; i++) {
+		wait(bf_done);
+	}
+	semdelete(bf_done);
+
+	total = 0;
+	for (i = 0; i < BF_NPROC; i++) {
+		total += bf_count[i] / 1000;
+	}
+	if (total == 0) {
+		total = 1;
+	}
+	for (i = 0; i < BF_NPROC; i++) {
+		sprintf(metric, "share_prio%d", bf_prio[i]);
+		bench_report("fair", metric, bf_count[i] / 1000 * 1000 / total,
+							"permille");
+	}
+}
@@ -0,0 +1,120 @@
+/* bench_heap.c - bench_heap */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BH_SLOTS	48		/* Blocks live at once (at most)	*/
+#define	BH_ROUNDS	20		/* Fragmentation samples taken	*/
+#define	BH_OPS		10000		/* Allocations and frees a round	*/
+
+#define	BHNAME		"heap_" HEAPNAME /* Results name the backend	*/
+
+/* Buffer sizes of the pools allocated (mkbufpool adds a pool id)	*/
+
+#define	BH_NBUFSIZ	4
+local	uint32	bhbufsiz[BH_NBUFSIZ] = { 128, 512, 1500, BP_MAXB };
+
+local	char	*bhaddr[BH_SLOTS];	/* Block held in each slot	*/
+local	uint32	bhsize[BH_SLOTS];	/* Its size			*/
+local	bool8	bhstack[BH_SLOTS];	/* From getstk?			*/
+
+/*------------------------------------------------------------------------
+ * heap_frag - Per mille of free heap memory outside the largest block
+ *------------------------------------------------------------------------
+ */
+local	uint32	heap_frag(
+	  uint32	*nblocks,	/* Set to the free blocks	*/
+	  uint32	*largest	/* Set to the largest block	*/
+	)
+{
+	uint32	kfree;			/* Free bytes in the heap	*/
+
+	heapstat(&kfree, nblocks, largest);
+	if (kfree < 1024) {
+		return 0;
+	}
+	return 1000 - ((*largest >> 10) * 1000) / (kfree >> 10);
+}
+
+/*------------------------------------------------------------------------
+ * bench_heap - Long churn of process stacks and buffer pools through
+ *		getstk and getmem; reports the worst and final
+ *		fragmentation of the heap, its free blocks and largest
+ *		block, failed allocations and ns per operation
+ *------------------------------------------------------------------------
+ */
+void	bench_heap(void)
+{
+	uint32	seed = 4242;		/* LCG state			*/
+	uint32	slot;			/* Slot picked			*/
+	int32	round, i;		/* Loop indexes			*/
+	uint32	frag, fragmax = 0;	/* Fragmentation per mille	*/
+	uint32	nblocks, largest;	/* Heap statistics		*/
+	uint32	fails = 0;		/* Allocations that failed	*/
+	uint64	start;			/* TSC at the start of a round	*/
+	uint32	ticks = 0;		/* TSC ticks spent churning	*/
+
+	for (i = 0; i < BH_SLOTS; i++) {
+		bhaddr[i] = NULL;
+	}
+
+	for (round = 0; round < BH_ROUNDS; round++) {
+		start = getticks();
+		for (i = 0; i < BH_OPS; i++) {
+			seed = seed * 1103515245 + 12345;
+			slot = (seed >> 16) % BH_SLOTS;
+			if (bhaddr[slot] != NULL) {
+				if (bhstack[slot]) {
+					freestk(bhaddr[slot], bhsize[slot]);
+				} else {
+					freemem(bhaddr[slot], bhsize[slot]);
+				}
+				bhaddr[slot] = NULL;
+				continue;
+			}
+
+			/* One in four is a stack, the rest are pools	*/
+			/*   of 8 to 64 buffers				*/
+
+			bhstack[slot] = ((seed >> 8) & 3) == 0;
+			if (bhstack[slot]) {
+				bhsize[slot] = INITSTK;
+				bhaddr[slot] = getstk(INITSTK);
+			} else {
+				bhsize[slot] = (bhbufsiz[(seed >> 10)
+					% BH_NBUFSIZ] + sizeof(bpid32))
+					* (8 + ((seed >> 4) & 0x3f) % 57);
+				bhaddr[slot] = getmem(bhsize[slot]);
+			}
+			if (bhaddr[slot] == (char *)SYSERR) {
+				bhaddr[slot] = NULL;
+				fails++;
+			}
+		}
+		ticks += (uint32)(getticks() - start);
+
+		frag = heap_frag(&nblocks, &largest);
+		if (frag > fragmax) {
+			fragmax = frag;
+		}
+	}
+
+	bench_report(BHNAME, "op", bench_ns(ticks / (BH_ROUNDS * BH_OPS)),
+								"ns/op");
+	bench_report(BHNAME, "frag_max", fragmax, "permille");
+	bench_report(BHNAME, "frag_final", frag, "permille");
+	bench_report(BHNAME, "freeblocks_final", nblocks, "blocks");
+	bench_report(BHNAME, "largest_final", largest >> 10, "KB");
+	bench_report(BHNAME, "failures", fails, "allocs");
+
+	for (i = 0; i < BH_SLOTS; i++) {
+		if (bhaddr[i] == NULL) {
+			continue;
+		}
+		if (bhstack[i]) {
+			freestk(bhaddr[i], bhsize[i]);
+		} else {
+			freemem(bhaddr[i], bhsize[i]);
+		}
+	}
+}
@@ -0,0 +1,78 @@
+/* bench_lock.c - bench_lock */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BL_OPS		100000		/* Acquire+release pairs timed	*/
+
+/*------------------------------------------------------------------------
+ * bench_lock - ns per uncontended acquire+release pair of a semaphore
+ *		used as a lock, a priority-inheritance mutex, a lock and
+ *		a rwlock taken for reading and for writing
+ *------------------------------------------------------------------------
+ */
+void	bench_lock(void)
+{
+	sid32	sem;			/* Semaphore created with 1	*/
+	mid32	mtx;			/* Mutex			*/
+	struct	lock lk;		/* Lock				*/
+	struct	rwlock rw;		/* Reader-writer lock		*/
+	int32	i;			/* Loop index			*/
+	uint64	start;			/* TSC at the start of a loop	*/
+	uint32	ticks;			/* TSC ticks for a loop		*/
+
+	sem = semcreate(1);
+	mtx = mutexcreate();
+	if (sem == SYSERR || mtx == SYSERR || lkinit(&lk) == SYSERR
+	    || rwinit(&rw) == SYSERR) {
+		kprintf("lock: cannot create the locks\n");
+		return;
+	}
+
+	start = getticks();
+	for (i = 0; i < BL_OPS; i++) {
+		wait(sem);
+		signal(sem);
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("lock", "semaphore", bench_ns(ticks / BL_OPS), "ns/pair");
+
+	start = getticks();
+	for (i = 0; i < BL_OPS; i++) {
+		mutexlock(mtx);
+		mutexunlock(mtx);
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("lock", "mutex", bench_ns(ticks / BL_OPS), "ns/pair");
+
+	start = getticks();
+	for (i = 0; i < BL_OPS; i++) {
+		lkacquire(&lk);
+		lkrelease(&lk);
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("lock", "lock", bench_ns(ticks / BL_OPS), "ns/pair");
+
+	start = getticks();
+	for (i = 0; i < BL_OPS; i++) {
+		rwrdacquire(&rw);
+		rwrdrelease(&rw);
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("lock", "rwlock_read", bench_ns(ticks / BL_OPS),
+								"ns/pair");
+
+	start = getticks();
+	for (i = 0; i < BL_OPS; i++) {
+		rwwracquire(&rw);
+		rwwrrelease(&rw);
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("lock", "rwlock_write", bench_ns(ticks / BL_OPS),
+								"ns/pair");
+
+	semdelete(sem);
+	mutexdelete(mtx);
+	lkdelete(&lk);
+	rwdelete(&rw);
+}
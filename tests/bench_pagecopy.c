@@ -0,0 +1,107 @@
+/* bench_pagecopy.c - bench_pagecopy */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	PCB_PAGES	256		/* Pages in the working set	*/
+#define	PCB_PASSES	8		/* Sweeps over the working set	*/
+
+/*------------------------------------------------------------------------
+ * pcb_copy - Time PCB_PASSES sweeps that copy (or swap) the first half
+ *		  of the buffer onto the second half, one page at a time
+ *------------------------------------------------------------------------
+ */
+local	void	pcb_copy(
+	  char		*buf,		/* Page aligned working set	*/
+	  void		(*fn)(void *, void *), /* Copy or swap routine	*/
+	  char		*metric		/* Name reported for the result	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	int32	pass, i;		/* Sweep and page index		*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks;			/* TSC ticks taken		*/
+	uint32	us;			/* Microseconds taken		*/
+
+	mask = disable();		/* XMM state is not saved	*/
+	start = getticks();
+	for (pass = 0; pass < PCB_PASSES; pass++) {
+		for (i = 0; i < PCB_PAGES/2; i++) {
+			fn(buf + (PCB_PAGES/2 + i) * PAGE_SIZE,
+						buf + i * PAGE_SIZE);
+		}
+	}
+	ticks = (uint32)(getticks() - start);
+	restore(mask);
+
+	/* Bytes per microsecond is MB/s; the value is 1000 x GB/s	*/
+
+	us = bench_ns(ticks) / 1000;
+	if (us == 0) {
+		us = 1;
+	}
+	bench_report("pagecopy", metric,
+		(PCB_PASSES * (PCB_PAGES/2) * PAGE_SIZE) / us, "MB/s");
+}
+
+/*------------------------------------------------------------------------
+ * pcb_zero - Time PCB_PASSES sweeps that zero every page of the buffer
+ *------------------------------------------------------------------------
+ */
+local	void	pcb_zero(
+	  char		*buf,		/* Page aligned working set	*/
+	  void		(*fn)(void *),	/* Zero routine			*/
+	  char		*metric		/* Name reported for the result	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	int32	pass, i;		/* Sweep and page index		*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks;			/* TSC ticks taken		*/
+	uint32	us;			/* Microseconds taken		*/
+
+	mask = disable();
+	start = getticks();
+	for (pass = 0; pass < PCB_PASSES; pass++) {
+		for (i = 0; i < PCB_PAGES; i++) {
+			fn(buf + i * PAGE_SIZE);
+		}
+	}
+	ticks = (uint32)(getticks() - start);
+	restore(mask);
+
+	us = bench_ns(ticks) / 1000;
+	if (us == 0) {
+		us = 1;
+	}
+	bench_report("pagecopy", metric,
+		(PCB_PASSES * PCB_PAGES * PAGE_SIZE) / us, "MB/s");
+}
+
+/*------------------------------------------------------------------------
+ * bench_pagecopy - Throughput of each page copy, swap and zero variant
+ *------------------------------------------------------------------------
+ */
+void	bench_pagecopy(void)
+{
+	char	*mem;			/* Block from getmem		*/
+	char	*buf;			/* Page aligned start of mem	*/
+
+	mem = getmem((PCB_PAGES + 1) * PAGE_SIZE);
+	if ((int32)mem == SYSERR) {
+		kprintf("pagecopy: getmem failed\n");
+		return;
+	}
+	buf = (char *)(((uint32)mem + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+
+	pcb_copy(buf, page_copy_rep, "copy_rep");
+	pcb_copy(buf, page_swap_rep, "swap_rep");
+	pcb_zero(buf, page_zero_rep, "zero_rep");
+	if (page_has_sse2) {
+		pcb_copy(buf, page_copy_sse2, "copy_sse2");
+		pcb_copy(buf, page_swap_sse2, "swap_sse2");
+		pcb_zero(buf, page_zero_sse2, "zero_sse2");
+	}
+
+	freemem(mem, (PCB_PAGES + 1) * PAGE_SIZE);
+}
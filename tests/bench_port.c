@@ -0,0 +1,149 @@
+/* bench_port.c - bench_port */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BPT_MSGS	20000		/* Messages moved per run	*/
+#define	BPT_DEPTH	64		/* Messages a port holds	*/
+#define	BPT_BATCH	16		/* Messages per ptsendn/ptrecvn	*/
+#define	BPT_BUFSIZ	1500		/* Size of the buffers passed	*/
+
+#define	PB_WORD		0		/* ptsend/ptrecv of words	*/
+#define	PB_WORDN	1		/* ptsendn/ptrecvn of words	*/
+#define	PB_BUF		2		/* ptsendbuf/ptrecvbuf of	*/
+					/*   getbuf buffers		*/
+#define	PB_BUFN		3		/* getbufs/ptsendn and		*/
+					/*   ptrecvn/freebufs		*/
+
+/*------------------------------------------------------------------------
+ * port_consumer - Receive BPT_MSGS messages in the given mode, freeing
+ *		   buffers, then tell the benchmark it is done
+ *------------------------------------------------------------------------
+ */
+local	process	port_consumer(
+	  int32		port,		/* Port to receive from		*/
+	  int32		mode,		/* PB_ constant			*/
+	  pid32		parent		/* Process to notify		*/
+	)
+{
+	umsg32	msgs[BPT_BATCH];		/* Batch received		*/
+	uint32	lens[BPT_BATCH];		/* Their lengths		*/
+	uint32	len;			/* Length of one buffer		*/
+	int32	got = 0;		/* Messages received		*/
+	int32	n;			/* Messages in one batch	*/
+
+	while (got < BPT_MSGS) {
+		switch (mode) {
+		case PB_WORD:
+			ptrecv(port);
+			n = 1;
+			break;
+		case PB_WORDN:
+			n = ptrecvn(port, msgs, NULL, BPT_BATCH);
+			break;
+		case PB_BUF:
+			freebuf(ptrecvbuf(port, &len));
+			n = 1;
+			break;
+		default:
+			n = ptrecvn(port, msgs, lens, BPT_BATCH);
+			freebufs((char **)msgs, n);
+			break;
+		}
+		if (n == SYSERR) {
+			break;
+		}
+		got += n;
+	}
+	send(parent, got);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * port_run - Move BPT_MSGS messages through a port in one mode and
+ *	      report the rate
+ *------------------------------------------------------------------------
+ */
+local	void	port_run(
+	  int32		mode,		/* PB_ constant			*/
+	  bpid32	pool,		/* Pool for the buffers		*/
+	  char		*metric		/* Name of the result		*/
+	)
+{
+	int32	port;			/* Port under test		*/
+	umsg32	msgs[BPT_BATCH];		/* Batch sent			*/
+	uint32	lens[BPT_BATCH];		/* Their lengths		*/
+	int32	sent, n, i;		/* Message counts		*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks, ns;		/* Time taken			*/
+
+	port = ptcreate(BPT_DEPTH);
+	if (port == SYSERR) {
+		kprintf("port: cannot create a port\n");
+		return;
+	}
+	recvclr();
+	resume(create(port_consumer, 4096, getprio(getpid()), "ptcons", 3,
+						port, mode, getpid()));
+
+	start = getticks();
+	for (sent = 0; sent < BPT_MSGS; sent += n) {
+		n = BPT_MSGS - sent;
+		if (n > BPT_BATCH) {
+			n = BPT_BATCH;
+		}
+		switch (mode) {
+		case PB_WORD:
+			ptsend(port, sent);
+			n = 1;
+			break;
+		case PB_WORDN:
+			for (i = 0; i < n; i++) {
+				msgs[i] = sent + i;
+			}
+			ptsendn(port, msgs, NULL, n);
+			break;
+		case PB_BUF:
+			ptsendbuf(port, getbuf(pool), BPT_BUFSIZ);
+			n = 1;
+			break;
+		default:
+			n = getbufs(pool, (char **)msgs, n);
+			for (i = 0; i < n; i++) {
+				lens[i] = BPT_BUFSIZ;
+			}
+			ptsendn(port, msgs, lens, n);
+			break;
+		}
+	}
+	if (receive() != BPT_MSGS) {
+		kprintf("port: %s lost messages\n", metric);
+	}
+	ticks = (uint32)(getticks() - start);
+	ptdelete(port, NULL);
+
+	ns = bench_ns(ticks / BPT_MSGS);
+	bench_report("port", metric, ns == 0 ? 0 : 1000000000 / ns,
+								"msgs/s");
+}
+
+/*------------------------------------------------------------------------
+ * bench_port - Messages per second through a port between two processes:
+ *		single words, batches of words, buffers passed by
+ *		reference one at a time and in batches
+ *------------------------------------------------------------------------
+ */
+void	bench_port(void)
+{
+	bpid32	pool;			/* Buffers passed by reference	*/
+
+	pool = mkbufpool(BPT_BUFSIZ, 2 * BPT_DEPTH + BPT_BATCH);
+	if (pool == SYSERR) {
+		kprintf("port: cannot create a buffer pool\n");
+		return;
+	}
+	port_run(PB_WORD, pool, "word");
+	port_run(PB_WORDN, pool, "word_batch");
+	port_run(PB_BUF, pool, "buf");
+	port_run(PB_BUFN, pool, "buf_batch");
+}
@@ -0,0 +1,127 @@
+/* bench_sched.c - bench_sched */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BS_NPROC	16		/* Parked processes in the list	*/
+#define	BS_OPS		10000		/* Ready list operations timed	*/
+#define	BS_YIELDS	5000		/* Yields by each process	*/
+#define	BS_PRIO		60		/* Above main, below the shell	*/
+
+local	sid32	bs_go;			/* Releases the yielding pair	*/
+local	sid32	bs_done;		/* Signalled as each finishes	*/
+
+/*------------------------------------------------------------------------
+ * bs_park - Body of the processes used as ready list entries; they are
+ *	       never resumed, only linked in and out with interrupts off
+ *------------------------------------------------------------------------
+ */
+local	void	bs_park(void)
+{
+}
+
+/*------------------------------------------------------------------------
+ * bs_yield - Yield to the other process of the pair BS_YIELDS times
+ *------------------------------------------------------------------------
+ */
+local	void	bs_yield(void)
+{
+	int32	i;			/* Yield count			*/
+
+	wait(bs_go);
+	for (i = 0; i < BS_YIELDS; i++) {
+		yield();
+	}
+	signal(bs_done);
+}
+
+/*------------------------------------------------------------------------
+ * bs_listops - Time insert/remove pairs and highest-priority lookups
+ *		  with depth processes already in the ready list
+ *------------------------------------------------------------------------
+ */
+local	void	bs_listops(
+	  pid32		pids[],		/* Parked processes		*/
+	  int32		depth,		/* How many to link in first	*/
+	  char		*pairtag,	/* Metric for insert+remove	*/
+	  char		*firsttag	/* Metric for readyfirstkey	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	int32	i;			/* Loop index			*/
+	int32	key = 0;		/* Keeps the lookup live	*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	pair, first;		/* TSC ticks for each loop	*/
+
+	mask = disable();
+	for (i = 0; i < depth; i++) {
+		readyinsert(pids[i], 1 + i * (NRDYPRIO / BS_NPROC - 1));
+	}
+
+	start = getticks();
+	for (i = 0; i < BS_OPS; i++) {
+		readyinsert(pids[BS_NPROC - 1], BS_PRIO);
+		readyremove(pids[BS_NPROC - 1]);
+	}
+	pair = (uint32)(getticks() - start);
+
+	start = getticks();
+	for (i = 0; i < BS_OPS; i++) {
+		key += readyfirstkey();
+	}
+	first = (uint32)(getticks() - start);
+
+	for (i = 0; i < depth; i++) {
+		readyremove(pids[i]);
+	}
+	restore(mask);
+
+	bench_report("sched", pairtag, bench_ns(pair / BS_OPS), "ns/op");
+	bench_report("sched", firsttag, bench_ns(first / BS_OPS), "ns/op");
+}
+
+/*------------------------------------------------------------------------
+ * bench_sched - Cost of ready list operations and of a yield between
+ *		   two processes of equal priority
+ *------------------------------------------------------------------------
+ */
+void	bench_sched(void)
+{
+	pid32	pids[BS_NPROC];		/* Parked processes		*/
+	int32	i;			/* Loop index			*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks;			/* TSC ticks for the yields	*/
+
+	for (i = 0; i < BS_NPROC; i++) {
+		pids[i] = create(bs_park, BENCHSTK, BS_PRIO, "bspark", 0);
+		if (pids[i] == SYSERR) {
+			kprintf("sched: create failed\n");
+			while (--i >= 0) {
+				kill(pids[i]);
+			}
+			return;
+		}
+	}
+	bs_listops(pids, 0, "insert_remove_empty", "first_empty");
+	bs_listops(pids, BS_NPROC - 1, "insert_remove_deep", "first_deep");
+	for (i = 0; i < BS_NPROC; i++) {
+		kill(pids[i]);
+	}
+
+	/* Two equal-priority processes yielding back and forth */
+
+	bs_go = semcreate(0);
+	bs_done = semcreate(0);
+	resume(create(bs_yield, BENCHSTK, BS_PRIO, "bsyield1", 0));
+	resume(create(bs_yield, BENCHSTK, BS_PRIO, "bsyield2", 0));
+	start = getticks();
+	signaln(bs_go, 2);
+	wait(bs_done);
+	wait(bs_done);
+	ticks = (uint32)(getticks() - start);
+	semdelete(bs_go);
+	semdelete(bs_done);
+
+	bench_report("sched", "yield_switch",
+			bench_ns(ticks / (2 * BS_YIELDS)), "ns/switch");
+}
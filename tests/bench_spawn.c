@@ -0,0 +1,89 @@
+/* bench_spawn.c - bench_spawn */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BS_SPAWNS	1000		/* Processes created and ended	*/
+#define	BS_HEAP		16		/* Heap of a user process	*/
+					/*   (frames; never touched)	*/
+
+local	sid32	bsdone;			/* Signaled by kernel processes	*/
+
+/*------------------------------------------------------------------------
+ * bs_kproc, bs_uproc - Processes that end at once; the kernel one
+ *			signals bsdone, the user one is reported by kill
+ *------------------------------------------------------------------------
+ */
+local	process	bs_kproc(void)
+{
+	signal(bsdone);
+	return OK;
+}
+
+local	process	bs_uproc(void)
+{
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * bs_report - Report spawn/exit cycles per second
+ *------------------------------------------------------------------------
+ */
+local	void	bs_report(
+	  char		*metric,	/* Name of the result		*/
+	  uint64	start		/* TSC at the start		*/
+	)
+{
+	uint32	ns;			/* ns per spawn/exit cycle	*/
+
+	ns = bench_ns((uint32)(getticks() - start) / BS_SPAWNS);
+	bench_report("spawn", metric, (ns == 0) ? 0 : 1000000000 / ns,
+								"spawns/s");
+}
+
+/*------------------------------------------------------------------------
+ * bench_spawn - Spawn/exit cycles per second of a kernel process with an
+ *		 INITSTK stack (create, resume, kill) and of a user process
+ *		 (vcreate, resume, kill), and how many of them took their
+ *		 stack from the stack cache and their directory from the
+ *		 directory cache
+ *------------------------------------------------------------------------
+ */
+void	bench_spawn(void)
+{
+	int32	i;			/* Spawn index			*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	hits0;			/* Cache hits at the start	*/
+	uint32	vhits0;			/* Stack cache hits at start	*/
+	pri16	prio = getprio(getpid()) + 1;
+
+	bsdone = semcreate(0);
+	if (bsdone == SYSERR) {
+		kprintf("spawn: cannot set up\n");
+		return;
+	}
+
+	hits0 = stkcachehits;
+	start = getticks();
+	for (i = 0; i < BS_SPAWNS; i++) {
+		resume(create(bs_kproc, INITSTK, prio, "bskproc", 0));
+		wait(bsdone);
+	}
+	bs_report("kernel", start);
+	bench_report("spawn", "stack_hits", stkcachehits - hits0, "spawns");
+
+	recvclr();
+	hits0 = pdcachehits;
+	vhits0 = vstkcachehits;
+	start = getticks();
+	for (i = 0; i < BS_SPAWNS; i++) {
+		resume(vcreate(bs_uproc, INITSTK, BS_HEAP, prio, "bsuproc",
+									0));
+		receive();
+	}
+	bs_report("user", start);
+	bench_report("spawn", "dir_hits", pdcachehits - hits0, "spawns");
+	bench_report("spawn", "vstack_hits", vstkcachehits - vhits0, "spawns");
+
+	semdelete(bsdone);
+}
@@ -0,0 +1,164 @@
+/* bench_spsc.c - bench_spsc */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BS_ITEMS	50000		/* Words moved per run		*/
+#define	BS_SLOTS	IP_OQSIZ	/* Queue size, as for ipoqueue	*/
+
+/* The queue ipoqueue used before the ring: a circular array guarded	*/
+/*   by disable(), with one semaphore counting words and one counting	*/
+/*   free slots so the producer can block like spscput		*/
+
+struct	bsqueue	{
+	int32	bqhead;			/* Index of next word to take	*/
+	int32	bqtail;			/* Index of next free slot	*/
+	sid32	bqitems;		/* Counts words queued		*/
+	sid32	bqspace;		/* Counts free slots		*/
+	uint32	bqbuf[BS_SLOTS];	/* Circular word queue		*/
+};
+
+local	struct	bsqueue	bsq;		/* Semaphore queue under test	*/
+local	struct	spsc	bsring;		/* Ring under test		*/
+local	uint32	bsslots[BS_SLOTS];	/* Storage for the ring		*/
+
+/*------------------------------------------------------------------------
+ * bsq_put, bsq_get - Add and remove a word on the semaphore queue
+ *------------------------------------------------------------------------
+ */
+local	void	bsq_put(
+	  uint32	word		/* Word to add			*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	wait(bsq.bqspace);
+	bsq.bqbuf[bsq.bqtail++] = word;
+	if (bsq.bqtail >= BS_SLOTS) {
+		bsq.bqtail = 0;
+	}
+	signal(bsq.bqitems);
+	restore(mask);
+}
+
+local	uint32	bsq_get(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint32	word;			/* Word removed			*/
+
+	mask = disable();
+	wait(bsq.bqitems);
+	word = bsq.bqbuf[bsq.bqhead++];
+	if (bsq.bqhead >= BS_SLOTS) {
+		bsq.bqhead = 0;
+	}
+	signal(bsq.bqspace);
+	restore(mask);
+	return word;
+}
+
+/*------------------------------------------------------------------------
+ * spsc_consumer - Take BS_ITEMS words from the queue or the ring and
+ *		   send the parent the number that arrived in order
+ *------------------------------------------------------------------------
+ */
+local	process	spsc_consumer(
+	  bool8		ring,		/* Use the ring?		*/
+	  pid32		parent		/* Process to notify		*/
+	)
+{
+	int32	i;			/* Word index			*/
+	int32	inorder = 0;		/* Words that arrived in order	*/
+
+	for (i = 0; i < BS_ITEMS; i++) {
+		if ((ring ? spscget(&bsring) : bsq_get()) == i) {
+			inorder++;
+		}
+	}
+	send(parent, inorder);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ * spsc_run - Move BS_ITEMS words to a consumer process and report the
+ *	      rate
+ *------------------------------------------------------------------------
+ */
+local	void	spsc_run(
+	  bool8		ring,		/* Use the ring?		*/
+	  char		*metric		/* Name of the result		*/
+	)
+{
+	int32	i;			/* Word index			*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks, ns;		/* Time taken			*/
+
+	recvclr();
+	resume(create(spsc_consumer, 4096, getprio(getpid()), "spscons", 2,
+							ring, getpid()));
+	start = getticks();
+	for (i = 0; i < BS_ITEMS; i++) {
+		if (ring) {
+			spscput(&bsring, i);
+		} else {
+			bsq_put(i);
+		}
+	}
+	if (receive() != BS_ITEMS) {
+		kprintf("spsc: %s reordered or lost words\n", metric);
+	}
+	ticks = (uint32)(getticks() - start);
+	ns = bench_ns(ticks / BS_ITEMS);
+	bench_report("spsc", metric, ns == 0 ? 0 : 1000000000 / ns,
+								"items/s");
+}
+
+/*------------------------------------------------------------------------
+ * bench_spsc - The IP output queue before and after the ring: items per
+ *		second handed from one process to another through an
+ *		8-slot semaphore queue and an 8-slot ring, and ns per
+ *		enqueue+dequeue pair within one process
+ *------------------------------------------------------------------------
+ */
+void	bench_spsc(void)
+{
+	int32	i;			/* Loop index			*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks;			/* Time taken			*/
+	uint32	word;			/* Word removed			*/
+
+	bsq.bqhead = bsq.bqtail = 0;
+	bsq.bqitems = semcreate(0);
+	bsq.bqspace = semcreate(BS_SLOTS);
+	if (bsq.bqitems == SYSERR || bsq.bqspace == SYSERR
+	    || spscinit(&bsring, bsslots, BS_SLOTS) == SYSERR) {
+		kprintf("spsc: cannot create the queues\n");
+		return;
+	}
+
+	start = getticks();
+	for (i = 0; i < BS_ITEMS; i++) {
+		bsq_put(i);
+		bsq_get();
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("spsc", "semqueue_pair", bench_ns(ticks / BS_ITEMS),
+								"ns/pair");
+
+	start = getticks();
+	for (i = 0; i < BS_ITEMS; i++) {
+		spscenq(&bsring, i);
+		spscdeq(&bsring, &word);
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("spsc", "ring_pair", bench_ns(ticks / BS_ITEMS),
+								"ns/pair");
+
+	spsc_run(FALSE, "semqueue");
+	spsc_run(TRUE, "ring");
+
+	semdelete(bsq.bqitems);
+	semdelete(bsq.bqspace);
+	spscdelete(&bsring);
+}
@@ -0,0 +1,106 @@
+/* bench_timer.c - bench_timer */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BT_NTIMERS	4096		/* Timers pending in the wheel	*/
+#define	BT_OPS		10000		/* Set/cancel pairs timed	*/
+#define	BT_FIREMS	20		/* Delay of the batch that fires*/
+#define	BT_SLEEPS	20		/* sleepms(1) calls timed	*/
+#define	BT_IDLEMS	1000		/* Idle time for the irq count	*/
+
+local	struct	timer	bt_timers[BT_NTIMERS];	/* Timers under test	*/
+local	int32	bt_fired;		/* Callbacks run so far		*/
+
+/*------------------------------------------------------------------------
+ * bt_count - Timer function that counts its calls
+ *------------------------------------------------------------------------
+ */
+local	void	bt_count(
+	  int32		arg		/* Unused			*/
+	)
+{
+	bt_fired++;
+}
+
+/*------------------------------------------------------------------------
+ * bt_setcancel - Time arming and cancelling one timer with depth other
+ *		    timers pending at delays spread over every level
+ *------------------------------------------------------------------------
+ */
+local	void	bt_setcancel(
+	  int32		depth,		/* Timers to arm first		*/
+	  char		*tag		/* Metric for set+cancel	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	timer	probe;		/* Timer armed and cancelled	*/
+	int32	i;			/* Loop index			*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks;			/* TSC ticks for the loop	*/
+
+	probe.tslot = NULL;
+	mask = disable();
+	for (i = 0; i < depth; i++) {
+		bt_timers[i].tslot = NULL;
+		tmrset(&bt_timers[i], 1000 + i * 977, bt_count, i);
+	}
+
+	start = getticks();
+	for (i = 0; i < BT_OPS; i++) {
+		tmrset(&probe, 1 + (i & 0xffff) * 61, bt_count, 0);
+		tmrcancel(&probe);
+	}
+	ticks = (uint32)(getticks() - start);
+
+	for (i = 0; i < depth; i++) {
+		tmrcancel(&bt_timers[i]);
+	}
+	restore(mask);
+
+	bench_report("timer", tag, bench_ns(ticks / BT_OPS), "ns/op");
+}
+
+/*------------------------------------------------------------------------
+ * bench_timer - Cost of timer set/cancel with an empty and a crowded
+ *		   wheel, a batch expiry, the delay of sleepms(1) and the
+ *		   clock interrupt rate while idle
+ *------------------------------------------------------------------------
+ */
+void	bench_timer(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	int32	i;			/* Loop index			*/
+	uint64	start;			/* TSC at the start		*/
+	uint32	ticks;			/* TSC ticks for the sleeps	*/
+
+	bt_setcancel(0, "set_cancel_empty");
+	bt_setcancel(BT_NTIMERS, "set_cancel_4096");
+
+	/* A batch of timers that all expire on the same tick */
+
+	bt_fired = 0;
+	mask = disable();
+	for (i = 0; i < BT_NTIMERS; i++) {
+		bt_timers[i].tslot = NULL;
+		tmrset(&bt_timers[i], BT_FIREMS, bt_count, i);
+	}
+	restore(mask);
+	sleepms(2 * BT_FIREMS);
+	bench_report("timer", "batch_fired", bt_fired, "timers");
+
+	start = getticks();
+	for (i = 0; i < BT_SLEEPS; i++) {
+		sleepms(1);
+	}
+	ticks = (uint32)(getticks() - start);
+	bench_report("timer", "sleepms_1", bench_ns(ticks / BT_SLEEPS) / 1000,
+								"us");
+
+	/* Clock interrupts while the system idles (about one per	*/
+	/*   ms, or a handful when booted with "tickless")		*/
+
+	i = clkirqs;
+	sleepms(BT_IDLEMS);
+	bench_report("timer", "idle_clock_irqs", clkirqs - i, "per_s");
+}
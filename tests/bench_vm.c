@@ -0,0 +1,65 @@
+/* bench_vm.c - bench_vmfault */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	VMB_RESIDENT	(nffsframes / 2)	/* Pages that fit in FFS	*/
+#define	VMB_SWAPPED	(nffsframes + nffsframes / 2) /* Pages that	*/
+						/*   force evictions	*/
+
+/*------------------------------------------------------------------------
+ * vmfault_proc - Touch a heap of npages twice and report the cost of
+ *		    the first-touch sweep and of the second sweep
+ *------------------------------------------------------------------------
+ */
+local	void	vmfault_proc(
+	  int32		npages,		/* Pages of heap to touch	*/
+	  char		*firsttag,	/* Metric for the first sweep	*/
+	  char		*secondtag	/* Metric for the second sweep	*/
+	)
+{
+	char	*heap;			/* Virtual heap under test	*/
+	int32	i;			/* Page index			*/
+	uint64	start;			/* TSC at the start of a sweep	*/
+	uint32	first, second;		/* Ticks taken by each sweep	*/
+
+	heap = vmalloc(npages * PAGE_SIZE);
+	if ((int32)heap == SYSERR) {
+		kprintf("vmfault: vmalloc of %d pages failed\n", npages);
+		return;
+	}
+
+	start = getticks();
+	for (i = 0; i < npages; i++) {
+		heap[i * PAGE_SIZE] = (char)i;
+	}
+	first = (uint32)(getticks() - start);
+
+	start = getticks();
+	for (i = 0; i < npages; i++) {
+		heap[i * PAGE_SIZE + 1] = (char)i;
+	}
+	second = (uint32)(getticks() - start);
+
+	bench_report("vmfault", firsttag, bench_ns(first / npages),
+								"ns/page");
+	bench_report("vmfault", secondtag, bench_ns(second / npages),
+								"ns/page");
+}
+
+/*------------------------------------------------------------------------
+ * bench_vmfault - Cost of heap page faults with and without swapping
+ *------------------------------------------------------------------------
+ */
+void	bench_vmfault(void)
+{
+	resume(vcreate(vmfault_proc, BENCHSTK, VMB_RESIDENT, 50,
+			"vmfault1", 3, VMB_RESIDENT, "resident_first",
+			"resident_retouch"));
+	receive();
+
+	resume(vcreate(vmfault_proc, BENCHSTK, VMB_SWAPPED, 50,
+			"vmfault2", 3, VMB_SWAPPED, "swapped_first",
+			"swapped_retouch"));
+	receive();
+}
@@ -0,0 +1,70 @@
+/* bench_workq.c - bench_workq */
+
+#include <xinu.h>
+#include <testsuite.h>
+
+#define	BW_JOBS		2000		/* Jobs run per measurement	*/
+
+local	uint32	bwcount;		/* Jobs that have run		*/
+
+/*------------------------------------------------------------------------
+ * bw_job - The job: count that it ran
+ *------------------------------------------------------------------------
+ */
+local	void	bw_job(
+	  int32		arg		/* Amount to count		*/
+	)
+{
+	bwcount += arg;
+}
+
+/*------------------------------------------------------------------------
+ * bench_workq - Cost of running a small job on another process: a
+ *		 process created for the job (as vmalloc and vfree did)
+ *		 against a job handed to a WQ_HIGH worker and waited for,
+ *		 and the mean delay from wksubmit to the start of a job
+ *------------------------------------------------------------------------
+ */
+void	bench_workq(void)
+{
+	struct	work	job;		/* Job handed to the workers	*/
+	struct	workq	*wqptr = &workqtab[WQ_HIGH];
+	int32	i;			/* Job index			*/
+	uint64	start;			/* TSC at the start		*/
+	uint64	lat0;			/* Queue latency sum at start	*/
+	uint32	starts0;		/* Jobs started at the start	*/
+	uint32	ticks;			/* Time taken			*/
+
+	bwcount = 0;
+	start = getticks();
+	for (i = 0; i < BW_JOBS; i++) {
+		resume(create(bw_job, 1024, getprio(getpid()) + 1, "bwjob",
+								1, 1));
+	}
+	ticks = (uint32)(getticks() - start);
+	if (bwcount != BW_JOBS) {
+		kprintf("workq: %d of %d spawned jobs ran\n", bwcount,
+								BW_JOBS);
+	}
+	bench_report("workq", "spawn", bench_ns(ticks / BW_JOBS), "ns/job");
+
+	bwcount = 0;
+	wkinit(&job, bw_job, 1);
+	lat0 = wqptr->wqlatsum;
+	starts0 = wqptr->wqstarts;
+	start = getticks();
+	for (i = 0; i < BW_JOBS; i++) {
+		wksubmit(&job, WQ_HIGH);
+		wkwait(&job);
+	}
+	ticks = (uint32)(getticks() - start);
+	if (bwcount != BW_JOBS) {
+		kprintf("workq: %d of %d queued jobs ran\n", bwcount,
+								BW_JOBS);
+	}
+	bench_report("workq", "submit_wait", bench_ns(ticks / BW_JOBS),
+								"ns/job");
+	bench_report("workq", "queue_latency",
+		bench_ns((uint32)(wqptr->wqlatsum - lat0)
+				/ (wqptr->wqstarts - starts0)), "ns");
+}
@@ -1,5 +1,7 @@
 
 #include <xinu.h>
+#include <stdlib.h>
+#include <testsuite.h>
 #define PAGE_SIZE 4096
 #define TEST1
 #define TEST2
@@ -9,6 +11,14 @@
 #define TEST6
 #define TEST7
 #define TEST8
+#define TEST9
+#define TEST10
+#define TEST11
+#define TEST12
+#define TEST13
+#define TEST14
+#define TEST15
+#define TEST16
 
 sid32 semTest;
 pid32 mainPid;
@@ -95,11 +105,11 @@ Test1: // An extreme case to exhaust FFS space.
  *
  * */
 void test1_run(void){
-    //By default, FFS is 2048 page, so use 2048 to exhaust FFS area
+    //FFS is nffsframes pages (2048 under make test), so use all of it
     int error;
     init_err_arr();
 
-    pid32 p1 = vcreate(test1, 2000, 2048, 50, "test1", 2, 2048, 0);
+    pid32 p1 = vcreate(test1, 2000, nffsframes, 50, "test1", 2, nffsframes, 0);
     resume(p1);
 
     receive();
@@ -119,7 +129,8 @@ void test2_run(void){
     int error;
     init_err_arr();
 
-    pid32 p1 = vcreate(test1, 2000, MAX_HEAP_SIZE, 50, "test2", 2, 4096, 0);
+    //The largest heap is FFS + swap (4096 pages under make test)
+    pid32 p1 = vcreate(test1, 2000, maxheapframes, 50, "test2", 2, maxheapframes, 0);
     resume(p1);
 
     receive();
@@ -139,10 +150,11 @@ void test3_run(void){
     int error;
     init_err_arr();
 
-    pid32 p1 = vcreate(test1, 2000, 512, 10, "P1", 2, 512, 0);
-    pid32 p2 = vcreate(test1, 2000, 512, 10, "P2", 2, 512, 1);
-    pid32 p3 = vcreate(test1, 2000, 512, 10, "P3", 2, 512, 2);
-    pid32 p4 = vcreate(test1, 2000, 512, 10, "P4", 2, 512, 3);
+    uint32 n = nffsframes / 4;
+    pid32 p1 = vcreate(test1, 2000, n, 10, "P1", 2, n, 0);
+    pid32 p2 = vcreate(test1, 2000, n, 10, "P2", 2, n, 1);
+    pid32 p3 = vcreate(test1, 2000, n, 10, "P3", 2, n, 2);
+    pid32 p4 = vcreate(test1, 2000, n, 10, "P4", 2, n, 3);
     resume(p1);
     resume(p2);
     resume(p3);
@@ -169,10 +181,11 @@ void test4_run(void){
     int error;
     init_err_arr();
 
-    pid32 p1 = vcreate(test1, 2000, 1024, 10, "P1", 2, 1024, 0);
-    pid32 p2 = vcreate(test1, 2000, 1024, 10, "P2", 2, 1024, 1);
-    pid32 p3 = vcreate(test1, 2000, 1024, 10, "P3", 2, 1024, 2);
-    pid32 p4 = vcreate(test1, 2000, 1024, 10, "P4", 2, 1024, 3);
+    uint32 n = maxheapframes / 4;
+    pid32 p1 = vcreate(test1, 2000, n, 10, "P1", 2, n, 0);
+    pid32 p2 = vcreate(test1, 2000, n, 10, "P2", 2, n, 1);
+    pid32 p3 = vcreate(test1, 2000, n, 10, "P3", 2, n, 2);
+    pid32 p4 = vcreate(test1, 2000, n, 10, "P4", 2, n, 3);
     resume(p1);
     resume(p2);
     resume(p3);
@@ -197,12 +210,12 @@ void test4_run(void){
 void test5_run(void){
     int error;
     init_err_arr();
-    pid32 p1 = vcreate(test1, 2000, 2048, 10, "P1", 2, 2048, 0);
+    pid32 p1 = vcreate(test1, 2000, nffsframes, 10, "P1", 2, nffsframes, 0);
     resume(p1);
     // wait for the first process to be finished
     receive();
 
-    pid32 p2 = vcreate(test1, 2000, 2048, 10, "P2", 2, 2048, 0);
+    pid32 p2 = vcreate(test1, 2000, nffsframes, 10, "P2", 2, nffsframes, 0);
     resume(p2);
     // wait for the second process to be finished
     receive();
@@ -215,16 +228,16 @@ void test5_run(void){
     }
 }
 
-/*Test 6: // The same as Test 5, but this time we exhaust Disk Space, so just use 4096 as the heapsize.*/
+/*Test 6: // The same as Test 5, but this time we exhaust Disk Space, so use the largest heap (FFS + swap).*/
 void test6_run(void){
     int error;
     init_err_arr();
-    pid32 p1 = vcreate(test1, 2000, 4096, 10, "P1", 2, 4096, 0);
+    pid32 p1 = vcreate(test1, 2000, maxheapframes, 10, "P1", 2, maxheapframes, 0);
     resume(p1);
     // wait for the first process to be finished
     receive();
 
-    pid32 p2 = vcreate(test1, 2000, 4096, 10, "P2", 2, 4096, 0);
+    pid32 p2 = vcreate(test1, 2000, maxheapframes, 10, "P2", 2, maxheapframes, 0);
     resume(p2);
     // wait for the second process to be finished
     receive();
@@ -239,11 +252,12 @@ void test6_run(void){
 
 //A simple test case that use part FFS
 void test7_run(void){
-    //By default, FFS is 2048 page, so use 1024 
+    //Use half of FFS, and touch 125/128 of that (1000 of 1024 pages under make test)
     int error;
+    uint32 n = nffsframes / 2;
     init_err_arr();
 
-    pid32 p1 = vcreate(test1, 2000, 1024, 50, "test9", 2, 1000, 0);
+    pid32 p1 = vcreate(test1, 2000, n, 50, "test9", 2, n * 125 / 128, 0);
     resume(p1);
 
     receive();
@@ -257,11 +271,13 @@ void test7_run(void){
 
 //A simple test case that use all FFS, but part Disk
 void test8_run(void){
-    //By default, FFS is 2048 page, and Disk is 4096, so use 3072 to exhaust FFS area but give Disk area a relief 
+    //Use all of FFS and half of swap to exhaust FFS area but give Disk area a relief
+    //(3072 pages, of which 3000 are touched, under make test)
     int error;
+    uint32 n = nffsframes + (maxheapframes - nffsframes) / 2;
     init_err_arr();
 
-    pid32 p1 = vcreate(test1, 2000, 3072, 50, "test8", 2, 3000, 0);
+    pid32 p1 = vcreate(test1, 2000, n, 50, "test8", 2, n * 125 / 128, 0);
     resume(p1);
 
     receive();
@@ -273,43 +289,495 @@ void test8_run(void){
     }
 }
 
+void test9_proc(void){
+    sleepms(200);
+}
+
+/*
+ *Test9: // Exhaust the virtual stack region: the OOM killer must pick the
+ *       // lower priority of two equal sized processes and let the third
+ *       // one be created
+ * */
+void test9_run(void){
+    int error = 0;
+    uint32 ssize = (nvstackframes / 2) * PAGE_SIZE;
+    pid32 p1, p2, p3;
+
+    recvclr();
+    p1 = vcreate(test9_proc, ssize, 0, 40, "oom1", 0);
+    p2 = vcreate(test9_proc, ssize, 0, 60, "oom2", 0);
+    p3 = vcreate(test9_proc, ssize, 0, 50, "oom3", 0);
+    if( p1 == SYSERR || p2 == SYSERR || p3 == SYSERR ){
+        error = 1;
+    } else if( receive() != p1 ){
+        error = 1;
+    } else{
+        resume(p2);
+        resume(p3);
+    }
+    sleepms(500);
+    recvclr();
+    if(error){
+        kprintf("\nCase11 FAIL\n");
+    }else{
+        kprintf("\nCase11 PASS\n");
+    }
+}
+
+char test10_order[4];
+int test10_next;
+int test10_boosted;
+int test10_restored;
+
+void test10_high(mid32 mtx){
+    if( mutexlock(mtx) == SYSERR ) return;
+    test10_order[test10_next++] = 'H';
+    mutexunlock(mtx);
+}
+
+void test10_mid(void){
+    test10_order[test10_next++] = 'M';
+}
+
+void test10_low(mid32 mtx, pid32 high, pid32 mid){
+    int i;
+
+    mutexlock(mtx);
+    resume(high);                       // blocks on mtx and boosts us
+    test10_boosted = (getprio(getpid()) == 50);
+    resume(mid);                        // must not run while H waits
+    for(i=0;i<1000000;i++);
+    mutexunlock(mtx);                   // H runs, then M
+    test10_restored = (getprio(getpid()) == 30);
+    send(mainPid, OK);
+}
+
+/*
+ *Test10: // Priority inversion: a low priority mutex holder must inherit
+ *        // the priority of a blocked high priority waiter so a medium
+ *        // priority process cannot run in between
+ * */
+void test10_run(void){
+    int error = 0;
+    mid32 mtx;
+    pid32 high, mid, low;
+
+    recvclr();
+    test10_next = test10_boosted = test10_restored = 0;
+    mtx  = mutexcreate();
+    high = create(test10_high, 1024, 50, "pi_high", 1, mtx);
+    mid  = create(test10_mid, 1024, 40, "pi_mid", 0);
+    low  = create(test10_low, 1024, 30, "pi_low", 3, mtx, high, mid);
+    if( mtx == SYSERR || high == SYSERR || mid == SYSERR || low == SYSERR ){
+        error = 1;
+    } else{
+        resume(low);
+        receive();
+        if( test10_next != 2 || test10_order[0] != 'H' || test10_order[1] != 'M'
+              || !test10_boosted || !test10_restored ){
+            error = 1;
+        }
+    }
+    mutexdelete(mtx);
+    if(error){
+        kprintf("\nCase12 FAIL\n");
+    }else{
+        kprintf("\nCase12 PASS\n");
+    }
+}
+
+int test11_err;
+
+void test11_proc(int base){
+    int i, in, out;
+
+    for(i=0;i<200;i++){
+        in = base + i;
+        asm volatile("fildl %0" : : "m"(in));   // left on the x87 stack
+        yield();                                // the other process too
+        asm volatile("fistpl %0" : "=m"(out));
+        if( out != in ) test11_err = 1;
+    }
+    send(mainPid, OK);
+}
+
+/*
+ *Test11: // Lazy FPU switching: two processes keep a value on the x87
+ *        // stack across every yield to each other and must each get
+ *        // their own value back
+ * */
+void test11_run(void){
+    intmask mask;
+    uint32 saves = fpusaves;
+    pid32 p1, p2;
+
+    if( !fpuenabled ){
+        kprintf("\nCase13 SKIP (no FXSAVE)\n");
+        return;
+    }
+    recvclr();
+    test11_err = 0;
+    p1 = create(test11_proc, 1024, 30, "fpu1", 1, 1000);
+    p2 = create(test11_proc, 1024, 30, "fpu2", 1, 2000);
+    mask = disable();
+    resched_cntl(DEFER_START);
+    resume(p1);
+    resume(p2);
+    resched_cntl(DEFER_STOP);
+    restore(mask);
+    receive();
+    receive();
+    if( test11_err || fpusaves == saves ){
+        kprintf("\nCase13 FAIL\n");
+    }else{
+        kprintf("\nCase13 PASS\n");
+    }
+}
+
+/*
+ *Test12: // Buffer pools: trygetbuf fails on an empty fixed pool instead
+ *        // of blocking, growbufpool adds buffers up to its cap, getbufs
+ *        // stops at the cap and freebufs returns them all
+ * */
+void test12_run(void){
+    int error = 0;
+    bpid32 pool;
+    char *bufs[8];
+    int n;
+
+    pool = mkbufpool(64, 2);
+    if( pool == SYSERR ){
+        kprintf("\nCase14 FAIL\n");
+        return;
+    }
+    bufs[0] = trygetbuf(pool);
+    bufs[1] = trygetbuf(pool);
+    if( (int32)bufs[0] == SYSERR || (int32)bufs[1] == SYSERR
+          || (int32)trygetbuf(pool) != SYSERR ){
+        error = 1;
+    }
+    if( growbufpool(pool, 3, 4) == SYSERR ){
+        error = 1;
+    }
+    n = getbufs(pool, &bufs[2], 6);
+    if( n != 2 || buftab[pool].bpnbufs != 4 || buftab[pool].bpgrows != 1 ){
+        error = 1;
+    }
+    if( buftab[pool].bphigh != 4 || buftab[pool].bplow != 0
+          || buftab[pool].bpfails != 2 ){
+        error = 1;
+    }
+    if( freebufs(bufs, 2 + n) == SYSERR || buftab[pool].bpinuse != 0
+          || semcount(buftab[pool].bpsem) != 4 ){
+        error = 1;
+    }
+    if(error){
+        kprintf("\nCase14 FAIL\n");
+    }else{
+        kprintf("\nCase14 PASS\n");
+    }
+}
+
+/*
+ *Test13: // waitany: polls and timeouts return TIMEOUT, a semaphore
+ *        // signaled by another process wakes the waiter and loses
+ *        // its count, a port message and a process message are seen
+ * */
+void test13_signal(sid32 sem){
+    sleepms(10);
+    signal(sem);
+}
+
+void test13_run(void){
+    int error = 0;
+    struct evwait evs[4];
+    sid32 s1, s2;
+    int32 port;
+
+    s1 = semcreate(0);
+    s2 = semcreate(0);
+    port = ptcreate(2);
+    if( s1 == SYSERR || s2 == SYSERR || port == SYSERR ){
+        kprintf("\nCase15 FAIL\n");
+        return;
+    }
+    evs[0].evtype = EV_SEM;  evs[0].evid = s1;
+    evs[1].evtype = EV_SEM;  evs[1].evid = s2;
+    evs[2].evtype = EV_PORT; evs[2].evid = port;
+    evs[3].evtype = EV_MSG;  evs[3].evid = 0;
+
+    if( waitany(evs, 4, 0) != TIMEOUT || waitany(evs, 4, 20) != TIMEOUT ){
+        error = 1;
+    }
+    resume(create(test13_signal, 1024, 10, "evsig", 1, s2));
+    if( waitany(evs, 4, -1) != 1 || semcount(s2) != 0 ){
+        error = 1;
+    }
+    ptsend(port, 42);
+    if( waitany(evs, 4, 1000) != 2 || ptrecv(port) != 42 ){
+        error = 1;
+    }
+    send(currpid, 7);
+    if( waitany(evs, 4, 1000) != 3 || receive() != 7 ){
+        error = 1;
+    }
+    evs[0].evid = -1;
+    if( waitany(evs, 4, 0) != SYSERR || nevwaiters != 0 ){
+        error = 1;
+    }
+    semdelete(s1);
+    semdelete(s2);
+    ptdelete(port, NULL);
+    if(error){
+        kprintf("\nCase15 FAIL\n");
+    }else{
+        kprintf("\nCase15 PASS\n");
+    }
+}
+
+/*
+ *Test14: // Work queues: a waited-for job has run, a delayed job runs
+ *        // only after its delay, and cancelled jobs (delayed, or queued
+ *        // behind a busy worker) never run
+ * */
+int test14_count = 0;
+
+void test14_job(int32 arg){
+    test14_count += arg;
+}
+
+void test14_run(void){
+    int error = 0;
+    struct work now, later, never, low;
+
+    test14_count = 0;
+    wkinit(&now, test14_job, 1);
+    wkinit(&later, test14_job, 10);
+    wkinit(&never, test14_job, 100);
+    wkinit(&low, test14_job, 1000);
+
+    if( wksubmit(&now, WQ_HIGH) == SYSERR || wkwait(&now) == SYSERR
+          || test14_count != 1 || wkpending(&now) ){
+        error = 1;
+    }
+    wkdelay(&later, WQ_HIGH, 50);
+    wkdelay(&never, WQ_HIGH, 50);
+    // The low worker runs below main, so the job stays queued
+    wksubmit(&low, WQ_LOW);
+    if( wkcancel(&never) == SYSERR || wkcancel(&low) == SYSERR
+          || wkcancel(&now) != SYSERR ){
+        error = 1;
+    }
+    sleepms(20);
+    if( test14_count != 1 || !wkpending(&later) ){
+        error = 1;
+    }
+    sleepms(100);
+    if( test14_count != 11 || wkpending(&later) || wkpending(&never)
+          || wkpending(&low) ){
+        error = 1;
+    }
+    if(error){
+        kprintf("\nCase16 FAIL\n");
+    }else{
+        kprintf("\nCase16 PASS\n");
+    }
+}
+
+/*
+ *Test15: // Coroutines in one process: a yield lets the others run, a
+ *        // semaphore wakes its waiter, and sleeps and a timed receive
+ *        // end in deadline order
+ * */
+char test15_log[8];
+int test15_len = 0;
+sid32 test15_sem;
+
+void test15_co(int32 which){
+    struct evwait ev;
+
+    switch(which){
+       case 'A':
+          cosleep(30);
+          break;
+       case 'B':
+          ev.evtype = EV_SEM;
+          ev.evid   = test15_sem;
+          if( cowait(&ev, -1) != OK ) which = '?';
+          break;
+       case 'C':
+          test15_log[test15_len++] = 'C';
+          signal(test15_sem);
+          coyield();
+          which = 'c';
+          break;
+       case 'D':
+          if( corecvtime(20) != TIMEOUT ) which = '?';
+          break;
+    }
+    test15_log[test15_len++] = (char)which;
+}
+
+void test15_run(void){
+    int error = 0;
+    struct cosched cs;
+    char *c;
+
+    test15_len = 0;
+    test15_sem = semcreate(0);
+    recvclr();
+    if( coinit(&cs, 4, 0) == SYSERR ){
+        kprintf("\nCase17 FAIL\n");
+        return;
+    }
+    for( c = "ABCD"; *c; c++ ){
+        if( cocreate(&cs, test15_co, *c) == SYSERR ){
+            error = 1;
+        }
+    }
+    if( cocreate(&cs, test15_co, 'E') != SYSERR || coyield() != SYSERR ){
+        error = 1;
+    }
+    if( corun(&cs) == SYSERR || test15_len != 5
+          || strncmp(test15_log, "CcBDA", 5) != 0 ){
+        error = 1;
+    }
+    if( semcount(test15_sem) != 0 || codone(&cs) == SYSERR ){
+        error = 1;
+    }
+    semdelete(test15_sem);
+    if(error){
+        kprintf("\nCase17 FAIL\n");
+    }else{
+        kprintf("\nCase17 PASS\n");
+    }
+}
+
+/*
+ *Test16: // Semaphore and process IDs come off free lists: every free
+ *        // semaphore can be taken and given back, and a freed process
+ *        // ID goes to the end of the list instead of being reused
+ * */
+process test16_proc(void){
+    return OK;
+}
+
+void test16_run(void){
+    int error = 0;
+    sid32 *sems;
+    int32 i, n;
+    pid32 first, next;
+
+    sems = (sid32 *)getmem(nsem * sizeof(sid32));
+    if( (int32)sems == SYSERR ){
+        kprintf("\nCase18 FAIL\n");
+        return;
+    }
+    for( n = 0; n < nsem; n++ ){
+        if( (sems[n] = semcreate(0)) == SYSERR ) break;
+    }
+    if( n == 0 || n == nsem || semcreate(0) != SYSERR ){
+        error = 1;
+    }
+    for( i = 0; i < n; i++ ){
+        if( semdelete(sems[i]) == SYSERR ) error = 1;
+    }
+    for( i = 0; i < n; i++ ){
+        if( (sems[i] = semcreate(0)) == SYSERR ) error = 1;
+    }
+    for( i = 0; i < n; i++ ){
+        semdelete(sems[i]);
+    }
+    freemem((char *)sems, nsem * sizeof(sid32));
+
+    first = create(test16_proc, 1024, 10, "test16", 0);
+    kill(first);
+    next = create(test16_proc, 1024, 10, "test16", 0);
+    if( first == SYSERR || next == SYSERR || (next == first && prcount < nproc) ){
+        error = 1;
+    }
+    kill(next);
+
+    if(error){
+        kprintf("\nCase18 FAIL\n");
+    }else{
+        kprintf("\nCase18 PASS\n");
+    }
+}
+
+/*
+ * Boot arguments (see compile/bin/qemu-run):
+ *   test=<n>      run only test case n (default: every TESTn below)
+ *   bench=<name>  run a benchmark from benchtab[] instead of the tests
+ * */
+#define RUNTEST(n, fn) \
+    if( selected == 0 || selected == (n) ){ \
+        kprintf(".........run TEST" #n "......\n"); \
+        fn(); \
+    }
+
 process	main(void)
 {
+    char arg[16];
+    int selected = 0;
+
     mainPid = currpid;
+    if( getbootarg("bench", arg, sizeof(arg)) == OK ){
+        testexit( bench_run(arg) == OK ? 0 : 1 );
+        return OK;
+    }
+    if( getbootarg("test", arg, sizeof(arg)) == OK ){
+        selected = atoi(arg);
+    }
 #ifdef TEST1
-    kprintf(".........run TEST1......\n");
-    test1_run();
+    RUNTEST(1, test1_run);
 #endif
 #ifdef TEST2
-    kprintf(".........run TEST2......\n");
-    test2_run();
+    RUNTEST(2, test2_run);
 #endif
 #ifdef TEST3
-    kprintf(".........run TEST3......\n");
-    test3_run();
+    RUNTEST(3, test3_run);
 #endif
 #ifdef TEST4
-    kprintf(".........run TEST4......\n");
-    test4_run();
+    RUNTEST(4, test4_run);
 #endif
 #ifdef TEST5
-    kprintf(".........run TEST5......\n");
-    test5_run();
+    RUNTEST(5, test5_run);
 #endif
 #ifdef TEST6
-    kprintf(".........run TEST6......\n");
-    test6_run();
+    RUNTEST(6, test6_run);
 #endif
 #ifdef TEST7
-    kprintf(".........run TEST7......\n");
-    test7_run();
+    RUNTEST(7, test7_run);
 #endif
 #ifdef TEST8
-    kprintf(".........run TEST8......\n");
-    test8_run();
+    RUNTEST(8, test8_run);
+#endif
+#ifdef TEST9
+    RUNTEST(9, test9_run);
+#endif
+#ifdef TEST10
+    RUNTEST(10, test10_run);
+#endif
+#ifdef TEST11
+    RUNTEST(11, test11_run);
+#endif
+#ifdef TEST12
+    RUNTEST(12, test12_run);
+#endif
+#ifdef TEST13
+    RUNTEST(13, test13_run);
+#endif
+#ifdef TEST14
+    RUNTEST(14, test14_run);
+#endif
+#ifdef TEST15
+    RUNTEST(15, test15_run);
+#endif
+#ifdef TEST16
+    RUNTEST(16, test16_run);
 #endif
     kprintf("\nAll tests are done!\n");
+    testexit(0);
     return OK;
 }
-
-
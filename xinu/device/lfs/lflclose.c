@@ -15,12 +15,12 @@ devcall	lflclose (
 	/* Obtain exclusive use of the file */
 
 	lfptr = &lfltab[devptr->dvminor];
-	wait(lfptr->lfmutex);
+	mutexlock(lfptr->lfmutex);
 
 	/* If file is not open, return an error */
 
 	if (lfptr->lfstate != LF_USED) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 
@@ -33,6 +33,6 @@ devcall	lflclose (
 	/* Set device state to FREE and return to caller */
 
 	lfptr->lfstate = LF_FREE;
-	signal(lfptr->lfmutex);
+	mutexunlock(lfptr->lfmutex);
 	return OK;
 }
@@ -19,12 +19,12 @@ devcall	lflcontrol (
 	/* Obtain exclusive use of the file */
 
 	lfptr = &lfltab[devptr->dvminor];
-	wait(lfptr->lfmutex);
+	mutexlock(lfptr->lfmutex);
 
 	/* If file is not open, return an error */
 
 	if (lfptr->lfstate != LF_USED) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 
@@ -33,15 +33,15 @@ devcall	lflcontrol (
 	/* Truncate a file */
 
 	case LF_CTL_TRUNC:
-		wait(Lf_data.lf_mutex);
+		mutexlock(Lf_data.lf_mutex);
 		retval = lftruncate(lfptr);
-		signal(Lf_data.lf_mutex);
-		signal(lfptr->lfmutex);
+		mutexunlock(Lf_data.lf_mutex);
+		mutexunlock(lfptr->lfmutex);
 		return retval;	
 
 	default:
 		kprintf("lfcontrol: function %d not valid\n\r", func);
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 }
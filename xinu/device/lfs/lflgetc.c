@@ -18,12 +18,12 @@ devcall	lflgetc (
 	/* Obtain exclusive use of the file */
 
 	lfptr = &lfltab[devptr->dvminor];
-	wait(lfptr->lfmutex);
+	mutexlock(lfptr->lfmutex);
 
 	/* If file is not open, return an error */
 
 	if (lfptr->lfstate != LF_USED) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 
@@ -31,7 +31,7 @@ devcall	lflgetc (
 
 	ldptr = lfptr->lfdirptr;
 	if (lfptr->lfpos >= ldptr->ld_size) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return EOF;
 	}
 
@@ -47,6 +47,6 @@ devcall	lflgetc (
 
 	onebyte = 0xff & *lfptr->lfbyte++;
 	lfptr->lfpos++;
-	signal(lfptr->lfmutex);
+	mutexunlock(lfptr->lfmutex);
 	return onebyte;
 }
@@ -21,7 +21,7 @@ devcall	lflinit (
 
 	lfptr->lfstate = LF_FREE;	/* Device is currently unused	*/
 	lfptr->lfdev = devptr->dvnum;	/* Set device ID		*/
-	lfptr->lfmutex = semcreate(1);	/* Create the mutex semaphore	*/
+	lfptr->lfmutex = mutexcreate();	/* Create the file mutex		*/
 
 	/* Initialize the directory and file position */
 
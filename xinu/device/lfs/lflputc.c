@@ -18,12 +18,12 @@ devcall	lflputc (
 	/* Obtain exclusive use of the file */
 
 	lfptr = &lfltab[devptr->dvminor];
-	wait(lfptr->lfmutex);
+	mutexlock(lfptr->lfmutex);
 
 	/* If file is not open, return an error */
 
 	if (lfptr->lfstate != LF_USED) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 
@@ -32,7 +32,7 @@ devcall	lflputc (
 
 	ldptr = lfptr->lfdirptr;
 	if (lfptr->lfpos > ldptr->ld_size) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 
@@ -59,6 +59,6 @@ devcall	lflputc (
 	lfptr->lfpos++;
 	lfptr->lfdbdirty = TRUE;
 
-	signal(lfptr->lfmutex);
+	mutexunlock(lfptr->lfmutex);
 	return OK;
 }
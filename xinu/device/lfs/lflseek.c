@@ -16,16 +16,16 @@ devcall	lflseek (
 	/* If file is not open, return an error */
 
 	lfptr = &lfltab[devptr->dvminor];
-	wait(lfptr->lfmutex);
+	mutexlock(lfptr->lfmutex);
 	if (lfptr->lfstate != LF_USED) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 
 	/* Verify offset is within current file size */
 
 	if (offset > lfptr->lfdirptr->ld_size) {
-		signal(lfptr->lfmutex);
+		mutexunlock(lfptr->lfmutex);
 		return SYSERR;
 	}
 
@@ -36,6 +36,6 @@ devcall	lflseek (
 	lfptr->lfpos = offset;
 	lfptr->lfbyte = &lfptr->lfdblock[LF_BLKSIZ];
 
-	signal(lfptr->lfmutex);
+	mutexunlock(lfptr->lfmutex);
 	return OK;
 }
@@ -23,7 +23,7 @@ status	lfsetup (
 
 	/* Obtain exclusive access to the directory */
 
-	wait(Lf_data.lf_mutex);
+	mutexlock(Lf_data.lf_mutex);
 
 	/* Get pointers to in-memory directory, file's entry in the	*/
 	/*	directory, and the in-memory index block		*/
@@ -117,6 +117,6 @@ status	lfsetup (
 	/*   within the data block					*/
 
 	lfptr->lfbyte = &lfptr->lfdblock[lfptr->lfpos & LF_DMASK];
-	signal(Lf_data.lf_mutex);
+	mutexunlock(Lf_data.lf_mutex);
 	return OK;
 }
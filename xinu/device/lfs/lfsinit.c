@@ -18,7 +18,7 @@ devcall	lfsinit (
 
 	/* Create a mutual exclusion semaphore */
 
-	Lf_data.lf_mutex = semcreate(1);
+	Lf_data.lf_mutex = mutexcreate();
 
 	/* Zero directory area (for debugging) */
 
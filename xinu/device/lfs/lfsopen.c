@@ -80,16 +80,16 @@ devcall	lfsopen (
 	/* Obtain copy of directory if not already present in memory	*/
 
 	dirptr = &Lf_data.lf_dir;
-	wait(Lf_data.lf_mutex);
+	mutexlock(Lf_data.lf_mutex);
 	if (! Lf_data.lf_dirpresent) {
 	    retval = read(Lf_data.lf_dskdev,(char *)dirptr,LF_AREA_DIR);
 	    if (retval == SYSERR ) {
-		signal(Lf_data.lf_mutex);
+		mutexunlock(Lf_data.lf_mutex);
 		return SYSERR;
 	    }
 	    if (lfscheck(dirptr) == SYSERR ) {
 		kprintf("Disk does not contain a Xinu file system\n");
-		signal(Lf_data.lf_mutex);
+		mutexunlock(Lf_data.lf_mutex);
 		return SYSERR;
 	    }
 	    Lf_data.lf_dirpresent = TRUE;
@@ -119,7 +119,7 @@ devcall	lfsopen (
 
 	if (! found) {
 		if (mbits & LF_MODE_O) {	/* File *must* exist	*/
-			signal(Lf_data.lf_mutex);
+			mutexunlock(Lf_data.lf_mutex);
 			return SYSERR;
 		}
 
@@ -128,7 +128,7 @@ devcall	lfsopen (
 		/* Verify that space remains in the directory */
 
 		if (dirptr->lfd_nfiles >= LF_NUM_DIR_ENT) {
-			signal(Lf_data.lf_mutex);
+			mutexunlock(Lf_data.lf_mutex);
 			return SYSERR;
 		}
 
@@ -146,7 +146,7 @@ devcall	lfsopen (
 	/* Case #2 - file is in directory (i.e., already exists)	*/
 
 	} else if (mbits & LF_MODE_N) {		/* File must not exist	*/
-			signal(Lf_data.lf_mutex);
+			mutexunlock(Lf_data.lf_mutex);
 			return SYSERR;
 	}
 
@@ -179,7 +179,7 @@ devcall	lfsopen (
 	lfptr->lfibdirty = FALSE;
 	lfptr->lfdbdirty = FALSE;
 
-	signal(Lf_data.lf_mutex);
+	mutexunlock(Lf_data.lf_mutex);
 
 	return lfptr->lfdev;
 }
@@ -14,19 +14,19 @@ devcall	rflclose (
 
 	/* Wait for exclusive access */
 
-	wait(Rf_data.rf_mutex);
+	mutexlock(Rf_data.rf_mutex);
 
 	/* Verify remote file device is open */
 
 	rfptr = &rfltab[devptr->dvminor];
 	if (rfptr->rfstate == RF_FREE) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
 	/* Mark device closed */
 
 	rfptr->rfstate = RF_FREE;
-	signal(Rf_data.rf_mutex);
+	mutexunlock(Rf_data.rf_mutex);
 	return OK;
 }
@@ -22,12 +22,12 @@ devcall	rflread (
 
 	/* Wait for exclusive access */
 
-	wait(Rf_data.rf_mutex);
+	mutexlock(Rf_data.rf_mutex);
 
 	/* Verify count is legitimate */
 
 	if ( (count <= 0) || (count > RF_DATALEN) ) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -38,14 +38,14 @@ devcall	rflread (
 	/* If device not currently in use, report an error */
 
 	if (rfptr->rfstate == RF_FREE) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
 	/* Verify pseudo-device allows reading */
 
 	if ((rfptr->rfmode & RF_MODE_R) == 0) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -60,7 +60,7 @@ devcall	rflread (
 	len = 0;
 	while ( (*to++ = *from++) ) {	/* Copy name to request		*/
 		if (++len >= RF_NAMLEN) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 	}
@@ -77,14 +77,14 @@ devcall	rflread (
 	/* Check response */
 
 	if (retval == SYSERR) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	} else if (retval == TIMEOUT) {
 		kprintf("Timeout during remote file read\n");
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	} else if (ntohs(resp.rf_status) != 0) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -95,6 +95,6 @@ devcall	rflread (
 	}
 	rfptr->rfpos += ntohl(resp.rf_len);
 
-	signal(Rf_data.rf_mutex);
+	mutexunlock(Rf_data.rf_mutex);
 	return ntohl(resp.rf_len);
 }
@@ -15,19 +15,19 @@ devcall	rflseek (
 
 	/* Wait for exclusive access */
 
-	wait(Rf_data.rf_mutex);
+	mutexlock(Rf_data.rf_mutex);
 
 	/* Verify remote file device is open */
 
 	rfptr = &rfltab[devptr->dvminor];
 	if (rfptr->rfstate == RF_FREE) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
 	/* Set the new position */
 
 	rfptr->rfpos = pos;
-	signal(Rf_data.rf_mutex);
+	mutexunlock(Rf_data.rf_mutex);
 	return OK;
 }
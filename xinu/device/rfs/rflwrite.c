@@ -22,12 +22,12 @@ devcall	rflwrite (
 
 	/* Wait for exclusive access */
 
-	wait(Rf_data.rf_mutex);
+	mutexlock(Rf_data.rf_mutex);
 
 	/* Verify count is legitimate */
 
 	if ( (count <= 0) || (count > RF_DATALEN) ) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -36,7 +36,7 @@ devcall	rflwrite (
 	rfptr = &rfltab[devptr->dvminor];
 	if ( (rfptr->rfstate == RF_FREE) ||
 	     ! (rfptr->rfmode & RF_MODE_W) ) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -51,7 +51,7 @@ devcall	rflwrite (
 	len = 0;
 	while ( (*to++ = *from++) ) {	/* Copy name to request		*/
 		if (++len >= RF_NAMLEN) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 	}
@@ -77,14 +77,14 @@ devcall	rflwrite (
 	/* Check response */
 
 	if (retval == SYSERR) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	} else if (retval == TIMEOUT) {
 		kprintf("Timeout during remote file read\n");
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	} else if (ntohs(resp.rf_status) != 0) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -92,6 +92,6 @@ devcall	rflwrite (
 
 	rfptr->rfpos += ntohl(resp.rf_len);
 
-	signal(Rf_data.rf_mutex);
+	mutexunlock(Rf_data.rf_mutex);
 	return ntohl(resp.rf_len);
 }
@@ -21,7 +21,7 @@ devcall	rfscontrol (
 
 	/* Wait for exclusive access */
 
-	wait(Rf_data.rf_mutex);
+	mutexlock(Rf_data.rf_mutex);
 
 	/* Check length of name (copy during the check even though the	*/
 	/*	copy is only used for a size request)			*/
@@ -33,7 +33,7 @@ devcall	rfscontrol (
 	while ( (*to++ = *from++) ) {	/* Copy name to message		*/
 		len++;
 		if (len >= (RF_NAMLEN - 1) ) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 	}
@@ -44,7 +44,7 @@ devcall	rfscontrol (
 
 	case RFS_CTL_DEL:
 		if (rfsndmsg(RF_MSG_DREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 		break;
@@ -53,7 +53,7 @@ devcall	rfscontrol (
 
 	case RFS_CTL_TRUNC:
 		if (rfsndmsg(RF_MSG_TREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 		break;
@@ -64,7 +64,7 @@ devcall	rfscontrol (
 
 	case RFS_CTL_MKDIR:
 		if (rfsndmsg(RF_MSG_MREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 		break;
@@ -73,7 +73,7 @@ devcall	rfscontrol (
 
 	case RFS_CTL_RMDIR:
 		if (rfsndmsg(RF_MSG_XREQ, (char *)arg1) == SYSERR) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 		break;
@@ -96,19 +96,19 @@ devcall	rfscontrol (
 				  (struct rf_msg_hdr *)&resp,
 					sizeof(struct rf_msg_sres) );
 		if ( (retval == SYSERR) || (retval == TIMEOUT) ) {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		} else {
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return ntohl(resp.rf_size);
 		}
 
 	default:
 		kprintf("rfscontrol: function %d not valid\n", func);
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
-	signal(Rf_data.rf_mutex);
+	mutexunlock(Rf_data.rf_mutex);
 	return OK;
 }
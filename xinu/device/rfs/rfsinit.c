@@ -27,7 +27,7 @@ devcall	rfsinit(
 
 	/* Create a mutual exclusion semaphore */
 
-	if ( (Rf_data.rf_mutex = semcreate(1)) == SYSERR ) {
+	if ( (Rf_data.rf_mutex = mutexcreate()) == SYSERR ) {
 		panic("Cannot create remote file system semaphore");
 	}
 
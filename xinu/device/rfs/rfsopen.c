@@ -24,7 +24,7 @@ devcall	rfsopen (
 
 	/* Wait for exclusive access */
 
-	wait(Rf_data.rf_mutex);
+	mutexlock(Rf_data.rf_mutex);
 
 	/* Search control block array to find a free entry */
 
@@ -35,7 +35,7 @@ devcall	rfsopen (
 		}
 	}
 	if (i >= Nrfl) {		/* No free table slots remain	*/
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -47,7 +47,7 @@ devcall	rfsopen (
 	while ( (*fptr++ = *nptr++) != NULLCH) {
 		len++;
 		if (len >= RF_NAMLEN) {	/* File name is too long	*/
-			signal(Rf_data.rf_mutex);
+			mutexunlock(Rf_data.rf_mutex);
 			return SYSERR;
 		}
 	}
@@ -55,14 +55,14 @@ devcall	rfsopen (
 	/* Verify that name is non-null */
 
 	if (len==0) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
 	/* Parse mode string */
 
 	if ( (rfptr->rfmode = rfsgetmode(mode)) == SYSERR ) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -88,14 +88,14 @@ devcall	rfsopen (
 	/* Check response */
 
 	if (retval == SYSERR) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	} else if (retval == TIMEOUT) {
 		kprintf("Timeout during remote file open\n\r");
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	} else if (ntohs(resp.rf_status) != 0) {
-		signal(Rf_data.rf_mutex);
+		mutexunlock(Rf_data.rf_mutex);
 		return SYSERR;
 	}
 
@@ -109,6 +109,6 @@ devcall	rfsopen (
 
 	/* Return device descriptor of newly created pseudo-device */
 
-	signal(Rf_data.rf_mutex);
+	mutexunlock(Rf_data.rf_mutex);
 	return rfptr->rfdev;
 }
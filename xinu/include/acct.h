@@ -0,0 +1,16 @@
+/* acct.h - CPU time accounting definitions				*/
+
+/* Processes are charged TSC ticks in resched() when they are switched	*/
+/*   out, less the ticks interrupt handlers took meanwhile; those go	*/
+/*   to a per-handler bucket instead.  A handler that reschedules is	*/
+/*   charged up to the switch and the rest of it goes to the process.	*/
+
+#define	ACCT_CLK	0	/* Clock interrupts			*/
+#define	ACCT_ETH	1	/* Ethernet interrupts			*/
+#define	ACCT_TTY	2	/* Serial console interrupts		*/
+#define	NACCTINTR	3	/* Number of interrupt buckets		*/
+
+extern	uint64	acctintr[];	/* TSC ticks spent in each handler	*/
+extern	char	*acctintrname[]; /* Name of each bucket			*/
+extern	uint64	acctlast;	/* TSC at the last context switch	*/
+extern	uint64	acctinswitch;	/* Interrupt ticks since acctlast	*/
@@ -0,0 +1,47 @@
+/* buddy.h - heapget, heapfree, heapstat				*/
+
+/* The heap behind the slab caches and large getmem()/getstk() calls	*/
+/*   is either the first-fit free list (memlist) or, with BUDDYHEAP	*/
+/*   defined below, a binary buddy allocator.  Buddy blocks are	*/
+/*   aligned to their own size in physical addresses, so the buddy of	*/
+/*   a block of order k at a is a ^ (1 << k) and splitting or merging	*/
+/*   touches one block per order.  A request is served from the	*/
+/*   smallest block that holds it and the tail past the request goes	*/
+/*   straight back, so blocks can be freed in any pieces.		*/
+
+/* #define BUDDYHEAP */
+
+#define	BUDDYMINORD	4		/* Smallest block: 16 bytes	*/
+#define	BUDDYMAXORD	22		/* Largest block: 4 Mbytes	*/
+#define	NBUDDYORD	(BUDDYMAXORD - BUDDYMINORD + 1)
+
+#define	roundbuddy(x)	(((uint32)(x) + (1 << BUDDYMINORD) - 1)	\
+				& ~((1 << BUDDYMINORD) - 1))
+
+struct	buddyblk	{		/* Header of a free buddy block	*/
+	struct	buddyblk *bnext;	/* Next free block of the order	*/
+	struct	buddyblk *bprev;	/* Previous free block		*/
+	uint32	border;			/* Order of this block		*/
+};
+
+struct	buddyord	{		/* Free blocks of one order	*/
+	struct	buddyblk *bofree;	/* Doubly-linked list of them	*/
+	uint32	bocount;		/* Blocks on the list		*/
+};
+
+extern	struct	buddyord buddytab[];	/* Indexed by order - MINORD	*/
+extern	uint32	buddyavail;		/* Free bytes in the buddy heap	*/
+extern	uint32	buddysplits;		/* Blocks split			*/
+extern	uint32	buddymerges;		/* Buddies merged		*/
+
+#ifdef	BUDDYHEAP
+#define	heapget(n)	buddyget(n)
+#define	heapfree(p,n)	buddyfree((p), (n))
+#define	heapstat(f,n,l)	buddystat((f), (n), (l))
+#define	HEAPNAME	"buddy"
+#else
+#define	heapget(n)	memlistget(n)
+#define	heapfree(p,n)	memlistfree((p), (n))
+#define	heapstat(f,n,l)	memliststat((f), (n), (l))
+#define	HEAPNAME	"list"
+#endif
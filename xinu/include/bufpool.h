@@ -13,11 +13,27 @@
 #define	BP_MAXN	2048		/* Maximum number of buffers in a pool	*/
 #endif
 
+/* A pool is created with a fixed number of buffers.  growbufpool()	*/
+/*   lets it add buffers from the heap, step at a time, up to a cap	*/
+/*   when a request finds it empty; grown buffers stay in the pool.	*/
+/*   trygetbuf() and getbufs() never block and can be used from	*/
+/*   interrupt handlers and from netin.					*/
+
 struct	bpentry	{		/* Description of a single buffer pool	*/
 	struct	bpentry *bpnext;/* pointer to next free buffer		*/
 	sid32	bpsem;		/* semaphore that counts buffers	*/
 				/*    currently available in the pool	*/
 	uint32	bpsize;		/* size of buffers in this pool		*/
+	int32	bpnbufs;	/* buffers the pool owns		*/
+	int32	bpmaxbufs;	/* cap on growth (bpnbufs if fixed)	*/
+	int32	bpstep;		/* buffers added per growth		*/
+	int32	bpinuse;	/* buffers handed out			*/
+	int32	bphigh;		/* high-water mark of bpinuse		*/
+	int32	bplow;		/* low-water mark of free buffers	*/
+	uint32	bpallocs;	/* buffers handed out in total		*/
+	uint32	bpfails;	/* requests that found no buffer	*/
+	uint32	bpwaits;	/* getbuf calls that had to block	*/
+	uint32	bpgrows;	/* times the pool grew			*/
 	};
 
 extern	struct	bpentry buftab[];/* Buffer pool table			*/
@@ -8,8 +8,25 @@
 
 
 #define CLKTICKS_PER_SEC  1000	/* clock timer resolution		*/
+#define	CLKINTV		1193	/* PIT counts per ms (1.193 MHz input)	*/
+#define	CLKIDLEMAX	50	/* Longest one-shot when idle, in ms;	*/
+				/*   must keep the count below 65536	*/
+
+#define	CLK_PERIODIC	0x34	/* Timer 0, lo/hi byte, rate generator	*/
+#define	CLK_ONESHOT	0x30	/* Timer 0, lo/hi byte, interrupt on	*/
+				/*   terminal count			*/
+#define	CLK_READBACK	0xC2	/* Latch status and count of timer 0	*/
+#define	CLK_OUTHIGH	0x80	/* Status: output high (count reached 0)*/
+#define	CLKWAKEIO	6	/* PIT counts that pass between latching	*/
+				/*   the one-shot and restarting the tick	*/
+				/*   (five I/O operations of about 1 us)	*/
 
 extern	uint32	clktime;	/* current time in secs since boot	*/
+extern	uint32	ctr1000;	/* current time in ms since boot	*/
+extern	uint32	clksecond;	/* value of ctr1000 when clktime last	*/
+				/*   advanced				*/
+extern	bool8	clktickless;	/* stop the tick while idle?		*/
+extern	bool8	clkstopped;	/* is a one-shot replacing the tick?	*/
+extern	uint32	clkirqs;	/* clock interrupts taken since boot	*/
 
-extern	qid16	sleepq;		/* queue for sleeping processes		*/
 extern	uint32	preempt;	/* preemption counter			*/
@@ -0,0 +1,64 @@
+/* coro.h - coroutine definitions */
+
+/* Coroutines multiplex many logical tasks on one Xinu process.  Each	*/
+/*   has a small stack from the slab caches (getmem), and they switch	*/
+/*   only when one yields, sleeps or waits, by saving four registers	*/
+/*   and the stack pointer (coswitch).  corun is the scheduler: it	*/
+/*   runs the ready coroutines in turn and, when none is ready, blocks	*/
+/*   the process in waitany on the events the coroutines wait for.	*/
+/*   Coroutine code must not block the process itself; it uses		*/
+/*   cowait, corecvtime and coudprecv, which park only the coroutine.	*/
+
+#define	COSTK		4096		/* Default coroutine stack size	*/
+#define	COMINSTK	1024		/* Smallest stack accepted	*/
+
+#define	EV_NONE		(-1)		/* coev.evtype: only sleeping	*/
+
+/* Coroutine states */
+
+#define	CO_FREE		0		/* Entry is unused		*/
+#define	CO_READY	1		/* On the ready list		*/
+#define	CO_CURR		2		/* Running			*/
+#define	CO_WAIT		3		/* Waiting for coev or codue	*/
+#define	CO_DEAD		4		/* Returned; stack not freed	*/
+
+struct	coro	{			/* Entry in a coroutine table	*/
+	uint32	*cosp;			/* Saved stack pointer		*/
+	char	*costk;			/* Stack buffer from the pool	*/
+	int32	costate;		/* CO_FREE, CO_READY, ...	*/
+	struct	coro	*conext;	/* Next on the ready, wait or	*/
+					/*   free list			*/
+	void	(*cofunc)(int32);	/* Function the coroutine runs	*/
+	int32	coarg;			/* Argument passed to cofunc	*/
+	struct	evwait	coev;		/* Event waited for, or EV_NONE	*/
+	bool8	cotimed;		/* Is codue set?		*/
+	uint32	codue;			/* ctr1000 at which to time out	*/
+	int32	coresult;		/* OK or TIMEOUT for cowait	*/
+};
+
+struct	cosched	{			/* Coroutines of one process	*/
+	struct	coro	*cotab;		/* Table of comax coroutines	*/
+	int32	comax;			/* Size of the table		*/
+	uint32	costklen;		/* Stack size of each coroutine	*/
+	struct	coro	*coready;	/* Ready list, run in order	*/
+	struct	coro	*coreadytail;	/* Last ready coroutine		*/
+	struct	coro	*cowaiting;	/* Coroutines in CO_WAIT	*/
+	struct	coro	*cofree;	/* Unused table entries		*/
+	struct	coro	*cocurr;	/* Coroutine running now	*/
+	uint32	*cosp;			/* Saved SP of corun		*/
+	int32	colive;			/* Coroutines not yet returned	*/
+	uint32	coswitches;		/* Switches into coroutines	*/
+	uint32	coblocks;		/* Times corun blocked		*/
+};
+
+/* The scheduler may sit on a private stack; corun copies what kill	*/
+/*   needs to free into kernel memory, so another process can do it	*/
+
+struct	coown	{			/* Storage held inside corun	*/
+	struct	coro	*cotab;		/* Table from coinit		*/
+	int32	comax;			/* Size of the table		*/
+	uint32	costklen;		/* Stack size of each coroutine	*/
+};
+
+extern	struct	cosched	**cosched;	/* Scheduler of each process	*/
+extern	struct	coown	*coown;		/* Its storage, per process	*/
@@ -0,0 +1,22 @@
+/* event.h - event definitions for waitany */
+
+/* waitany blocks a process until any one of a set of events is ready	*/
+/*   or a timeout expires.  The sources (signal, signaln, send and	*/
+/*   udp_in) only call evnotify when nevwaiters is nonzero, so the	*/
+/*   cost to a system where no process multiplexes is one load, and	*/
+/*   evnotify walks only the list of processes inside waitany.		*/
+
+#define	EV_SEM		0	/* Semaphore count is positive; waitany	*/
+				/*   takes one count as wait would	*/
+#define	EV_PORT		1	/* Port holds a message for ptrecv	*/
+#define	EV_UDP		2	/* UDP slot has a datagram queued	*/
+#define	EV_MSG		3	/* Caller has a message (evid unused)	*/
+
+#define	EV_MAX		16	/* Events one waitany call may name	*/
+
+struct	evwait	{			/* One event of a waitany set	*/
+	int32	evtype;			/* EV_SEM, EV_PORT, ...		*/
+	int32	evid;			/* Semaphore, port or UDP slot	*/
+};
+
+extern	int32	nevwaiters;		/* Processes inside waitany	*/
@@ -0,0 +1,21 @@
+/* fpu.h - lazy x87/SSE state switching definitions			*/
+
+/* The x87/SSE registers belong to fpuowner until another process uses	*/
+/*   them.  resched() sets CR0.TS whenever it switches to a process	*/
+/*   that is not the owner, so that process's first FPU or SSE		*/
+/*   instruction raises the device-not-available trap (7); fpuhandler	*/
+/*   then saves the owner's state with FXSAVE, loads the new process's	*/
+/*   (or a clean state the first time) and makes it the owner.		*/
+/*   Integer-only processes never pay for a save or a restore.		*/
+
+#define	IRQFPU		7	/* Device-not-available trap		*/
+#define	FXSAVESIZE	512	/* Bytes in an FXSAVE area (procent)	*/
+#define	FPU_NONE	(-1)	/* Registers belong to nobody		*/
+#define	MXCSR_DEFAULT	0x1f80	/* SSE exceptions masked		*/
+#define	CR0_TS		0x00000008 /* Task switched: trap FPU use	*/
+#define	CR0_NE		0x00000020 /* Native x87 error reporting	*/
+
+extern	bool8	fpuenabled;	/* Can processes use x87/SSE?		*/
+extern	pid32	fpuowner;	/* Whose state the registers hold	*/
+extern	uint32	fpusaves;	/* FXSAVEs done by the trap handler	*/
+extern	uint32	fpurestores;	/* FXRSTORs done by the trap handler	*/
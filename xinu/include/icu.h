@@ -7,3 +7,5 @@
 #define	IMR	(ICU1+1)	/* Interrupt Mask Register		*/
 
 #define	EOI	0x20		/* non-specific end of interrupt	*/
+#define	READIRR	0x0A		/* OCW3: next read of OCR gives the IRR	*/
+#define	IRQCLK	0x01		/* IRR bit of the clock (IRQ 0)		*/
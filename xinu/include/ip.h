@@ -11,15 +11,18 @@
 #define	IP_HDR_LEN	20		/* Bytes in an IP header	*/
 #define IP_VH		0x45 		/* IP version and hdr length 	*/
 
-#define	IP_OQSIZ	8		/* Size of IP output queue	*/
+#define	IP_OQSIZ	8		/* Size of IP output queue (a	*/
+					/*   power of two)		*/
 
-/* Queue of outgoing IP packets waiting for ipout process */
+/* Queue of outgoing IP packets waiting for ipout process.  Echo	*/
+/*   replies are enqueued by icmp_in, in netin for packets from the	*/
+/*   network and in any sending process for loopback (ip_local), so	*/
+/*   ip_enqueue disables interrupts to keep a single producer at a	*/
+/*   time; ipout is the single consumer				*/
 
 struct	iqentry	{
-	int32	iqhead;			/* Index of next packet to send	*/
-	int32	iqtail;			/* Index of next free slot	*/
-	sid32	iqsem;			/* Semaphore that counts pkts	*/
-	struct	netpacket *iqbuf[IP_OQSIZ];/* Circular packet queue	*/
+	struct	spsc	iqring;		/* Ring of packet pointers	*/
+	uint32	iqslots[IP_OQSIZ];	/* Storage for the ring		*/
 };
 
 extern	struct	iqentry	ipoqueue;	/* Network output queue		*/
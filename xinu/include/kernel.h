@@ -13,6 +13,7 @@ typedef	unsigned long long uint64;
 /* Xinu-specific types */
 
 typedef	int32	sid32;		/* semaphore ID				*/
+typedef	int32	mid32;		/* mutex ID				*/
 typedef	int16	qid16;		/* queue ID				*/
 typedef	int32	pid32;		/* process ID				*/
 typedef	int32	did32;		/* device ID				*/
@@ -54,7 +55,7 @@ typedef	int32	status;		/* returned status value (OK/SYSERR)	*/
 #define	EOF	(-2)		/* End-of-file (usually from read)	*/
 #define	TIMEOUT	(-3)		/* system call timed out		*/
 
-extern	qid16	readylist;	/* global ID for list of ready processes*/
+/* The ready list is kept by readyq.c (see queue.h)			*/
 
 #define	MINSTK	400		/* minimum stack size in bytes		*/
 
@@ -129,7 +129,7 @@ struct	lfdir	{			/* Entire directory on disk	*/
 
 struct	lfdata	{			/* Local file system data	*/
 	did32	lf_dskdev;		/* Device ID of disk to use	*/
-	sid32	lf_mutex;		/* Mutex for the directory and	*/
+	mid32	lf_mutex;		/* Mutex for the directory and	*/
 					/*   index/data free lists	*/
 	struct	lfdir	lf_dir;		/* In-memory copy of directory	*/
 	bool8	lf_dirpresent;		/* True when directory is in	*/
@@ -143,7 +143,7 @@ struct	lflcblk	{			/* Local file control block	*/
 					/*   (one for each open file)	*/
 	byte	lfstate;		/* Is entry free or used	*/
 	did32	lfdev;			/* Device ID of this device	*/
-	sid32	lfmutex;		/* Mutex for this file		*/
+	mid32	lfmutex;		/* Mutex for this file		*/
 	struct	ldentry	*lfdirptr;	/* Ptr to file's entry in the	*/
 					/*   in-memory directory	*/
 	int32	lfmode;			/* Mode (read/write/both)	*/
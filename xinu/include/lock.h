@@ -0,0 +1,37 @@
+/* lock.h - lock and reader-writer lock definitions			*/
+
+/* Locks whose uncontended acquire and release is one locked compare-	*/
+/*   and-exchange on the lock word (system/lockfast.S).  Only when the word	*/
+/*   shows a holder or waiters does a process disable interrupts and go	*/
+/*   through the wait queue (system/lock.c, system/rwlock.c).  Unlike	*/
+/*   mutexes (mutex.h) they record no owner and lend no priority, and	*/
+/*   a waiter is handed the lock directly when it is released.		*/
+
+#ifndef	NLOCK
+#define	NLOCK		32	/* Wait queues for locks and rwlocks	*/
+#endif
+
+/* Lock word values; system/lockfast.S uses the same constants		*/
+
+#define	LK_FREE		0	/* Nobody holds the lock		*/
+#define	LK_HELD		1	/* Held, nobody waits			*/
+#define	LK_WAITERS	2	/* Held, processes on the wait queue	*/
+
+#define	RW_WRITER	0x40000000 /* A writer holds the rwlock		*/
+#define	RW_WAITERS	0x80000000 /* Processes on the wait queue	*/
+#define	RW_READERS	0x3fffffff /* Mask for the count of readers	*/
+
+/* Key of a process on a rwlock wait queue				*/
+
+#define	RW_READ		0	/* Waiting to read			*/
+#define	RW_WRITE	1	/* Waiting to write			*/
+
+struct	lock	{
+	int32	lstate;		/* Lock word (must come first)		*/
+	qid16	lqueue;		/* Processes waiting, in FIFO order	*/
+};
+
+struct	rwlock	{
+	int32	rwstate;	/* Lock word (must come first)		*/
+	qid16	rwqueue;	/* Processes waiting, in FIFO order	*/
+};
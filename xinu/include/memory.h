@@ -1,4 +1,4 @@
-/* memory.h - roundmb, truncmb, freestk */
+/* memory.h - roundmb, truncmb */
 
 #define	PAGE_SIZE	4096
 #define	HOLESTART	((char *)(640 * 1024))
@@ -12,14 +12,7 @@
 #define	roundmb(x)	(char *)( (7 + (uint32)(x)) & (~7) )
 #define	truncmb(x)	(char *)( ((uint32)(x)) & (~7) )
 
-/*----------------------------------------------------------------------
- *  freestk  --  Free stack memory allocated by getstk
- *----------------------------------------------------------------------
- */
-#define	freestk(p,len)	freemem((char *)((uint32)(p)		\
-				- ((uint32)roundmb(len))	\
-				+ (uint32)sizeof(uint32)),	\
-				(uint32)roundmb(len) )
+#define	NSTKCACHE	8		/* Freed stacks kept by freestk	*/
 
 struct	memblk	{			/* See roundmb & truncmb	*/
 	struct	memblk	*mnext;		/* Ptr to next free memory blk	*/
@@ -31,6 +24,9 @@ extern	struct	memblk	ffslist;	/* Head of ffs list	*/
 extern	struct	memblk	swaplist;	/* Head of swap list	*/
 extern	struct	memblk	vstacklist;	/* Head of virtual stack list	*/
 
+extern	uint32	nstkcache;		/* Stacks held by freestk	*/
+extern	uint32	stkcachehits;		/* getstk calls it served	*/
+
 extern	void	*minheap;		/* Start of heap		*/
 extern	void	*maxheap;		/* Highest valid heap address	*/
 extern	void	*maxpdpt;
@@ -57,3 +57,12 @@ struct mbmregion {
 
 /* Usable memory region 		*/
 #define	MULTIBOOT_MMAP_TYPE_USABLE	0x00000001
+
+/* Copy of the boot information kept by bootinfo.c	*/
+
+#define	BOOTCMDLEN	256		/* Bytes kept from the command line	*/
+
+extern	uint32	bootmagic;		/* Signature passed by the loader	*/
+extern	uint32	bootflags;		/* Multiboot information flags		*/
+extern	char	bootcmdline[];		/* Boot command line			*/
+extern	uint32	bootmemtop;		/* End of usable memory above 1M	*/
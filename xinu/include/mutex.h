@@ -0,0 +1,32 @@
+/* mutex.h - isbadmutex */
+
+/* Mutexes with priority inheritance: while a process waits for a mutex	*/
+/*   its owner runs at no less than the waiter's priority, along the	*/
+/*   whole chain of owners if the owner itself waits for a mutex.  The	*/
+/*   owner's priority drops back (to prbaseprio, or to what it still	*/
+/*   inherits through other mutexes) when it unlocks.  Each process	*/
+/*   keeps the mutexes it holds on a list (prmheld, chained through	*/
+/*   mnext), so only those are looked at when its priority is redone.	*/
+
+#ifndef	NMUTEX
+#define	NMUTEX		32	/* Number of mutexes, if not defined	*/
+#endif
+
+/* Mutex state definitions */
+
+#define	M_FREE	0		/* Mutex table entry is available	*/
+#define	M_USED	1		/* Mutex table entry is in use		*/
+
+/* Mutex table entry */
+struct	mentry	{
+	byte	mstate;		/* Whether entry is M_FREE or M_USED	*/
+	pid32	mowner;		/* Process holding it, or EMPTY		*/
+	qid16	mqueue;		/* Waiting processes, highest priority	*/
+				/*     first				*/
+	mid32	mnext;		/* Next mutex held by the same owner,	*/
+				/*     or EMPTY				*/
+};
+
+extern	struct	mentry mutextab[];
+
+#define	isbadmutex(m)	((int32)(m) < 0 || (m) >= NMUTEX)
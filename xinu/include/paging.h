@@ -75,15 +75,72 @@ extern unsigned int error_code;
 #define MAX_PT_SIZE	256	/* size of space used for page tables (in frames)	 */
 #define N_PAGE_ENTRIES 1024
 
+// The MAX_* sizes above are the fixed layout used when the boot loader
+// does not report the memory size. Otherwise init_paging() splits the
+// memory above the kernel heap using the shares below (virtual stack
+// gets what is left), and ffs=, swap=, vstack=, pdpt= on the boot
+// command line override the frame counts
+#define FFS_SHARE       50      /* % of free frames given to FFS                 */
+#define SWAP_SHARE      25      /* % of free frames given to swap                */
+#define PAGING_MAXMEM   0x40000000 /* memory above 1 GB is left unused           */
+
+// When PD/PT, virtual stack or swap run out, oom_kill() picks the user
+// process with the largest footprint (in frames) less OOM_PRIO_BIAS
+// frames per priority level; oombias= on the boot command line changes it
+#define OOM_PRIO_BIAS   4
+
+extern int32 oom_prio_bias;
+
+// Directories of exited user processes are kept (up to PDCACHE) with the
+// shared flat-map entries still filled in, so create_directory() skips
+// zeroing and refilling them. getpdptframe() drains the cache before it
+// calls the OOM killer
+#define PDCACHE         8
+
+extern uint32 npdcache;        /* directories held in the cache     */
+extern uint32 pdcachehits;     /* create_directory() served by it   */
+extern uint32 pdcachemisses;   /* create_directory() built afresh   */
+
+// The virtual stack of an exited user process is kept (up to VSTKCACHE)
+// as its page table with the stack frames still mapped; a vcreate with
+// the same stack size plugs the table into its directory instead of
+// mapping the stack page by page. getpdptframe() and getvstackframe()
+// drain it before they call the OOM killer
+#define VSTKCACHE       8
+
+extern uint32 nvstkcache;      /* stacks held in the cache          */
+extern uint32 vstkcachehits;   /* vcreate stacks served by it       */
+
 #define ASSERT( cond, msg, ... ) \
    if( (cond) == FALSE ) {\
       kprintf("SYSERR:: " msg, ##__VA_ARGS__); \
       halt(); \
    }
 
-extern pt_t *ptmap[MAX_FSS_SIZE];
-extern uint32 ffs2swapmap[MAX_FSS_SIZE];
-extern pt_t *swap2ffsmap[MAX_SWAP_SIZE];
+extern uint32 npdptframes;     /* frames in the PD/PT region        */
+extern uint32 nffsframes;      /* frames in the FFS region          */
+extern uint32 nswapframes;     /* frames in the swap region         */
+extern uint32 nvstackframes;   /* frames in the virtual stack region*/
+extern uint32 maxheapframes;   /* max virtual heap (FFS + swap)     */
+
+extern pt_t **ptmap;           /* nffsframes entries                */
+extern uint32 *ffs2swapmap;    /* nffsframes entries                */
+extern pt_t **swap2ffsmap;     /* nswapframes entries               */
+extern pid32 *ffs2pid;         /* owner of each FFS frame           */
+
+// Page copy/zero/swap routines picked by pagecopy_init() (pagecopy.c)
+extern void (*page_copy)(void *, void *);
+extern void (*page_zero)(void *);
+extern void (*page_swap)(void *, void *);
+extern char *page_variant;
+extern bool8 page_has_sse2;
+
+#define CPUID_FXSR      0x01000000 /* cpuid(1) %edx: FXSAVE/FXRSTOR        */
+#define CPUID_SSE2      0x04000000 /* cpuid(1) %edx: SSE2                  */
+#define CR0_MP          0x00000002 /* monitor coprocessor                  */
+#define CR0_EM          0x00000004 /* x87 emulation (must be off for SSE)  */
+#define CR4_OSFXSR      0x00000200 /* OS supports FXSAVE and SSE           */
+#define CR4_OSXMMEXCPT  0x00000400 /* OS handles SIMD FP exceptions        */
 
 extern long kernel_sp_space[1024];
 extern long kernel_sp;
@@ -1,13 +1,21 @@
 /* ports.h - isbadport */
 
-#define	NPORTS		30		/* Maximum number of ports	*/
-#define	PT_MSGS		100		/* Total messages in system	*/
+#define	NPORTS		30		/* Default number of ports	*/
+#define	NPORTSMAX	4096		/* Largest nports= at boot	*/
 #define	PT_FREE		1		/* Port is free			*/
 #define	PT_LIMBO	2		/* Port is being deleted/reset	*/
 #define	PT_ALLOC	3		/* Port is allocated		*/
 
+/* Each port allocates its own message nodes at ptcreate, one per	*/
+/*   message it can hold, so a send that got past the sender		*/
+/*   semaphore always finds a node.  A message is a word plus a	*/
+/*   length: ptsendbuf passes a buffer (e.g. from getbuf) and its	*/
+/*   length, and the receiver owns the buffer from then on.  ptsendn	*/
+/*   and ptrecvn move a batch with one signaln per run of slots.	*/
+
 struct	ptnode	{			/* Node on list of messages 	*/
 	uint32	ptmsg;			/* A one-word message		*/
+	uint32	ptlen;			/* Length when ptmsg is a buffer*/
 	struct	ptnode	*ptnext;	/* Pointer to next node on list	*/
 };
 
@@ -19,11 +27,13 @@ struct	ptentry	{			/* Entry in the port table	*/
 	int32	ptseq;			/* Sequence changed at creation	*/
 	struct	ptnode	*pthead;	/* List of message pointers	*/
 	struct	ptnode	*pttail;	/* Tail of message list		*/
+	struct	ptnode	*ptfree;	/* Free nodes of this port	*/
+	struct	ptnode	*ptnodes;	/* Memory for the nodes		*/
+	int32	ptnextfree;		/* Next entry on the free list	*/
 };
 
-extern	struct	ptnode	*ptfree;	/* List of free nodes		*/
-extern	struct	ptentry	porttab[];	/* Port table			*/
-extern	int32	ptnextid;		/* Next port ID to try when	*/
-					/*   looking for a free slot	*/
+extern	struct	ptentry	*porttab;	/* Port table			*/
+extern	int32	nports;			/* Entries in porttab		*/
+extern	int32	ptfreelist;		/* First free port, or EMPTY	*/
 
-#define	isbadport(portid)	( (portid)<0 || (portid)>=NPORTS )
+#define	isbadport(portid)	( (portid)<0 || (portid)>=nports )
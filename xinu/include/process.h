@@ -1,10 +1,12 @@
 /* process.h - isbadpid */
 
-/* Maximum number of processes in the system */
+/* Default number of processes in the system; nproc= on the boot	*/
+/*   command line raises it up to NPROCMAX (queue IDs are 16 bits)	*/
 
 #ifndef NPROC
 #define	NPROC		8
 #endif		
+#define	NPROCMAX	8192
 
 /* Process state constants */
 
@@ -16,6 +18,10 @@
 #define	PR_SUSP		5	/* Process is suspended			*/
 #define	PR_WAIT		6	/* Process is on semaphore queue	*/
 #define	PR_RECTIM	7	/* Process is receiving with timeout	*/
+#define	PR_MUTEX	8	/* Process is on a mutex queue		*/
+#define	PR_LOCK		9	/* Process is on a lock or rwlock queue	*/
+#define	PR_EVENT	10	/* Process is blocked in waitany	*/
+#define	PR_WKWAIT	11	/* Process is blocked in wkwait		*/
 
 /* Miscellaneous process definitions */
 
@@ -31,7 +37,7 @@
 /* Inline code to check process ID (assumes interrupts are disabled)	*/
 
 #define	isbadpid(x)	( ((pid32)(x) < 0) || \
-			  ((pid32)(x) >= NPROC) || \
+			  ((pid32)(x) >= nproc) || \
 			  (proctab[(x)].prstate == PR_FREE))
 
 /* Number of device descriptors a process can have open */
@@ -43,25 +49,47 @@
 struct procent {		/* Entry in the process table		*/
 	uint16	prstate;	/* Process state: PR_CURR, etc.		*/
 	pri16	prprio;		/* Process priority			*/
+	pri16	prbaseprio;	/* Priority before mutex inheritance	*/
 	char	*prstkptr;	/* Saved stack pointer			*/
 	char	*prstkbase;	/* Base of run time stack		*/
 	uint32	prstklen;	/* Stack length in bytes		*/
 	char	prname[PNMLEN];	/* Process name				*/
 	sid32	prsem;		/* Semaphore on which process waits	*/
+	mid32	prmutex;	/* Mutex on which process waits		*/
+	mid32	prmheld;	/* First mutex it holds, or EMPTY	*/
 	pid32	prparent;	/* ID of the creating process		*/
 	umsg32	prmsg;		/* Message sent to this process		*/
    pdbr_t pdbr;
    uint32 hsize;
    uint32 vfree;
    uint32 vmax;
+   uint32 nffs;      /* heap pages resident in FFS             */
+   uint32 nswap;     /* heap pages holding a swap frame        */
+   uint32 npt;       /* PD/PT frames (shared flat map excluded) */
+   uint32 nstk;      /* virtual stack frames                   */
+   uint32 nfaults;   /* page faults served                     */
+   uint32 nevicts;   /* heap pages evicted from FFS to swap    */
 	bool8	prhasmsg;	/* Nonzero iff msg is valid		*/
    bool8 pruser;
+   bool8 prfair;     /* scheduled in the fair-share class       */
+   uint32 prpass;    /* fair-share pass (weighted CPU time)     */
+   uint64 prstart;   /* TSC when last charged                   */
+	uint64	prcycles;	/* TSC ticks run, interrupts excluded	*/
+	uint64	prsvccyc;	/*   of which in the page fault handler	*/
+	uint32	prnvcsw;	/* Switched out by blocking		*/
+	uint32	prnivcsw;	/* Switched out by preemption		*/
+	uint64	prwaketsc;	/* TSC when readied, 0 if not traced	*/
+	bool8	prfpuused;	/* Has prfxsave been filled?		*/
+	byte	prfxsave[FXSAVESIZE]	/* x87/SSE state while another	*/
+		__attribute__ ((aligned (16))); /*   process owns the FPU */
 	int16	prdesc[NDESC];	/* Device descriptors for process	*/
+	pid32	prnextfree;	/* Next entry on the free list		*/
 };
 
 /* Marker for the top of a process stack (used to help detect overflow)	*/
 #define	STACKMAGIC	0x0A0AAAA9
 
-extern	struct	procent proctab[];
+extern	struct	procent *proctab;
+extern	int32	nproc;		/* Entries in proctab			*/
 extern	int32	prcount;	/* Currently active processes		*/
 extern	pid32	currpid;	/* Currently executing process		*/
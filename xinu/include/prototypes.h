@@ -3,6 +3,13 @@ extern	status	_82545EMInit(struct ethcblk *);
 extern	status	_82545EM_read_phy_reg(struct ethcblk *, uint32, uint16 *);
 extern	status	_82545EM_write_phy_reg(struct ethcblk *, uint32, uint16);
 
+/* in file acct.c */
+extern	void	acctinit(void);
+extern	void	acctintrenter(int32);
+extern	void	acctintrexit(void);
+extern	void	acctswitch(struct procent *, bool8);
+extern	uint64	acctcycles(pid32);
+
 /* in file addargs.c */
 extern	status	addargs(pid32, int32, int32[], int32,char *, void *);
 
@@ -17,6 +24,15 @@ extern	void	arp_hton(struct arppacket *);
 /* in file ascdate.c */
 extern	status	ascdate(uint32, char *);
 
+/* in file bootinfo.c */
+extern	status	getbootarg(char *, char *, int32);
+
+/* in file buddy.c */
+extern	void	buddyinit(void);
+extern	char	*buddyget(uint32);
+extern	status	buddyfree(char *, uint32);
+extern	void	buddystat(uint32 *, uint32 *, uint32 *);
+
 /* in file bufinit.c */
 extern	status	bufinit(void);
 
@@ -29,12 +45,19 @@ extern	uint32	clkcount(void);
 /* in file clkhandler.c */
 extern	interrupt clkhandler(void);
 
+/* in file clkidle.c */
+extern	void	clkidle(void);
+extern	void	clkwake(bool8);
+
 /* in file clkinit.c */
 extern	void	clkinit(void);
 
 /* in file clkdisp.S */
 extern	void	clkdisp(void);
 
+/* in file pagefault_handler.c */
+extern	void	pagefault_handler(void);
+
 /* in file pagefault_handler_disp.S */
 extern	void	pagefault_handler_disp(void);
 
@@ -44,9 +67,25 @@ extern	syscall	close(did32);
 /* in file control.c */
 extern	syscall	control(did32, int32, int32, int32);
 
+/* in file coro.c */
+extern	status	coinit(struct cosched *, int32, uint32);
+extern	int32	cocreate(struct cosched *, void (*)(int32), int32);
+extern	status	corun(struct cosched *);
+extern	status	codone(struct cosched *);
+extern	void	coreclaim(pid32);
+extern	status	coyield(void);
+extern	int32	cowait(struct evwait *, int32);
+extern	status	cosleep(int32);
+extern	umsg32	corecvtime(int32);
+extern	int32	coudprecv(uid32, char *, int32, int32);
+
+/* in file coswitch.S */
+extern	void	coswitch(uint32 **, uint32 *);
+
 /* in file create.c */
 extern	pid32	create(void *, uint32, pri16, char *, uint32, ...);
 extern	pid32	newpid(void);
+extern	void	freepid(pid32);
 
 /* in file vcreate.c */
 extern	pid32	vcreate(void *, uint32, uint32, pri16, char *, uint32, ...);
@@ -110,14 +149,37 @@ extern	void	trap(int32);
 /* in file exception.c */
 extern  void exception(int32, int32*);
 
+/* in file fairsched.c */
+extern	void	fairinit(void);
+extern	status	fairinsert(pid32);
+extern	pid32	fairremove(pid32);
+extern	pid32	fairdequeue(void);
+extern	void	faircharge(pid32);
+extern	bool8	fairkeep(pid32);
+
+/* in file fpu.c */
+extern	void	fpuinit(void);
+extern	void	fpuhandler(void);
+extern	void	fpuswitch(pid32);
+extern	void	fpurelease(pid32);
+extern	void	fpukernel(void);
+extern	void	fpukerneldone(void);
+
+/* in file fpudisp.S */
+extern	void	fpudisp(void);
+
 /* in file freebuf.c */
 extern	syscall	freebuf(char *);
+extern	syscall	freebufs(char *[], int32);
 
 /* in file freemem.c */
 extern	syscall	freemem(char *, uint32);
+extern	status	memlistfree(char *, uint32);
 
 /* in file getbuf.c */
 extern	char	*getbuf(bpid32);
+extern	char	*trygetbuf(bpid32);
+extern	int32	getbufs(bpid32, char *[], int32);
 
 /* in file getc.c */
 extern	syscall	getc(did32);
@@ -129,6 +191,8 @@ extern	pid32	getitem(pid32);
 
 /* in file getmem.c */
 extern	char	*getmem(uint32);
+extern	char	*memlistget(uint32);
+extern	void	memliststat(uint32 *, uint32 *, uint32 *);
 
 /* in file getpid.c */
 extern	pid32	getpid(void);
@@ -138,6 +202,8 @@ extern	syscall	getprio(pid32);
 
 /* in file getstk.c */
 extern	char	*getstk(uint32);
+extern	syscall	freestk(char *, uint32);
+extern	uint32	stkreclaim(void);
 extern	char	*getvstk(uint32, pid32);
 
 /* in file gettime.c */
@@ -171,11 +237,10 @@ extern	int32	sizmem(void);
 /* in file insert.c */
 extern	status	insert(pid32, qid16, int32);
 
-/* in file insertd.c */
-extern	status	insertd(pid32, qid16, int32);
 
 /* in file intr.S */
 extern	uint16	getirmask(void);
+extern	void	pause(void);
 
 /* in file ioerr.c */
 extern	devcall	ioerr(void);
@@ -276,6 +341,23 @@ extern	status	lfsetup(struct lflcblk *);
 /* in file lftruncate.c */
 extern	status	lftruncate(struct lflcblk *);
 
+/* in file lock.c */
+extern	void	lockinit(void);
+extern	qid16	lockqget(void);
+extern	void	lockqput(qid16);
+extern	syscall	lkinit(struct lock *);
+extern	syscall	lkdelete(struct lock *);
+extern	syscall	lkwait(struct lock *);
+extern	syscall	lkwake(struct lock *);
+
+/* in file lockfast.S */
+extern	syscall	lkacquire(struct lock *);
+extern	syscall	lkrelease(struct lock *);
+extern	syscall	rwrdacquire(struct rwlock *);
+extern	syscall	rwrdrelease(struct rwlock *);
+extern	syscall	rwwracquire(struct rwlock *);
+extern	syscall	rwwrrelease(struct rwlock *);
+
 /* in file lpgetc.c */
 extern	devcall	lpgetc(struct dentry *);
 
@@ -309,6 +391,7 @@ extern  void    *memset(void *, const int, int32);
 
 /* in file mkbufpool.c */
 extern	bpid32	mkbufpool(int32, int32);
+extern	syscall	growbufpool(bpid32, int32, int32);
 
 /* in file mount.c */
 extern	syscall	mount(char *, char *, did32);
@@ -325,6 +408,26 @@ extern	status	namcpy(char *, char *, int32);
 /* in file namopen.c */
 extern	devcall	namopen(struct dentry *, char *, char *);
 
+/* in file mutexcreate.c */
+extern	mid32	mutexcreate(void);
+
+/* in file mutexdelete.c */
+extern	syscall	mutexdelete(mid32);
+
+/* in file mutexlock.c */
+extern	syscall	mutexlock(mid32);
+
+/* in file mutexprio.c */
+extern	void	mutexown(mid32, pid32);
+extern	void	mutexdisown(mid32);
+extern	pri16	mutexinherit(pid32);
+extern	void	mutexprio(pid32, pri16);
+extern	void	mutexhandoff(mid32);
+extern	void	mutexrelease(pid32);
+
+/* in file mutexunlock.c */
+extern	syscall	mutexunlock(mid32);
+
 /* in file newqueue.c */
 extern	qid16	newqueue(void);
 
@@ -357,16 +460,20 @@ extern	syscall	ptcreate(int32);
 extern	syscall	ptdelete(int32, int32 (*)(int32));
 
 /* in file ptinit.c */
-extern	syscall	ptinit(int32);
+extern	syscall	ptinit(void);
 
 /* in file ptrecv.c */
 extern	uint32	ptrecv(int32);
+extern	char	*ptrecvbuf(int32, uint32 *);
+extern	int32	ptrecvn(int32, umsg32 [], uint32 [], int32);
 
 /* in file ptreset.c */
 extern	syscall	ptreset(int32, int32 (*)(int32));
 
 /* in file ptsend.c */
 extern	syscall	ptsend(int32, umsg32);
+extern	syscall	ptsendbuf(int32, char *, uint32);
+extern	syscall	ptsendn(int32, umsg32 [], uint32 [], int32);
 
 /* in file putc.c */
 extern	syscall	putc(did32, char);
@@ -378,6 +485,14 @@ extern	int32	quark_irq_routing(void);
 extern	pid32	enqueue(pid32, qid16);
 extern	pid32	dequeue(qid16);
 
+/* in file readyq.c */
+extern	void	readyinit(void);
+extern	status	readyinsert(pid32, pri16);
+extern	pid32	readyremove(pid32);
+extern	int32	readystrictkey(void);
+extern	int32	readyfirstkey(void);
+extern	pid32	readydequeue(void);
+
 /* in file ramclose.c */
 extern	devcall	ramclose(struct dentry *);
 
@@ -503,6 +618,14 @@ extern	devcall	rfsopen(struct dentry  *devptr, char *, char *);
 /* in file rfscomm.c */
 extern	int32	rfscomm(struct rf_msg_hdr *, int32,
 			struct rf_msg_hdr *, int32);
+/* in file rwlock.c */
+extern	syscall	rwinit(struct rwlock *);
+extern	syscall	rwdelete(struct rwlock *);
+extern	syscall	rwrdwait(struct rwlock *);
+extern	syscall	rwwrwait(struct rwlock *);
+extern	syscall	rwrdwake(struct rwlock *);
+extern	syscall	rwwrwake(struct rwlock *);
+
 /* in file seek.c */
 extern	syscall	seek(did32, uint32);
 
@@ -511,6 +634,7 @@ extern	syscall	semcount(sid32);
 
 /* in file semcreate.c */
 extern	sid32	semcreate(int32);
+extern	void	freesem(sid32);
 
 /* in file semdelete.c */
 extern	syscall	semdelete(sid32);
@@ -534,6 +658,22 @@ extern	syscall	signaln(sid32, int32);
 extern	syscall	sleepms(int32);
 extern	syscall	sleep(int32);
 
+/* in file slab.c */
+extern	void	slabinit(void);
+extern	int32	slabclass(uint32);
+extern	uint32	slabround(uint32);
+extern	char	*slabget(int32, uint32);
+extern	void	slabput(int32, char *, uint32);
+extern	uint32	slabreclaim(void);
+
+/* in file spsc.c */
+extern	status	spscinit(struct spsc *, uint32 *, uint32);
+extern	status	spscdelete(struct spsc *);
+extern	status	spscenq(struct spsc *, uint32);
+extern	status	spscdeq(struct spsc *, uint32 *);
+extern	status	spscput(struct spsc *, uint32);
+extern	uint32	spscget(struct spsc *);
+
 /* in file start.S */
 extern	int32	inb(int32);
 extern	int32	inw(int32);
@@ -549,6 +689,28 @@ extern	int32	cpuid(void);
 /* in file suspend.c */
 extern	syscall	suspend(pid32);
 
+/* in file tabinit.c */
+extern	void	tabinit(void);
+extern	void	*tabget(uint32);
+
+/* in file timer.c */
+extern	void	tmrinit(void);
+extern	status	tmrset(struct timer *, int32, void (*)(int32), int32);
+extern	status	tmrcancel(struct timer *);
+extern	void	tmrtick(void);
+extern	uint32	tmrnext(uint32);
+
+/* in file trace.c */
+extern	void	traceinit(void);
+extern	void	traceclear(void);
+extern	void	traceevent(uint16, uint32, uint32);
+extern	void	tracewake(pid32);
+extern	void	tracerun(pid32);
+extern	void	traceirqspan(uint32, uint64);
+extern	void	traceirqoff(uint32);
+extern	void	traceirqon(void);
+extern	void	traceirqdrop(void);
+
 /* in file ttycontrol.c */
 extern	devcall	ttycontrol(struct dentry *, int32, int32, int32);
 
@@ -604,8 +766,23 @@ extern	void	userret(void);
 /* in file wait.c */
 extern	syscall	wait(sid32);
 
+/* in file waitany.c */
+extern	void	evinit(void);
+extern	int32	waitany(struct evwait [], int32, int32);
+extern	bool8	evready(struct evwait *);
+extern	bool8	evbad(struct evwait *);
+extern	void	evnotify(int32, int32);
+extern	void	evcancel(pid32);
+
 /* in file wakeup.c */
-extern	void	wakeup(void);
+extern	void	wakeup(int32);
+
+/* in file workq.c */
+extern	void	wqinit(void);
+extern	status	wksubmit(struct work *, int32);
+extern	status	wkdelay(struct work *, int32, int32);
+extern	status	wkcancel(struct work *);
+extern	status	wkwait(struct work *);
 
 /* in file write.c */
 extern	syscall	write(did32, char *, uint32);
@@ -627,23 +804,42 @@ extern	syscall	freepdptframe(uint32);
 extern	syscall	freeffsframe(uint32);
 extern	syscall	freeswapframe(uint32);
 extern	syscall	freevstackframe(uint32);
+extern	status	vstk_cache_get(pd_t *, uint32, uint32);
+extern	status	vstk_cache_drain();
 
 /* in file paging.c */
 extern	void	init_paging(void);
 extern	void	write_pdbr(pdbr_t);
 
 /* in file paging.c */
-extern	pdbr_t	create_directory(void);
+extern	status	create_directory(pdbr_t *);
 extern	void     destroy_directory(pid32);
 extern   uint32 create_pagetable_entries(uint32, uint32, uint32, uint32);
-extern void create_directory_entry(pd_t *, uint32, uint32, uint32, uint32);
+extern status create_directory_entry(pd_t *, uint32, uint32, uint32, uint32);
 
 extern char  	*vmalloc(uint32);
 extern void freevmem(pid32);
-extern void free_vpage(pd_t *dir, uint32 i, bool8);
+extern void free_vpage(pid32, pd_t *dir, uint32 i, bool8);
 
 extern void kernel_service_malloc(uint32, bool8, pid32);
 extern void kernel_service_free(char *, uint32, pid32);
+extern void kernel_service(bool8, char *, uint32, bool8, pid32);
+
+/* in file pageops.S */
+extern void page_copy_rep(void *, void *);
+extern void page_zero_rep(void *);
+extern void page_swap_rep(void *, void *);
+extern void page_copy_sse2(void *, void *);
+extern void page_zero_sse2(void *);
+extern void page_swap_sse2(void *, void *);
+
+/* in file pagecopy.c */
+extern void pagecopy_init(void);
+
+/* in file oom.c */
+extern uint32 oom_footprint(pid32);
+extern pid32 oom_select(pid32);
+extern pid32 oom_kill(pid32);
 
 extern unsigned long read_cr0(void);
 extern unsigned long read_cr2(void);
@@ -2,10 +2,14 @@
 
 /* Queue structure declarations, constants, and inline functions	*/
 
-/* Default # of queue entries: 1 per process plus 2 for ready list plus	*/
-/*			2 for sleep list plus 2 per semaphore		*/
+/* Default # of queue entries: 1 per process plus 2 per semaphore,	*/
+/*			mutex and lock wait queue (the ready list has	*/
+/*			its own heads, see struct readyq below, the	*/
+/*			fair-share class a heap, see fairsched.c, and	*/
+/*			sleeping processes are on the timing wheel, see	*/
+/*			timer.h)					*/
 #ifndef NQENT
-#define NQENT	(NPROC + 4 + NSEM + NSEM)
+#define NQENT	(nproc + nsem + nsem + NMUTEX + NMUTEX + NLOCK + NLOCK)
 #endif
 
 #define	EMPTY	(-1)		/* Null value for qnext or qprev index	*/
@@ -18,7 +22,7 @@ struct	qentry	{		/* One per process plus two per list	*/
 	qid16	qprev;		/* Index of previous process or head	*/
 };
 
-extern	struct qentry	queuetab[];
+extern	struct qentry	*queuetab;
 
 /* Inline queue manipulation functions */
 
@@ -26,11 +30,34 @@ extern	struct qentry	queuetab[];
 #define	queuetail(q)	((q) + 1)
 #define	firstid(q)	(queuetab[queuehead(q)].qnext)
 #define	lastid(q)	(queuetab[queuetail(q)].qprev)
-#define	isempty(q)	(firstid(q) >= NPROC)
-#define	nonempty(q)	(firstid(q) <  NPROC)
+#define	isempty(q)	(firstid(q) >= nproc)
+#define	nonempty(q)	(firstid(q) <  nproc)
 #define	firstkey(q)	(queuetab[firstid(q)].qkey)
 #define	lastkey(q)	(queuetab[ lastid(q)].qkey)
 
 /* Inline to check queue id assumes interrupts are disabled */
 
-#define	isbadqid(x)	(((int32)(x) < NPROC) || (int32)(x) >= NQENT-1)
+#define	isbadqid(x)	(((int32)(x) < nproc) || (int32)(x) >= NQENT-1)
+
+/* The ready list is not kept in queuetab order: each priority has its	*/
+/*   own FIFO (linked through the qnext/qprev fields of queuetab, with	*/
+/*   the priority in qkey), and a three-level bitmap of non-empty	*/
+/*   priorities finds the highest one with three bit scans		*/
+
+#define	NRDYPRIO	32768		/* Priorities 0 to 32767	*/
+#define	RDYWORDS	(NRDYPRIO / 32)	/* Words in the bottom bitmap	*/
+
+struct	readyq	{
+	uint32	rqtop;			/* Bit i: rqmid[i] is nonzero	*/
+	uint32	rqmid[RDYWORDS / 32];	/* Bit j of word i: rqbits[32*i	*/
+					/*   + j] is nonzero		*/
+	uint32	rqbits[RDYWORDS];	/* Bit k of word w: priority	*/
+					/*   32*w + k has a process	*/
+	qid16	rqhead[NRDYPRIO];	/* First process per priority	*/
+	qid16	rqtail[NRDYPRIO];	/* Last process per priority	*/
+	int32	rqcount;		/* Number of ready processes	*/
+};
+
+extern	struct	readyq	readyq;
+
+#define	readyempty()	(readyq.rqtop == 0)	/* Fair class not included	*/
@@ -14,3 +14,24 @@ struct	defer	{
 };
 
 extern	struct	defer	Defer;
+
+/* Fair-share class: with "fair" (or "fair=<prio>") on the boot command	*/
+/*   line, user processes (vcreate) are scheduled by stride instead of	*/
+/*   strict priority.  Their prprio is a weight: every 2^FAIRSHIFT TSC	*/
+/*   ticks of CPU add FAIRSTRIDE/prprio to the process's pass, and the	*/
+/*   ready one with the least pass runs next.  Ready fair processes are	*/
+/*   kept in a binary heap on pass.  The class as a whole competes with	*/
+/*   processes as if it were one process at priority fairprio; system	*/
+/*   processes at or above fairprio always run first.			*/
+
+#define	FAIRPRIO	20		/* Default class priority	*/
+#define	FAIRSHIFT	10		/* TSC ticks per unit: 2^10	*/
+#define	FAIRSTRIDE	4096		/* Pass per unit at weight 1	*/
+#define	FAIRMAXUNITS	0x10000		/* Most units charged at once	*/
+#define	FAIRRENORM	0xC0000000	/* Pass at which all passes are	*/
+					/*   shifted back toward zero	*/
+
+extern	bool8	fairenabled;		/* Do user processes use it?	*/
+extern	pri16	fairprio;		/* Priority of the class	*/
+extern	int32	nfair;			/* Ready fair processes		*/
+extern	uint32	fairvtime;		/* Pass of the last one picked	*/
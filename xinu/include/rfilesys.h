@@ -35,7 +35,7 @@ struct	rfdata	{
 	uint16	rf_ser_port;		/* Server UDP port		*/
 	uint16	rf_loc_port;		/* Local (client) UPD port	*/
 	int32	rf_udp_slot;		/* UDP slot to use		*/
-	sid32	rf_mutex;		/* Mutual exclusion for access	*/
+	mid32	rf_mutex;		/* Mutual exclusion for access	*/
 	bool8	rf_registered;		/* Has UDP port been registered?*/
 };
 
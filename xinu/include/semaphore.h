@@ -3,6 +3,7 @@
 #ifndef	NSEM
 #define	NSEM		120	/* Number of semaphores, if not defined	*/
 #endif
+#define	NSEMMAX		8192	/* Largest nsem= on the boot command line*/
 
 /* Semaphore state definitions */
 
@@ -15,8 +16,10 @@ struct	sentry	{
 	int32	scount;		/* Count for the semaphore		*/
 	qid16	squeue;		/* Queue of processes that are waiting	*/
 				/*     on the semaphore			*/
+	sid32	snextfree;	/* Next entry on the free list		*/
 };
 
-extern	struct	sentry semtab[];
+extern	struct	sentry *semtab;
+extern	int32	nsem;		/* Entries in semtab			*/
 
-#define	isbadsem(s)	((int32)(s) < 0 || (s) >= NSEM)
+#define	isbadsem(s)	((int32)(s) < 0 || (s) >= nsem)
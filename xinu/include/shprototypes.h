@@ -58,6 +58,12 @@ extern	shellcmd  xsh_ps	(int32, char *[]);
 /* in file xsh_sleep.c */
 extern	shellcmd  xsh_sleep	(int32, char *[]);
 
+/* in file xsh_top.c */
+extern	shellcmd  xsh_top	(int32, char *[]);
+
+/* in file xsh_trace.c */
+extern	shellcmd  xsh_trace	(int32, char *[]);
+
 /* in file xsh_udpdump.c */
 extern	shellcmd  xsh_udpdump	(int32, char *[]);
 
@@ -70,5 +76,8 @@ extern	shellcmd  xsh_udpeserver (int32, char *[]);
 /* in file xsh_uptime.c */
 extern	shellcmd  xsh_uptime	(int32, char *[]);
 
+/* in file xsh_workq.c */
+extern	shellcmd  xsh_workq	(int32, char *[]);
+
 /* in file xsh_help.c */
 extern	shellcmd  xsh_help	(int32, char *[]);
@@ -0,0 +1,31 @@
+/* slab.h - slab caches in front of the heap free list			*/
+
+/* getmem() requests of up to SLABMAX bytes, and getstk() requests of	*/
+/*   that size, are rounded up to one of NSLAB size classes and served	*/
+/*   from the class's cache of free objects.  An empty cache is filled	*/
+/*   by carving a chunk taken from the free list; freed objects go back	*/
+/*   to their cache as they are, with no constructor to run again.	*/
+/*   When the free list cannot satisfy a request, slabreclaim() hands	*/
+/*   every cached object back to it, where freemem coalesces them.	*/
+
+#define	SLABMAX		8192	/* Largest size served by a cache	*/
+#define	SLABQUANT	16	/* Class sizes are multiples of this	*/
+#define	NSLAB		18	/* Number of size classes		*/
+#define	SLABCHUNK	16384	/* Bytes carved per refill (at least	*/
+				/*   two objects)			*/
+
+struct	slabcache	{
+	uint32	scsize;		/* Object size in bytes			*/
+	struct	memblk	*scfree; /* Cached free objects (via mnext)	*/
+	uint32	scnfree;	/* Objects on scfree			*/
+	uint32	scinuse;	/* Objects handed out			*/
+	uint32	screq;		/* Bytes asked for by objects in use	*/
+	uint32	scallocs;	/* Allocations				*/
+	uint32	schits;		/*   of which served from scfree	*/
+	uint32	screfills;	/* Chunks carved from the free list	*/
+};
+
+extern	struct	slabcache slabtab[];	/* One cache per size class	*/
+extern	uint32	memlistcalls;		/* Free list walks		*/
+extern	uint64	memlistcycles;		/* TSC ticks spent walking it	*/
+extern	uint32	memlistmax;		/* Longest walk in ticks	*/
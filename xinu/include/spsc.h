@@ -0,0 +1,25 @@
+/* spsc.h - spscempty, spscfull						*/
+
+/* Single-producer single-consumer ring of words.  spscenq and spscdeq	*/
+/*   never block, never disable interrupts and never loop: the		*/
+/*   producer alone writes sptail and the consumer alone writes	*/
+/*   sphead, and each publishes its slot before moving its index.	*/
+/*   spscput and spscget block on a full or empty ring; a side that	*/
+/*   blocks sets a flag first, so the other side only takes the slow	*/
+/*   path (disable and signal) when the ring has just left the state	*/
+/*   that side is waiting on.  At most one process may put and one	*/
+/*   may get on a ring.							*/
+
+struct	spsc	{
+	volatile uint32	sphead;	/* Count of words dequeued		*/
+	volatile uint32	sptail;	/* Count of words enqueued		*/
+	uint32	spmask;		/* Slots - 1 (slots is a power of two)	*/
+	uint32	*spslots;	/* Storage supplied by the caller	*/
+	volatile bool8 spgetwait; /* Consumer blocked on empty		*/
+	volatile bool8 spputwait; /* Producer blocked on full		*/
+	sid32	spgetsem;	/* Where the consumer blocks		*/
+	sid32	spputsem;	/* Where the producer blocks		*/
+};
+
+#define	spscempty(r)	((r)->sphead == (r)->sptail)
+#define	spscfull(r)	((r)->sptail - (r)->sphead > (r)->spmask)
@@ -36,3 +36,62 @@ extern	int	ntests;		/* total number of tests		*/
 extern	struct	testcase testtab[]; /* table of test cases		*/
 
 #define	TESTSTK	8192		/* size of process stack used for test	*/
+
+/* Benchmarks selected with "bench=<name>" on the boot command line	*/
+
+struct	benchmark {
+    char	*name;		/* Name used on the command line	*/
+    void	(*bench) (void);/* Benchmark function			*/
+};
+
+extern	int32	nbench;		/* total number of benchmarks		*/
+extern	struct	benchmark benchtab[]; /* table of benchmarks		*/
+extern	uint32	bench_tsc_mhz;	/* TSC ticks per microsecond		*/
+
+#define	BENCHSTK	8192	/* size of process stack used by bench	*/
+#define	BENCHCALMS	100	/* ms used to calibrate the TSC		*/
+#define	QEMU_EXIT_PORT	0xf4	/* isa-debug-exit port used by qemu-run	*/
+
+status	bench_run(char *);
+void	bench_report(char *, char *, uint32, char *);
+uint32	bench_ns(uint64);
+void	testexit(int32);
+
+/* in file bench_vm.c */
+void	bench_vmfault(void);
+
+/* in file bench_pagecopy.c */
+void	bench_pagecopy(void);
+
+/* in file bench_sched.c */
+void	bench_sched(void);
+
+/* in file bench_timer.c */
+void	bench_timer(void);
+
+/* in file bench_fair.c */
+void	bench_fair(void);
+
+/* in file bench_lock.c */
+void	bench_lock(void);
+
+/* in file bench_alloc.c */
+void	bench_alloc(void);
+
+/* in file bench_heap.c */
+void	bench_heap(void);
+
+/* in file bench_port.c */
+void	bench_port(void);
+
+/* in file bench_spsc.c */
+void	bench_spsc(void);
+
+/* in file bench_workq.c */
+void	bench_workq(void);
+
+/* in file bench_coro.c */
+void	bench_coro(void);
+
+/* in file bench_spawn.c */
+void	bench_spawn(void);
@@ -0,0 +1,30 @@
+/* timer.h - tmrpending */
+
+/* Timers sit on a hierarchical timing wheel driven by the clock	*/
+/*   interrupt: 256 one-ms slots, then four levels of 64 slots, each	*/
+/*   slot of a level spanning a full turn of the level below.  Adding	*/
+/*   or cancelling a timer is O(1); a timer is moved down a level at	*/
+/*   most four times before it fires.					*/
+
+#define	TMR_ROOTBITS	8		/* Bits indexing the first level*/
+#define	TMR_LVLBITS	6		/* Bits indexing higher levels	*/
+#define	TMR_NLEVELS	4		/* Levels above the first	*/
+#define	TMR_ROOTSIZE	(1 << TMR_ROOTBITS)
+#define	TMR_LVLSIZE	(1 << TMR_LVLBITS)
+
+struct	timer	{			/* Embedded in the timer's owner*/
+	struct	timer	*tnext;		/* Next timer in the same slot	*/
+	struct	timer	*tprev;		/* Previous timer (NULL: first)	*/
+	struct	timer	**tslot;	/* Slot holding the timer, or	*/
+					/*   NULL when not pending	*/
+	uint32	texpires;		/* Value of ctr1000 to fire at	*/
+	void	(*tfunc)(int32);	/* Called from the clock	*/
+					/*   interrupt when it expires	*/
+	int32	targ;			/* Argument passed to tfunc	*/
+};
+
+#define	tmrpending(t)	((t)->tslot != NULL)
+
+extern	struct	timer	*proctimer;	/* Sleep/recvtime timer per	*/
+					/*   process			*/
+extern	uint32	ntimers;		/* Timers currently pending	*/
@@ -0,0 +1,53 @@
+/* trace.h - scheduler and interrupt latency tracer definitions	*/
+
+/* With tracing on (the "trace" boot argument or the shell's trace	*/
+/*   command) the kernel records, in TSC ticks:				*/
+/*     - how long a process waits between ready() and running		*/
+/*     - how long interrupts stay off, per disable() call site (and	*/
+/*	 for the page fault handler, which runs with them off)		*/
+/*   Histograms are log2 of the ticks; the shell command converts to	*/
+/*   time.  Context switches, wakeups and new per-site maxima also go	*/
+/*   into a ring of the last NTREVENT events.				*/
+
+#ifndef	NTREVENT
+#define	NTREVENT	256	/* Events kept in the ring		*/
+#endif
+#define	NTRSITE		64	/* disable() call sites tracked		*/
+#define	NTRWORST	8	/* Worst wakeup latencies kept		*/
+#define	NTRHIST		32	/* Histogram buckets (log2 of ticks)	*/
+
+/* Event types */
+
+#define	TR_SWITCH	1	/* targ: process switched to		*/
+#define	TR_WAKE		2	/* targ: ticks from ready() to running	*/
+#define	TR_IRQOFF	3	/* targ: ticks off, tsite: call site	*/
+
+struct	trevent	{
+	uint64	ttime;		/* TSC when the event was recorded	*/
+	uint16	ttype;		/* TR_SWITCH, TR_WAKE or TR_IRQOFF	*/
+	pid32	tpid;		/* Process current at the event		*/
+	uint32	tsite;		/* Call site, for TR_IRQOFF		*/
+	uint32	targ;		/* Depends on the type			*/
+};
+
+struct	trsite	{		/* Interrupts-off record of one site	*/
+	uint32	tsaddr;		/* Return address of disable(), or 0	*/
+	uint32	tscount;	/* Times interrupts were turned off	*/
+	uint32	tsmax;		/* Longest time off in ticks		*/
+	uint64	tstotal;	/* Total time off in ticks		*/
+};
+
+struct	trworst	{		/* One of the worst wakeup latencies	*/
+	pid32	twpid;		/* Process that waited			*/
+	pri16	twprio;		/* Its priority then			*/
+	char	twname[PNMLEN];	/* Its name then			*/
+	uint32	twticks;	/* Ticks from ready() to running	*/
+};
+
+extern	bool8	traceon;		/* Is the tracer recording?	*/
+extern	struct	trevent	trring[];	/* Ring of recent events	*/
+extern	uint32	trnext;			/* Events ever recorded		*/
+extern	struct	trsite	trsites[];	/* Interrupts-off by site	*/
+extern	struct	trworst	trworst[];	/* Worst wakeups, worst first	*/
+extern	uint32	trwakehist[];		/* Wakeup latency histogram	*/
+extern	uint32	troffhist[];		/* Interrupts-off histogram	*/
@@ -0,0 +1,65 @@
+/* workq.h - wkinit, wkpending */
+
+/* Work queues run short jobs on a pool of kernel worker processes so	*/
+/*   a subsystem does not need a process of its own.  A job is a	*/
+/*   struct work embedded in its owner; wksubmit may be called from	*/
+/*   interrupt code and never blocks.  wkdelay queues the job when its	*/
+/*   timer fires, wkcancel removes a job that has not started, and	*/
+/*   wkwait blocks (in PR_WKWAIT, which resume does not end) until a	*/
+/*   job has run.  A job must stay allocated until it is idle again.	*/
+/*   Each queue has its own priority and workers, and counts its depth	*/
+/*   and the delay from submission to the start of each job.		*/
+
+#define	WQ_HIGH		0		/* Urgent kernel jobs		*/
+#define	WQ_LOW		1		/* Background work		*/
+#define	NWORKQ		2
+
+#define	WQHIGHPRIO	400		/* Below netin and ipout (500)	*/
+#define	WQLOWPRIO	10		/* Below the shell and main	*/
+#define	WQHIGHWORKERS	2		/* Workers on each queue	*/
+#define	WQLOWWORKERS	1
+#define	WQMAXWORKERS	2
+#define	WQSTK		8192		/* Stack size of a worker	*/
+
+/* Job states */
+
+#define	WK_IDLE		0		/* Not queued, done or cancelled*/
+#define	WK_DELAYED	1		/* Timer armed by wkdelay	*/
+#define	WK_QUEUED	2		/* On a queue, not yet started	*/
+#define	WK_RUNNING	3		/* A worker is running wkfunc	*/
+
+struct	work	{			/* Embedded in the job's owner	*/
+	struct	work	*wknext;	/* Next job on the queue	*/
+	struct	work	*wkprev;	/* Previous job on the queue	*/
+	void	(*wkfunc)(int32);	/* Function the worker calls	*/
+	int32	wkarg;			/* Argument passed to wkfunc	*/
+	int32	wkstate;		/* WK_IDLE, WK_QUEUED, ...	*/
+	int32	wkq;			/* Queue the job is bound for	*/
+	pid32	wkwaiter;		/* Process in wkwait, or -1	*/
+	uint64	wkstamp;		/* TSC when queued		*/
+	struct	timer	wktimer;	/* Timer used by wkdelay	*/
+};
+
+struct	workq	{			/* Entry in the work queue table*/
+	struct	work	*wqhead;	/* First job to run		*/
+	struct	work	*wqtail;	/* Last job to run		*/
+	sid32	wqsem;			/* Count of queued jobs		*/
+	pri16	wqprio;			/* Priority of the workers	*/
+	int32	wqnworkers;		/* Workers on this queue	*/
+	pid32	wqworkers[WQMAXWORKERS];/* Their process IDs		*/
+	int32	wqdepth;		/* Jobs queued now		*/
+	int32	wqmaxdepth;		/* Most jobs ever queued	*/
+	uint32	wqsubmits;		/* Jobs queued			*/
+	uint32	wqstarts;		/* Jobs started			*/
+	uint32	wqdone;			/* Jobs finished		*/
+	uint32	wqcancels;		/* Jobs cancelled		*/
+	uint64	wqlatsum;		/* TSC ticks from queueing to	*/
+	uint32	wqlatmax;		/*   start, total and worst	*/
+};
+
+extern	struct	workq	workqtab[];
+
+#define	wkinit(w, f, a)	((w)->wkfunc = (f), (w)->wkarg = (a),		\
+			 (w)->wkstate = WK_IDLE, (w)->wkwaiter = -1,	\
+			 (w)->wktimer.tslot = NULL)
+#define	wkpending(w)	((w)->wkstate != WK_IDLE)
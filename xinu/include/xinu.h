@@ -3,15 +3,27 @@
 #include <kernel.h>
 #include <conf.h>
 #include <paging.h>
+#include <fpu.h>
 #include <process.h>
 #include <queue.h>
 #include <resched.h>
 #include <mark.h>
 #include <semaphore.h>
+#include <mutex.h>
+#include <lock.h>
 #include <memory.h>
+#include <slab.h>
+#include <buddy.h>
 #include <bufpool.h>
 #include <clock.h>
+#include <timer.h>
+#include <acct.h>
+#include <trace.h>
 #include <ports.h>
+#include <spsc.h>
+#include <event.h>
+#include <workq.h>
+#include <coro.h>
 #include <io.h>
 #include <uart.h>
 #include <tty.h>
@@ -3,6 +3,9 @@
 #include <xinu.h>
 
 struct	arpentry  arpcache[ARP_SIZ];	/* ARP cache			*/
+struct	rwlock	arplock;		/* Readers look up resolved	*/
+					/*   entries, writers change	*/
+					/*   entries			*/
 
 /*------------------------------------------------------------------------
  * arp_init  -  Initialize ARP cache for an Ethernet interface
@@ -15,6 +18,7 @@ void	arp_init(void)
 	for (i=1; i<ARP_SIZ; i++) {	/* Initialize cache to empty	*/
 		arpcache[i].arstate = AR_FREE;
 	}
+	rwinit(&arplock);
 }
 
 /*------------------------------------------------------------------------
@@ -47,6 +51,21 @@ status	arp_resolve (
 		return OK;
 	}
 
+	/* Most lookups hit a resolved entry: search for one under the	*/
+	/*	read lock without disabling interrupts			*/
+
+	rwrdacquire(&arplock);
+	for (i=0; i<ARP_SIZ; i++) {
+		arptr = &arpcache[i];
+		if (arptr->arstate == AR_RESOLVED
+		    && arptr->arpaddr == nxthop) {
+			memcpy(mac, arptr->arhaddr, ARP_HALEN);
+			rwrdrelease(&arplock);
+			return OK;
+		}
+	}
+	rwrdrelease(&arplock);
+
 	/* Ensure only one process uses ARP at a time */
 
 	mask = disable();
@@ -85,8 +104,10 @@ status	arp_resolve (
 	/* IP address not in cache -  allocate a new cache entry and	*/
 	/*	send an ARP request to obtain the answer		*/
 
+	rwwracquire(&arplock);
 	slot = arp_alloc();
 	if (slot == SYSERR) {
+		rwwrrelease(&arplock);
 		restore(mask);
 		return SYSERR;
 	}
@@ -95,6 +116,7 @@ status	arp_resolve (
 	arptr->arstate = AR_PENDING;
 	arptr->arpaddr = nxthop;
 	arptr->arpid = currpid;
+	rwwrrelease(&arplock);
 
 	/* Hand-craft an ARP Request packet */
 
@@ -138,7 +160,9 @@ status	arp_resolve (
 	/* If no response, return TIMEOUT */
 
 	if (msg == TIMEOUT) {
+		rwwracquire(&arplock);
 		arptr->arstate = AR_FREE;   /* Invalidate cache entry */
+		rwwrrelease(&arplock);
 		restore(mask);
 		return TIMEOUT;
 	}
@@ -207,6 +231,7 @@ void	arp_in (
 
 		/* Update sender's hardware address */
 
+		rwwracquire(&arplock);
 		memcpy(arptr->arhaddr, pktptr->arp_sndha, ARP_HALEN);
 
 		/* If a process was waiting, inform the process */
@@ -214,7 +239,10 @@ void	arp_in (
 		if (arptr->arstate == AR_PENDING) {
 			/* Mark resolved and notify waiting process */
 			arptr->arstate = AR_RESOLVED;
+			rwwrrelease(&arplock);
 			send(arptr->arpid, OK);
+		} else {
+			rwwrrelease(&arplock);
 		}
 	}
 
@@ -241,8 +269,10 @@ void	arp_in (
 	/*   add sender's info to cache, if not already present		*/
 
 	if (!found) {
+		rwwracquire(&arplock);
 		slot = arp_alloc();
 		if (slot == SYSERR) {	/* Cache is full */
+			rwwrrelease(&arplock);
 			kprintf("ARP cache overflow on interface\n");
 			freebuf((char *)pktptr);
 			restore(mask);
@@ -252,6 +282,7 @@ void	arp_in (
 		arptr->arpaddr = pktptr->arp_sndpa;
 		memcpy(arptr->arhaddr, pktptr->arp_sndha, ARP_HALEN);
 		arptr->arstate = AR_RESOLVED;
+		rwwrrelease(&arplock);
 	}
 
 	/* Hand-craft an ARP reply packet and send back to requester	*/
@@ -241,6 +241,7 @@ status	icmp_send (
 
 	pkt = icmp_mkpkt(remip, type, ident, seq, buf, len);
 	if ((int32)pkt == SYSERR) {
+		restore(mask);
 		return SYSERR;
 	}
 
@@ -268,12 +269,13 @@ struct	netpacket *icmp_mkpkt (
 	struct	netpacket *pkt;		/* pointer to packet buffer	*/
 	static	uint32	ipident=32767;	/* IP ident field		*/
 
-	/* Allocate packet */
+	/* Allocate packet without blocking, since echo replies are	*/
+	/*   made by netin and netin is what frees buffers		*/
 
-	pkt = (struct netpacket *)getbuf(netbufpool);
+	pkt = (struct netpacket *)trygetbuf(netbufpool);
 
 	if ((int32)pkt == SYSERR) {
-		panic("icmp_mkpkt: cannot get a network buffer\n");
+		return (struct netpacket *)SYSERR;
 	}
 
 	/* Create icmp packet in pkt */
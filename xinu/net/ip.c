@@ -367,11 +367,7 @@ process	ipout(void)
 
 		/* Obtain next packet from the IP output queue */
 
-		wait(ipqptr->iqsem);
-		pktptr = ipqptr->iqbuf[ipqptr->iqhead++];
-		if (ipqptr->iqhead >= IP_OQSIZ) {
-			ipqptr->iqhead= 0;
-		}
+		pktptr = (struct netpacket *)spscget(&ipqptr->iqring);
 
 		/* Fill in the MAC source address */
 
@@ -441,26 +437,18 @@ status	ip_enqueue(
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
-	struct	iqentry	*iptr;		/* Ptr. to network output queue	*/
 
-	/* Ensure only one process accesses output queue at a time */
+	/* Enqueue packet on network output queue.  Any process may	*/
+	/*   get here through ip_local, so disabling interrupts makes	*/
+	/*   the callers one producer as the ring requires		*/
 
 	mask = disable();
-
-	/* Enqueue packet on network output queue */
-
-	iptr = &ipoqueue;
-	if (semcount(iptr->iqsem) >= IP_OQSIZ) {
+	if (spscenq(&ipoqueue.iqring, (uint32)pktptr) == SYSERR) {
+		restore(mask);
 		kprintf("ipout: output queue overflow\n");
 		freebuf((char *)pktptr);
-		restore(mask);
 		return SYSERR;
 	}
-	iptr->iqbuf[iptr->iqtail++] = pktptr;
-	if (iptr->iqtail >= IP_OQSIZ) {
-		iptr->iqtail = 0;
-	}
-	signal(iptr->iqsem);
 	restore(mask);
 	return OK;	
 }
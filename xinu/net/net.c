@@ -36,6 +36,11 @@ void	net_init (void)
 
 	netbufpool = mkbufpool(PACKLEN, nbufs);
 
+	/* Let a burst that fills every queue grow the pool to twice	*/
+	/*   its size rather than stall netin				*/
+
+	growbufpool(netbufpool, nbufs / 4 + 1, 2 * nbufs);
+
 	/* Initialize the ARP cache */
 
 	arp_init();
@@ -50,11 +55,9 @@ void	net_init (void)
 
 	/* Initialize the IP output queue */
 
-	ipoqueue.iqhead = 0;
-	ipoqueue.iqtail = 0;
-	ipoqueue.iqsem = semcreate(0);
-	if((int32)ipoqueue.iqsem == SYSERR) {
-		panic("Cannot create ip output queue semaphore");
+	if (spscinit(&ipoqueue.iqring, ipoqueue.iqslots, IP_OQSIZ)
+							== SYSERR) {
+		panic("Cannot create ip output queue");
 		return;
 	}
 
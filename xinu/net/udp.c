@@ -63,6 +63,9 @@ void	udp_in(
 				udptr->udstate = UDP_USED;
 				send (udptr->udpid, OK);
 			}
+			if (nevwaiters > 0) {
+				evnotify(EV_UDP, i);
+			}
 			restore(mask);
 			return;
 		}
@@ -183,6 +186,10 @@ int32	udp_recv (
 	/* Wait for a packet to arrive */
 
 	if (udptr->udcount == 0) {		/* No packet is waiting	*/
+		if (timeout == 0) {		/* Caller only polls	*/
+			restore(mask);
+			return TIMEOUT;
+		}
 		udptr->udstate = UDP_RECV;
 		udptr->udpid = currpid;
 		msg = recvclr();
@@ -266,6 +273,10 @@ int32	udp_recvaddr (
 	/* Wait for a packet to arrive */
 
 	if (udptr->udcount == 0) {		/* No packet is waiting */
+		if (timeout == 0) {		/* Caller only polls	*/
+			restore(mask);
+			return TIMEOUT;
+		}
 		udptr->udstate = UDP_RECV;
 		udptr->udpid = currpid;
 		msg = recvclr();
@@ -24,10 +24,13 @@ const	struct	cmdent	cmdtab[] = {
 	{"ping",	FALSE,	xsh_ping},
 	{"ps",		FALSE,	xsh_ps},
 	{"sleep",	FALSE,	xsh_sleep},
+	{"top",		FALSE,	xsh_top},
+	{"trace",	FALSE,	xsh_trace},
 	{"udp",		FALSE,	xsh_udpdump},
 	{"udpecho",	FALSE,	xsh_udpecho},
 	{"udpeserver",	FALSE,	xsh_udpeserver},
 	{"uptime",	FALSE,	xsh_uptime},
+	{"workq",	FALSE,	xsh_workq},
 	{"?",		FALSE,	xsh_help}
 
 };
@@ -6,6 +6,10 @@
 
 static	void	printMemUse(void);
 static	void	printFreeList(void);
+static	void	printPagingUse(void);
+static	void	printSlabUse(void);
+static	void	printHeapUse(void);
+static	void	printBufUse(void);
 
 /*------------------------------------------------------------------------
  * xsh_memstat - Print statistics about memory use and dump the free list
@@ -19,8 +23,10 @@ shellcmd xsh_memstat(int nargs, char *args[])
 	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
 		printf("use: %s \n\n", args[0]);
 		printf("Description:\n");
-		printf("\tDisplays the current memory use and prints the\n");
-		printf("\tfree list.\n");
+		printf("\tDisplays the current memory use, the use of the\n");
+		printf("\tpaging regions by each process, the slab caches,\n");
+		printf("\tthe fragmentation of the heap and the buffer\n");
+		printf("\tpools, and prints the free list.\n");
 		printf("Options:\n");
 		printf("\t--help\t\tdisplay this help and exit\n");
 		return 0;
@@ -36,6 +42,10 @@ shellcmd xsh_memstat(int nargs, char *args[])
 	}
 
 	printMemUse();
+	printPagingUse();
+	printSlabUse();
+	printHeapUse();
+	printBufUse();
 	printFreeList();
 
 	return 0;
@@ -49,6 +59,18 @@ shellcmd xsh_memstat(int nargs, char *args[])
  */
 static void printFreeList(void)
 {
+#ifdef	BUDDYHEAP
+	int i;				/* Index into buddytab		*/
+
+	printf("Buddy free lists:\n");
+	printf("Block size  Blocks\n");
+	printf("----------  ------\n");
+	for (i = 0; i < NBUDDYORD; i++) {
+		printf("%10d  %6d\n", 1 << (i + BUDDYMINORD),
+						buddytab[i].bocount);
+	}
+	printf("\n");
+#else
 	struct memblk *block;
 
 	/* Output a heading for the free list */
@@ -62,6 +84,7 @@ static void printFreeList(void)
 			block->mlength, block->mlength);
 	}
 	printf("\n");
+#endif
 }
 
 extern void start(void);
@@ -78,7 +101,7 @@ static void printMemUse(void)
 	uint32 stack = 0;		/* Total used stack memory	*/
 	uint32 kheap = 0;		/* Free kernel heap memory	*/
 	uint32 kfree = 0;		/* Total free memory		*/
-	struct memblk *block;	 	/* Ptr to memory block		*/
+	uint32 nblocks, largest;	/* Unused heapstat results	*/
 
 	/* Calculate amount of text memory */
 
@@ -87,17 +110,15 @@ static void printMemUse(void)
 	/* Calculate amount of allocated stack memory */
 	/*  Skip the NULL process since it has a private stack */
 
-	for (i = 1; i < NPROC; i++) {
+	for (i = 1; i < nproc; i++) {
 		if (proctab[i].prstate != PR_FREE) {
 			stack += (uint32)proctab[i].prstklen;
 		}
 	}
 
-	/* Calculate the amount of memory on the free list */
+	/* Calculate the amount of memory free in the heap */
 
-	for (block = memlist.mnext; block != NULL; block = block->mnext) {
-		kfree += block->mlength;
-	}
+	heapstat(&kfree, &nblocks, &largest);
 
 	/* Calculate the amount of free kernel heap memory */
 
@@ -111,3 +132,139 @@ static void printMemUse(void)
 	printf("%10d bytes (0x%08x) of allocated stack space\n", stack, stack);
 	printf("%10d bytes (0x%08x) of available kernel heap space\n\n", kheap, kheap);
 }
+
+/*------------------------------------------------------------------------
+ * printSlabUse - Print each slab cache and the cost of free list walks
+ *------------------------------------------------------------------------
+ */
+static void printSlabUse(void)
+{
+	int i;				/* Index into slabtab		*/
+	struct slabcache *scptr;	/* Ptr to slab cache		*/
+	uint32 cached = 0;		/* Bytes held free in caches	*/
+	uint32 waste = 0;		/* Bytes lost to rounding	*/
+	uint64 cycles = memlistcycles;	/* Ticks spent walking the list	*/
+	uint32 calls = memlistcalls;	/* Walks of the list		*/
+
+	printf("Slab caches:\n");
+	printf("  Size  InUse   Free  Allocs    Hits  Refills\n");
+	printf("------  -----  -----  ------  ------  -------\n");
+	for (i = 0; i < NSLAB; i++) {
+		scptr = &slabtab[i];
+		if (scptr->scallocs == 0) {
+			continue;
+		}
+		printf("%6d  %5d  %5d  %6d  %6d  %7d\n", scptr->scsize,
+			scptr->scinuse, scptr->scnfree, scptr->scallocs,
+			scptr->schits, scptr->screfills);
+		cached += scptr->scnfree * scptr->scsize;
+		waste += scptr->scinuse * scptr->scsize - scptr->screq;
+	}
+
+	/* Scale down to 32 bits first; there is no 64-bit division	*/
+
+	while ((cycles >> 32) != 0) {
+		cycles >>= 1;
+		calls >>= 1;
+	}
+
+	printf("%10d bytes cached free, %d bytes lost to rounding\n",
+						cached, waste);
+	printf("%10d list walks, %d ticks mean, %d ticks max\n",
+			memlistcalls, (calls == 0) ? 0 : (uint32)cycles / calls,
+			memlistmax);
+	printf("%10d large stacks cached, %d getstk calls served\n\n",
+			nstkcache, stkcachehits);
+}
+
+/*------------------------------------------------------------------------
+ * printHeapUse - Print how fragmented the heap behind the slab caches is
+ *------------------------------------------------------------------------
+ */
+static void printHeapUse(void)
+{
+	uint32 kfree;			/* Free bytes in the heap	*/
+	uint32 nblocks;			/* Free blocks			*/
+	uint32 largest;			/* Largest free block		*/
+	uint32 frag = 0;		/* Per mille not in the largest	*/
+
+	heapstat(&kfree, &nblocks, &largest);
+	if (kfree >= 1024) {
+		frag = 1000 - ((largest >> 10) * 1000) / (kfree >> 10);
+	}
+	printf("Heap (%s):\n", HEAPNAME);
+	printf("%10d bytes free in %d blocks, largest %d bytes\n",
+						kfree, nblocks, largest);
+	printf("%10d per mille of free memory outside the largest block\n\n",
+						frag);
+}
+
+/*------------------------------------------------------------------------
+ * printBufUse - Print the size, use and counters of each buffer pool
+ *------------------------------------------------------------------------
+ */
+static void printBufUse(void)
+{
+	int i;				/* Index into buftab		*/
+	struct bpentry *bpptr;		/* Ptr to buffer pool		*/
+
+	printf("Buffer pools:\n");
+	printf("Pool  Size  Bufs   Max  InUse  High   Low   Allocs  Fails  Waits  Grows\n");
+	printf("----  ----  ----  ----  -----  ----  ----  -------  -----  -----  -----\n");
+	for (i = 0; i < nbpools; i++) {
+		bpptr = &buftab[i];
+		printf("%4d  %4d  %4d  %4d  %5d  %4d  %4d  %7d  %5d  %5d  %5d\n",
+			i, bpptr->bpsize, bpptr->bpnbufs, bpptr->bpmaxbufs,
+			bpptr->bpinuse, bpptr->bphigh, bpptr->bplow,
+			bpptr->bpallocs, bpptr->bpfails, bpptr->bpwaits,
+			bpptr->bpgrows);
+	}
+	printf("\n");
+}
+
+/*------------------------------------------------------------------------
+ * printPagingUse - Print the use of each paging region and the frames
+ *			held by each user process
+ *------------------------------------------------------------------------
+ */
+static void printPagingUse(void)
+{
+	int i;				/* Index into process table	*/
+	struct procent *prptr;		/* Ptr to process table entry	*/
+	uint32 ffs = 0;			/* FFS frames held by processes	*/
+	uint32 swap = 0;		/* Swap frames held		*/
+	uint32 pt = 0;			/* PD/PT frames held		*/
+	uint32 stk = 0;			/* Virtual stack frames held	*/
+
+	printf("Paging regions (frames):\n");
+	printf("Region   Total    Free\n");
+	printf("------  ------  ------\n");
+	printf("PD/PT   %6d  %6d\n", npdptframes, pdptlist.mlength / PAGE_SIZE);
+	printf("FFS     %6d  %6d\n", nffsframes, ffslist.mlength / PAGE_SIZE);
+	printf("Swap    %6d  %6d\n", nswapframes, swaplist.mlength / PAGE_SIZE);
+	printf("VStack  %6d  %6d\n", nvstackframes,
+					vstacklist.mlength / PAGE_SIZE);
+	printf("%d directories cached, %d vcreate hits, %d misses\n",
+				npdcache, pdcachehits, pdcachemisses);
+	printf("%d virtual stacks cached, %d vcreate hits\n\n",
+				nvstkcache, vstkcachehits);
+
+	printf("Pid  Name              Heap     FFS    Swap    PT  Stack  Faults  Evicts\n");
+	printf("---  ----------------  ------  ------  ------  ----  -----  ------  ------\n");
+	for (i = 1; i < nproc; i++) {
+		prptr = &proctab[i];
+		if (prptr->prstate == PR_FREE || !prptr->pruser) {
+			continue;
+		}
+		printf("%3d  %-16s  %6d  %6d  %6d  %4d  %5d  %6d  %6d\n",
+			i, prptr->prname, prptr->hsize - prptr->vfree,
+			prptr->nffs, prptr->nswap, prptr->npt, prptr->nstk,
+			prptr->nfaults, prptr->nevicts);
+		ffs  += prptr->nffs;
+		swap += prptr->nswap;
+		pt   += prptr->npt;
+		stk  += prptr->nstk;
+	}
+	printf("     %-16s  %6s  %6d  %6d  %4d  %5d\n\n", "total", "",
+					ffs, swap, pt, stk);
+}
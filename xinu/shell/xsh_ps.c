@@ -4,6 +4,38 @@
 #include <stdio.h>
 #include <string.h>
 
+/*------------------------------------------------------------------------
+ * psmem - print the memory accounting kept for each process
+ *------------------------------------------------------------------------
+ */
+static	void	psmem(
+	  char		*pstate[]	/* names for process states	*/
+	)
+{
+	struct	procent	*prptr;		/* pointer to process		*/
+	int32	i;			/* index into proctabl		*/
+
+	printf("%3s %-16s %5s %6s %6s %6s %4s %5s %8s %8s\n",
+		   "Pid", "Name", "State", "Heap", "FFS", "Swap", "PT",
+		   "Stack", "Faults", "Evicts");
+
+	printf("%3s %-16s %5s %6s %6s %6s %4s %5s %8s %8s\n",
+		   "---", "----------------", "-----", "------", "------",
+		   "------", "----", "-----", "--------", "--------");
+
+	for (i = 0; i < nproc; i++) {
+		prptr = &proctab[i];
+		if (prptr->prstate == PR_FREE) {  /* skip unused slots	*/
+			continue;
+		}
+		printf("%3d %-16s %s %6d %6d %6d %4d %5d %8d %8d\n",
+			i, prptr->prname, pstate[(int)prptr->prstate],
+			prptr->hsize - prptr->vfree, prptr->nffs,
+			prptr->nswap, prptr->npt, prptr->nstk,
+			prptr->nfaults, prptr->nevicts);
+	}
+}
+
 /*------------------------------------------------------------------------
  * xsh_ps - shell command to print the process table
  *------------------------------------------------------------------------
@@ -14,21 +46,28 @@ shellcmd xsh_ps(int nargs, char *args[])
 	int32	i;			/* index into proctabl		*/
 	char *pstate[]	= {		/* names for process states	*/
 		"free ", "curr ", "ready", "recv ", "sleep", "susp ",
-		"wait ", "rtime"};
+		"wait ", "rtime", "mutex", "lock ", "event",
+		"wkwt "};
 
 	/* For argument '--help', emit help about the 'ps' command	*/
 
 	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
-		printf("Use: %s\n\n", args[0]);
+		printf("Use: %s [-m]\n\n", args[0]);
 		printf("Description:\n");
 		printf("\tDisplays information about running processes\n");
 		printf("Options:\n");
+		printf("\t-m\t show per-process memory use (in frames)\n");
 		printf("\t--help\t display this help and exit\n");
 		return 0;
 	}
 
 	/* Check for valid number of arguments */
 
+	if (nargs == 2 && strncmp(args[1], "-m", 3) == 0) {
+		psmem(pstate);
+		return 0;
+	}
+
 	if (nargs > 1) {
 		fprintf(stderr, "%s: too many arguments\n", args[0]);
 		fprintf(stderr, "Try '%s --help' for more information\n",
@@ -48,7 +87,7 @@ shellcmd xsh_ps(int nargs, char *args[])
 
 	/* Output information for each process */
 
-	for (i = 0; i < NPROC; i++) {
+	for (i = 0; i < nproc; i++) {
 		prptr = &proctab[i];
 		if (prptr->prstate == PR_FREE) {  /* skip unused slots	*/
 			continue;
@@ -0,0 +1,175 @@
+/* xsh_top.c - xsh_top */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+#define	TOPDELAY	1		/* Default seconds between	*/
+					/*   refreshes			*/
+#define	TOPCOUNT	5		/* Default number of refreshes	*/
+
+/*------------------------------------------------------------------------
+ * toppermille - part/whole in tenths of a percent, without 64-bit
+ *		 division (there is no libgcc)
+ *------------------------------------------------------------------------
+ */
+static	uint32	toppermille(
+	  uint64	part,		/* Ticks of one consumer	*/
+	  uint64	whole		/* Ticks in the interval	*/
+	)
+{
+	while (whole > 0x3fffff) {	/* 1000 * whole fits in 32 bits	*/
+		part >>= 1;
+		whole >>= 1;
+	}
+	if (whole == 0) {
+		return 0;
+	}
+	return ((uint32)part * 1000) / (uint32)whole;
+}
+
+/*------------------------------------------------------------------------
+ * topnum - parse a decimal argument; returns SYSERR on a non-digit
+ *------------------------------------------------------------------------
+ */
+static	int32	topnum(
+	  char		*str		/* Argument to parse		*/
+	)
+{
+	int32	val = 0;		/* Value parsed so far		*/
+
+	if (*str == NULLCH) {
+		return SYSERR;
+	}
+	for (; *str != NULLCH; str++) {
+		if (*str < '0' || *str > '9') {
+			return SYSERR;
+		}
+		val = 10 * val + (*str - '0');
+	}
+	return val;
+}
+
+/*------------------------------------------------------------------------
+ * xsh_top - shell command to show the CPU use of each process and of
+ *	     the interrupt handlers, refreshed periodically
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_top(int nargs, char *args[])
+{
+	static	uint64	*lastcyc = NULL; /* Ticks run at the last sample	*/
+	static	uint64	*lastsvc;	/* Fault handler ticks then	*/
+	static	uint64	lastintr[NACCTINTR]; /* Handler ticks then	*/
+	struct	procent	*prptr;		/* pointer to process		*/
+	int32	delay = TOPDELAY;	/* Seconds between refreshes	*/
+	int32	count = TOPCOUNT;	/* Refreshes left		*/
+	int32	i;			/* index into proctab		*/
+	uint64	start, now;		/* TSC at the interval ends	*/
+	uint64	cyc, svc;		/* Ticks of a process		*/
+	uint32	pct, spct;		/* CPU and fault handler share	*/
+	char *pstate[]	= {		/* names for process states	*/
+		"free ", "curr ", "ready", "recv ", "sleep", "susp ",
+		"wait ", "rtime", "mutex", "lock ", "event",
+		"wkwt "};
+
+	/* For argument '--help', emit help about the 'top' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s [seconds [count]]\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tShows the share of the CPU used by each process\n");
+		printf("\tand interrupt handler over the last interval,\n");
+		printf("\trefreshed every seconds (default %d) count times\n",
+			TOPDELAY);
+		printf("\t(default %d).  Svc is the time spent in the page\n",
+			TOPCOUNT);
+		printf("\tfault handler; Vol and Inv count the switches by\n");
+		printf("\tblocking and by preemption\n");
+		printf("Options:\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 3) {
+		fprintf(stderr, "%s: too many arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+	if ((nargs >= 2 && (delay = topnum(args[1])) <= 0)
+	    || (nargs == 3 && (count = topnum(args[2])) <= 0)) {
+		fprintf(stderr, "%s: argument in error\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+	/* One sample per process table entry, kept for later runs */
+
+	if (lastcyc == NULL) {
+		lastcyc = (uint64 *)getmem(2 * nproc * sizeof(uint64));
+		if (lastcyc == (uint64 *)SYSERR) {
+			lastcyc = NULL;
+			fprintf(stderr, "%s: out of memory\n", args[0]);
+			return 1;
+		}
+		lastsvc = lastcyc + nproc;
+	}
+
+	for (i = 0; i < nproc; i++) {
+		lastcyc[i] = acctcycles(i);
+		lastsvc[i] = proctab[i].prsvccyc;
+	}
+	for (i = 0; i < NACCTINTR; i++) {
+		lastintr[i] = acctintr[i];
+	}
+	start = getticks();
+
+	while (count-- > 0) {
+		sleep(delay);
+		now = getticks();
+
+		printf("\n%3s %-16s %5s %4s %6s %6s %8s %8s\n",
+			"Pid", "Name", "State", "Prio", "CPU%", "Svc%",
+			"Vol", "Inv");
+		printf("%3s %-16s %5s %4s %6s %6s %8s %8s\n",
+			"---", "----------------", "-----", "----", "------",
+			"------", "--------", "--------");
+
+		for (i = 0; i < nproc; i++) {
+			prptr = &proctab[i];
+			cyc = acctcycles(i);
+			svc = prptr->prsvccyc;
+			if (prptr->prstate == PR_FREE) {
+				lastcyc[i] = lastsvc[i] = 0;
+				continue;
+			}
+			if (cyc < lastcyc[i] || svc < lastsvc[i]) {
+				lastcyc[i] = lastsvc[i] = 0; /* New process */
+			}
+			pct = toppermille(cyc - lastcyc[i], now - start);
+			spct = toppermille(svc - lastsvc[i], now - start);
+			printf("%3d %-16s %s %4d %4d.%d %4d.%d %8d %8d\n",
+				i, prptr->prname, pstate[(int)prptr->prstate],
+				prptr->prprio, pct / 10, pct % 10,
+				spct / 10, spct % 10, prptr->prnvcsw,
+				prptr->prnivcsw);
+			lastcyc[i] = cyc;
+			lastsvc[i] = svc;
+		}
+
+		printf("Interrupts:");
+		for (i = 0; i < NACCTINTR; i++) {
+			pct = toppermille(acctintr[i] - lastintr[i],
+							now - start);
+			printf(" %s %d.%d%%", acctintrname[i],
+				pct / 10, pct % 10);
+			lastintr[i] = acctintr[i];
+		}
+		printf("\n");
+		start = now;
+	}
+	return 0;
+}
@@ -0,0 +1,236 @@
+/* xsh_trace.c - xsh_trace */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+#define	TRCALMS		100		/* ms used to measure the TSC	*/
+#define	TREVENTS	16		/* Events shown by default	*/
+#define	TRSITES		10		/* Worst call sites shown	*/
+
+static	uint32	trmhz;			/* TSC ticks per microsecond	*/
+
+/*------------------------------------------------------------------------
+ * trtime - print a number of TSC ticks as ns or us
+ *------------------------------------------------------------------------
+ */
+static	void	trtime(
+	  uint32	ticks		/* Ticks to print		*/
+	)
+{
+	if (ticks < 4000000) {		/* ticks * 1000 fits 32 bits	*/
+		printf("%8u ns", (ticks * 1000) / trmhz);
+	} else {
+		printf("%8u us", ticks / trmhz);
+	}
+}
+
+/*------------------------------------------------------------------------
+ * trhist - print the nonzero buckets of a log2 histogram
+ *------------------------------------------------------------------------
+ */
+static	void	trhist(
+	  char		*title,		/* What was measured		*/
+	  uint32	hist[]		/* Counts per bucket		*/
+	)
+{
+	int32	b;			/* Bucket			*/
+
+	printf("\n%s:\n", title);
+	for (b = 0; b < NTRHIST; b++) {
+		if (hist[b] == 0) {
+			continue;
+		}
+		if (b == NTRHIST - 1) {
+			printf("   >=");
+			trtime((uint32)1 << b);
+		} else {
+			printf("    <");
+			trtime((uint32)2 << b);
+		}
+		printf(" %8u\n", hist[b]);
+	}
+}
+
+/*------------------------------------------------------------------------
+ * trshow - print the histograms, the worst offenders and the last
+ *	    nevents events
+ *------------------------------------------------------------------------
+ */
+static	void	trshow(
+	  int32		nevents		/* Events to list		*/
+	)
+{
+	static	struct	trsite sites[NTRSITE];	/* Copy of trsites	*/
+	static	struct	trevent ring[NTREVENT];	/* Copy of trring	*/
+	static	struct	trworst worst[NTRWORST];/* Copy of trworst	*/
+	static	uint32	wakehist[NTRHIST];	/* Copy of trwakehist	*/
+	static	uint32	offhist[NTRHIST];	/* Copy of troffhist	*/
+	struct	trsite	tmp;		/* For sorting the sites	*/
+	struct	trevent	*evptr;		/* Event being printed		*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint32	next;			/* Copy of trnext		*/
+	uint64	start, total;		/* For calibration and averages	*/
+	uint32	count;			/* Divisor for the average	*/
+	int32	i, j;			/* Loop indexes			*/
+
+	/* Measure the TSC rate so ticks can be shown as time		*/
+
+	start = getticks();
+	sleepms(TRCALMS);
+	trmhz = (uint32)(getticks() - start) / (TRCALMS * 1000);
+	if (trmhz == 0) {
+		trmhz = 1;
+	}
+
+	/* Copy everything at once so the report is consistent		*/
+
+	mask = disable();
+	memcpy((char *)sites, (char *)trsites, sizeof(sites));
+	memcpy((char *)ring, (char *)trring, sizeof(ring));
+	memcpy((char *)worst, (char *)trworst, sizeof(worst));
+	memcpy((char *)wakehist, (char *)trwakehist, sizeof(wakehist));
+	memcpy((char *)offhist, (char *)troffhist, sizeof(offhist));
+	next = trnext;
+	restore(mask);
+
+	printf("Tracer is %s, TSC %u MHz\n", traceon ? "on" : "off", trmhz);
+
+	trhist("Wakeup latency (ready to running)", wakehist);
+	printf("\nLongest wakeups:\n%3s %-16s %4s %11s\n",
+		"Pid", "Name", "Prio", "Latency");
+	for (i = 0; i < NTRWORST && worst[i].twticks != 0; i++) {
+		printf("%3d %-16s %4d ", worst[i].twpid, worst[i].twname,
+			worst[i].twprio);
+		trtime(worst[i].twticks);
+		printf("\n");
+	}
+
+	trhist("Interrupts off", offhist);
+
+	/* Sort the call sites by their longest time off		*/
+
+	for (i = 1; i < NTRSITE; i++) {
+		tmp = sites[i];
+		for (j = i; j > 0 && sites[j-1].tsmax < tmp.tsmax; j--) {
+			sites[j] = sites[j-1];
+		}
+		sites[j] = tmp;
+	}
+	printf("\nLongest interrupts-off call sites:\n%-18s %8s %11s %11s\n",
+		"Site", "Count", "Max", "Avg");
+	for (i = 0; i < TRSITES && sites[i].tsaddr != 0; i++) {
+		if (sites[i].tsaddr == (uint32)pagefault_handler) {
+			printf("%-18s", "pagefault_handler");
+		} else {
+			printf("0x%08x%8s", sites[i].tsaddr, "");
+		}
+		total = sites[i].tstotal;
+		count = sites[i].tscount;
+		while ((total >> 32) != 0) {	/* No 64-bit division	*/
+			total >>= 1;
+			count >>= 1;
+		}
+		printf(" %8u ", sites[i].tscount);
+		trtime(sites[i].tsmax);
+		printf(" ");
+		trtime(count ? (uint32)total / count : 0);
+		printf("\n");
+	}
+
+	/* List the most recent events, oldest first			*/
+
+	if (nevents > NTREVENT) {
+		nevents = NTREVENT;
+	}
+	if ((uint32)nevents > next) {
+		nevents = next;
+	}
+	printf("\nLast %d events (us before the newest):\n", nevents);
+	for (i = next - nevents; (uint32)i < next; i++) {
+		evptr = &ring[i % NTREVENT];
+		printf("%10u %3d ", (uint32)(ring[(next-1) % NTREVENT].ttime
+				- evptr->ttime) / trmhz, evptr->tpid);
+		switch (evptr->ttype) {
+		case TR_SWITCH:
+			printf("switch to %d\n", evptr->targ);
+			break;
+		case TR_WAKE:
+			printf("woken after");
+			trtime(evptr->targ);
+			printf("\n");
+			break;
+		case TR_IRQOFF:
+			printf("new max off at 0x%08x:", evptr->tsite);
+			trtime(evptr->targ);
+			printf("\n");
+			break;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ * xsh_trace - shell command to control the latency tracer and show
+ *	       what it recorded
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_trace(int nargs, char *args[])
+{
+	int32	nevents = TREVENTS;	/* Events to list		*/
+	char	*chptr;			/* Walks through argument	*/
+
+	/* For argument '--help', emit help about the 'trace' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s [on | off | clear | events]\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tShows the scheduler and interrupt latency tracer's\n");
+		printf("\thistograms of wakeup latency and interrupts-off\n");
+		printf("\ttime, the longest wakeups, the disable() call sites\n");
+		printf("\tthat kept interrupts off longest (addresses can be\n");
+		printf("\tlooked up with nm xinu.elf), and the last events\n");
+		printf("\t(default %d)\n", TREVENTS);
+		printf("Options:\n");
+		printf("\ton\t start recording\n");
+		printf("\toff\t stop recording\n");
+		printf("\tclear\t forget what was recorded\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	if (nargs > 2) {
+		fprintf(stderr, "%s: too many arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+	if (nargs == 2) {
+		if (strncmp(args[1], "on", 3) == 0) {
+			traceon = TRUE;
+			return 0;
+		}
+		if (strncmp(args[1], "off", 4) == 0) {
+			traceon = FALSE;
+			return 0;
+		}
+		if (strncmp(args[1], "clear", 6) == 0) {
+			traceclear();
+			return 0;
+		}
+		nevents = 0;
+		for (chptr = args[1]; *chptr != NULLCH; chptr++) {
+			if (*chptr < '0' || *chptr > '9') {
+				fprintf(stderr, "%s: argument in error\n",
+					args[0]);
+				fprintf(stderr,
+				    "Try '%s --help' for more information\n",
+				    args[0]);
+				return 1;
+			}
+			nevents = 10 * nevents + (*chptr - '0');
+		}
+	}
+	trshow(nevents);
+	return 0;
+}
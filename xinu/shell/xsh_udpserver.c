@@ -3,10 +3,15 @@
 #include <xinu.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
+
+#define	UES_MAXPORTS	6		/* Ports one server can serve	*/
 
 /*------------------------------------------------------------------------
  * xsh_udpeserver - shell command that acts as a UDP echo server (is
- *			usually run in background)
+ *			usually run in background).  A single process
+ *			serves every port named, waiting on all of them
+ *			with waitany
  *------------------------------------------------------------------------
  */
 shellcmd xsh_udpeserver(int nargs, char *args[])
@@ -19,22 +24,27 @@ shellcmd xsh_udpeserver(int nargs, char *args[])
 	int32	msglen;			/* length of outgoing message	*/
 	int32	slot;			/* slot in UDP table 		*/
 	uint16	echoserverport= 7;	/* port number for UDP echo	*/
+	struct	evwait evs[UES_MAXPORTS];/* one UDP event per port	*/
+	int32	nports;			/* number of ports served	*/
+	int32	i;			/* index into evs		*/
 
 	/* For argument '--help', emit a help message	*/
 
 	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
-		printf("Use: %s\n\n", args[0]);
+		printf("Use: %s [port...]\n\n", args[0]);
 		printf("Description:\n");
-		printf("\tBecome a UDP echo server\n");
+		printf("\tBecome a UDP echo server on each port given\n");
+		printf("\t(port %d if none is given)\n", echoserverport);
 		printf("Options:\n");
 		printf("\t--help\t display this help and exit\n");
 		return 0;
 	}
 
-	/* Check for valid IP address argument */
+	/* Check the number of ports */
 
-	if (nargs != 1) {
-		fprintf(stderr, "%s: no arguments expected\n", args[0]);
+	if (nargs > UES_MAXPORTS + 1) {
+		fprintf(stderr, "%s: at most %d ports\n", args[0],
+				UES_MAXPORTS);
 		fprintf(stderr, "Try '%s --help' for more information\n",
 				args[0]);
 		return 1;
@@ -48,20 +58,40 @@ shellcmd xsh_udpeserver(int nargs, char *args[])
 		return 1;
 	}
 
-	/* register local UDP port */
+	/* register local UDP ports */
 
-	slot = udp_register(0, 0, echoserverport);
-	if (slot == SYSERR) {
-		fprintf(stderr, "%s: could not reserve UDP port %d\n",
-				args[0], echoserverport);
-		return 1;
+	nports = (nargs > 1) ? nargs - 1 : 1;
+	for (i = 0; i < nports; i++) {
+		if (nargs > 1) {
+			echoserverport = atoi(args[i + 1]);
+		}
+		slot = udp_register(0, 0, echoserverport);
+		if (slot == SYSERR) {
+			fprintf(stderr, "%s: could not reserve UDP port %d\n",
+					args[0], echoserverport);
+			while (--i >= 0) {
+				udp_release(evs[i].evid);
+			}
+			return 1;
+		}
+		evs[i].evtype = EV_UDP;
+		evs[i].evid = slot;
 	}
 
-	/* Do forever: read an incoming datagram and send it back */
+	/* Do forever: wait for a datagram on any port and send it back */
 
 	while (TRUE) {
+		i = waitany(evs, nports, 600000);
+		if (i == TIMEOUT) {
+			continue;
+		} else if (i == SYSERR) {
+			fprintf(stderr, "%s: error waiting for UDP\n",
+				args[0]);
+			return 1;
+		}
+		slot = evs[i].evid;
 		retval = udp_recvaddr(slot, &remip, &remport, buff,
-						sizeof(buff), 600000);
+						sizeof(buff), 0);
 
 		if (retval == TIMEOUT) {
 			continue;
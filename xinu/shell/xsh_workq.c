@@ -0,0 +1,65 @@
+/* xsh_workq.c - xsh_workq */
+
+#include <xinu.h>
+#include <stdio.h>
+#include <string.h>
+
+/*------------------------------------------------------------------------
+ * xsh_workq - shell command to print the depth of each work queue and
+ *		the delay jobs spent queued
+ *------------------------------------------------------------------------
+ */
+shellcmd xsh_workq(int nargs, char *args[])
+{
+	struct	workq	*wqptr;		/* Queue being printed		*/
+	int32	q;			/* Index into workqtab		*/
+	uint64	cycles;			/* Ticks jobs spent queued	*/
+	uint32	jobs;			/* Jobs started			*/
+
+	/* For argument '--help', emit help about the 'workq' command	*/
+
+	if (nargs == 2 && strncmp(args[1], "--help", 7) == 0) {
+		printf("Use: %s\n\n", args[0]);
+		printf("Description:\n");
+		printf("\tDisplays the kernel work queues: jobs queued now\n");
+		printf("\tand at most, jobs run and cancelled, and the mean\n");
+		printf("\tand worst TSC ticks from queueing to start\n");
+		printf("Options:\n");
+		printf("\t--help\t display this help and exit\n");
+		return 0;
+	}
+
+	/* Check for valid number of arguments */
+
+	if (nargs > 1) {
+		fprintf(stderr, "%s: too many arguments\n", args[0]);
+		fprintf(stderr, "Try '%s --help' for more information\n",
+				args[0]);
+		return 1;
+	}
+
+	printf("Queue Prio Wrk Depth  Max  Submits     Done Cancels");
+	printf("    Mean       Max\n");
+	printf("----- ---- --- ----- ---- -------- -------- -------");
+	printf(" ------- ---------\n");
+	for (q = 0; q < NWORKQ; q++) {
+		wqptr = &workqtab[q];
+		cycles = wqptr->wqlatsum;
+		jobs = wqptr->wqstarts;
+
+		/* Scale down to 32 bits first; there is no 64-bit	*/
+		/*   division						*/
+
+		while ((cycles >> 32) != 0) {
+			cycles >>= 1;
+			jobs >>= 1;
+		}
+		printf("%5s %4d %3d %5d %4d %8u %8u %7u %7u %9u\n",
+			(q == WQ_HIGH) ? "high" : "low", wqptr->wqprio,
+			wqptr->wqnworkers, wqptr->wqdepth, wqptr->wqmaxdepth,
+			wqptr->wqsubmits, wqptr->wqdone, wqptr->wqcancels,
+			(jobs == 0) ? 0 : (uint32)cycles / jobs,
+			wqptr->wqlatmax);
+	}
+	return 0;
+}
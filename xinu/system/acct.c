@@ -0,0 +1,102 @@
+/* acct.c - acctinit, acctintrenter, acctintrexit, acctswitch, acctcycles */
+
+#include <xinu.h>
+
+uint64	acctintr[NACCTINTR];		/* TSC ticks in each handler	*/
+char	*acctintrname[NACCTINTR] = { "clock", "ether", "tty" };
+uint64	acctlast;			/* TSC at the last switch	*/
+uint64	acctinswitch;			/* Interrupt ticks since then	*/
+
+local	uint64	acctistart;		/* TSC on entry to the handler	*/
+local	int32	acctibucket = -1;	/* Handler being timed, or -1	*/
+
+/*------------------------------------------------------------------------
+ *  acctinit  -  Start charging the null process
+ *------------------------------------------------------------------------
+ */
+void	acctinit(void)
+{
+	acctlast = getticks();
+	acctinswitch = 0;
+}
+
+/*------------------------------------------------------------------------
+ *  acctintrenter  -  Start timing an interrupt handler (interrupts are
+ *		        disabled)
+ *------------------------------------------------------------------------
+ */
+void	acctintrenter(
+	  int32		bucket		/* ACCT_CLK, ACCT_ETH, ...	*/
+	)
+{
+	if (traceon) {			/* Interrupts were on		*/
+		traceirqdrop();
+	}
+	if (acctibucket < 0) {
+		acctibucket = bucket;
+		acctistart = getticks();
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  acctintrexit  -  Charge the handler being timed, if it has not been
+ *		       charged by a context switch already
+ *------------------------------------------------------------------------
+ */
+void	acctintrexit(void)
+{
+	uint64	ticks;			/* Ticks spent in the handler	*/
+
+	if (acctibucket >= 0) {
+		ticks = getticks() - acctistart;
+		acctintr[acctibucket] += ticks;
+		acctinswitch += ticks;
+		acctibucket = -1;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  acctswitch  -  Charge the process being switched out (called from
+ *		     resched with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	acctswitch(
+	  struct procent *ptold,	/* Process leaving the CPU	*/
+	  bool8		preempted	/* Still ready rather than	*/
+					/*   blocked			*/
+	)
+{
+	uint64	now;			/* TSC at the switch		*/
+
+	acctintrexit();
+	now = getticks();
+	ptold->prcycles += (now - acctlast) - acctinswitch;
+	acctlast = now;
+	acctinswitch = 0;
+	if (preempted) {
+		ptold->prnivcsw++;
+	} else {
+		ptold->prnvcsw++;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  acctcycles  -  Ticks a process has run, including the current run
+ *		     if it is the current process
+ *------------------------------------------------------------------------
+ */
+uint64	acctcycles(
+	  pid32		pid		/* Process to look at		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint64	cycles;			/* Ticks charged so far		*/
+
+	mask = disable();
+	cycles = proctab[pid].prcycles;
+	if (pid == currpid) {
+		cycles += (getticks() - acctlast) - acctinswitch;
+	}
+	restore(mask);
+	return cycles;
+}
@@ -0,0 +1,138 @@
+/* bootinfo.c - bootinfo_save, bootinfo_memtop, getbootarg */
+
+#include <xinu.h>
+
+/* Everything below lives in the data segment: bootinfo_save runs	*/
+/*   before start.S clears the bss, and the multiboot information	*/
+/*   block itself may sit in memory that is about to be zeroed		*/
+
+#define	BOOTDATA	__attribute__ ((section (".data")))
+
+uint32	bootmagic BOOTDATA;		/* Signature passed in %eax	*/
+uint32	bootflags BOOTDATA;		/* Multiboot information flags	*/
+char	bootcmdline[BOOTCMDLEN] BOOTDATA; /* Copy of the command line	*/
+uint32	bootmemtop BOOTDATA;		/* End of usable memory that	*/
+					/*   starts at 1M (0 = unknown)	*/
+
+/*------------------------------------------------------------------------
+ * bootinfo_memtop - Find the end of the usable memory region that holds
+ *		       the kernel, from the memory map or from mem_upper
+ *------------------------------------------------------------------------
+ */
+local	uint32	bootinfo_memtop(
+	  struct mbootinfo *mbi		/* Multiboot information block	*/
+	)
+{
+	struct	mbmregion *reg;		/* Walks the memory map		*/
+	uint32	next;			/* Address of the next entry	*/
+	uint32	end;			/* End of the memory map	*/
+	uint64	top;			/* End of the current region	*/
+
+	if (mbi->flags & MULTIBOOT_BOOTINFO_MMAP) {
+		next = mbi->mmap_addr;
+		end = mbi->mmap_addr + mbi->mmap_length;
+		while (next < end) {
+			reg = (struct mbmregion *)next;
+			top = reg->base_addr + reg->length;
+			if (reg->type == MULTIBOOT_MMAP_TYPE_USABLE
+			    && reg->base_addr <= (uint32)HOLEEND
+			    && top > (uint32)HOLEEND) {
+				if (top > 0xFFFFF000) {
+					return 0xFFFFF000;
+				}
+				return (uint32)top;
+			}
+			next += reg->size + sizeof(reg->size);
+		}
+	}
+	if (mbi->flags & MULTIBOOT_BOOFINFO_MEM) {
+		return (uint32)HOLEEND + mbi->mem_upper * 1024;
+	}
+	return 0;
+}
+
+/*------------------------------------------------------------------------
+ * bootinfo_save - Copy the multiboot information that Xinu uses later
+ *		     (called from start.S before the bss is cleared)
+ *------------------------------------------------------------------------
+ */
+void	bootinfo_save(
+	  uint32	magic,		/* Value of %eax at entry	*/
+	  struct mbootinfo *mbi		/* Value of %ebx at entry	*/
+	)
+{
+	char	*from;			/* Walks the boot command line	*/
+	int32	i;			/* Index into bootcmdline	*/
+
+	bootmagic = magic;
+	bootflags = 0;
+	bootcmdline[0] = NULLCH;
+	bootmemtop = 0;
+
+	if (magic != MULTIBOOT_SIGNATURE || mbi == NULL) {
+		return;
+	}
+	bootflags = mbi->flags;
+	bootmemtop = bootinfo_memtop(mbi);
+
+	if (bootflags & MULTIBOOT_BOOTINFO_CMDLINE) {
+		from = (char *)mbi->cmdline;
+		for (i = 0; i < BOOTCMDLEN-1 && from[i] != NULLCH; i++) {
+			bootcmdline[i] = from[i];
+		}
+		bootcmdline[i] = NULLCH;
+	}
+}
+
+/*------------------------------------------------------------------------
+ * getbootarg - Look up "name" or "name=value" on the boot command line
+ *		  and copy the value (empty for a bare name) into buf
+ *------------------------------------------------------------------------
+ */
+status	getbootarg(
+	  char		*name,		/* Argument to look for		*/
+	  char		*buf,		/* Where to place the value	*/
+	  int32		len		/* Size of buf in bytes		*/
+	)
+{
+	char	*p;			/* Start of the current token	*/
+	char	*n;			/* Walks the name being matched	*/
+	int32	i;			/* Index into buf		*/
+
+	p = bootcmdline;
+	while (*p != NULLCH) {
+
+		/* Skip blanks between tokens */
+
+		while (*p == ' ' || *p == '\t') {
+			p++;
+		}
+
+		/* Compare the token name with the requested name */
+
+		for (n = name; *n != NULLCH && *p == *n; n++) {
+			p++;
+		}
+		if (*n == NULLCH && (*p == '=' || *p == ' '
+				|| *p == '\t' || *p == NULLCH)) {
+			if (*p == '=') {
+				p++;
+			}
+			for (i = 0; i < len-1 && *p != NULLCH
+					&& *p != ' ' && *p != '\t'; i++) {
+				buf[i] = *p++;
+			}
+			if (len > 0) {
+				buf[i] = NULLCH;
+			}
+			return OK;
+		}
+
+		/* Move past the rest of the token */
+
+		while (*p != NULLCH && *p != ' ' && *p != '\t') {
+			p++;
+		}
+	}
+	return SYSERR;
+}
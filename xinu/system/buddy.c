@@ -0,0 +1,242 @@
+/* buddy.c - buddyinit, buddyget, buddyfree, buddystat			*/
+
+#include <xinu.h>
+
+struct	buddyord buddytab[NBUDDYORD];	/* Free lists by order		*/
+uint32	buddyavail;			/* Free bytes in the buddy heap	*/
+uint32	buddysplits;			/* Blocks split			*/
+uint32	buddymerges;			/* Buddies merged		*/
+
+local	byte	*buddymap;		/* One bit per 16 bytes: set at	*/
+					/*   the start of a free block	*/
+local	uint32	buddymapsize;		/* Bytes in buddymap		*/
+
+#define	mapbit(a)	((uint32)(a) >> BUDDYMINORD)
+#define	mapisset(a)	(buddymap[mapbit(a) >> 3] & (1 << (mapbit(a) & 7)))
+#define	mapset(a)	(buddymap[mapbit(a) >> 3] |= (1 << (mapbit(a) & 7)))
+#define	mapclr(a)	(buddymap[mapbit(a) >> 3] &= ~(1 << (mapbit(a) & 7)))
+
+/*------------------------------------------------------------------------
+ *  buddyunlink  -  Remove a free block from the list of its order
+ *------------------------------------------------------------------------
+ */
+local	void	buddyunlink(
+	  struct buddyblk *blk		/* Free block			*/
+	)
+{
+	struct	buddyord *boptr;	/* List the block is on		*/
+
+	boptr = &buddytab[blk->border - BUDDYMINORD];
+	if (blk->bprev == NULL) {
+		boptr->bofree = blk->bnext;
+	} else {
+		blk->bprev->bnext = blk->bnext;
+	}
+	if (blk->bnext != NULL) {
+		blk->bnext->bprev = blk->bprev;
+	}
+	boptr->bocount--;
+	mapclr(blk);
+	buddyavail -= 1 << blk->border;
+}
+
+/*------------------------------------------------------------------------
+ *  buddylink  -  Put a free block on the list of its order
+ *------------------------------------------------------------------------
+ */
+local	void	buddylink(
+	  struct buddyblk *blk,		/* Block being freed		*/
+	  uint32	order		/* Its order			*/
+	)
+{
+	struct	buddyord *boptr;	/* List for the order		*/
+
+	boptr = &buddytab[order - BUDDYMINORD];
+	blk->border = order;
+	blk->bprev = NULL;
+	blk->bnext = boptr->bofree;
+	if (boptr->bofree != NULL) {
+		boptr->bofree->bprev = blk;
+	}
+	boptr->bofree = blk;
+	boptr->bocount++;
+	mapset(blk);
+	buddyavail += 1 << order;
+}
+
+/*------------------------------------------------------------------------
+ *  buddyput  -  Free one aligned block, merging it with its buddy for
+ *		   as long as the buddy is free and whole
+ *------------------------------------------------------------------------
+ */
+local	void	buddyput(
+	  uint32	addr,		/* Block address		*/
+	  uint32	order		/* Its order			*/
+	)
+{
+	struct	buddyblk *bud;		/* Buddy of the block		*/
+
+	while (order < BUDDYMAXORD) {
+		bud = (struct buddyblk *)(addr ^ (1 << order));
+		if ((mapbit(bud) >> 3) >= buddymapsize || !mapisset(bud)
+		    || bud->border != order) {
+			break;
+		}
+		buddyunlink(bud);
+		buddymerges++;
+		addr &= ~(1 << order);
+		order++;
+	}
+	buddylink((struct buddyblk *)addr, order);
+}
+
+/*------------------------------------------------------------------------
+ *  buddyrange  -  Free [addr, addr+len) as the largest aligned blocks
+ *		     that tile it
+ *------------------------------------------------------------------------
+ */
+local	void	buddyrange(
+	  uint32	addr,		/* Start, a multiple of 16	*/
+	  uint32	len		/* Length, a multiple of 16	*/
+	)
+{
+	uint32	order;			/* Order of the next block	*/
+
+	while (len > 0) {
+		order = BUDDYMINORD;
+		while (order < BUDDYMAXORD
+		       && (addr & ((2 << order) - 1)) == 0
+		       && (2 << order) <= len) {
+			order++;
+		}
+		buddyput(addr, order);
+		addr += 1 << order;
+		len -= 1 << order;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  buddyinit  -  Move the whole free list into the buddy heap
+ *------------------------------------------------------------------------
+ */
+void	buddyinit(void)
+{
+	struct	memblk	*block, *next;	/* Walks the free list		*/
+	uint32	addr, end;		/* Usable part of a block	*/
+	int32	i;			/* Index into buddymap		*/
+
+	/* The map covers every address up to maxheap */
+
+	buddymapsize = (mapbit(maxheap) >> 3) + 1;
+	buddymap = (byte *)memlistget(buddymapsize);
+	if (buddymap == (byte *)SYSERR) {
+		panic("buddyinit: no memory for the block map");
+	}
+	for (i = 0; i < buddymapsize; i++) {
+		buddymap[i] = 0;
+	}
+
+	block = memlist.mnext;
+	memlist.mnext = NULL;
+	memlist.mlength = 0;
+	while (block != NULL) {
+		next = block->mnext;
+		addr = roundbuddy(block);
+		end = ((uint32)block + block->mlength)
+				& ~((1 << BUDDYMINORD) - 1);
+		if (end > addr) {
+			buddyrange(addr, end - addr);
+		}
+		block = next;
+	}
+	kprintf("Heap: buddy allocator, %d bytes in blocks of %d to %d\n",
+			buddyavail, 1 << BUDDYMINORD, 1 << BUDDYMAXORD);
+}
+
+/*------------------------------------------------------------------------
+ *  buddyget  -  Allocate nbytes from the smallest block that holds them
+ *		   (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+char	*buddyget(
+	  uint32	nbytes		/* Size of memory requested	*/
+	)
+{
+	struct	buddyblk *blk;		/* Block being split		*/
+	uint32	order, want;		/* Order found and needed	*/
+
+	nbytes = roundbuddy(nbytes);
+	if (nbytes == 0 || nbytes > (1 << BUDDYMAXORD)) {
+		return (char *)SYSERR;
+	}
+	want = BUDDYMINORD;
+	while ((1 << want) < nbytes) {
+		want++;
+	}
+	for (order = want; order <= BUDDYMAXORD; order++) {
+		if (buddytab[order - BUDDYMINORD].bofree != NULL) {
+			break;
+		}
+	}
+	if (order > BUDDYMAXORD) {
+		return (char *)SYSERR;
+	}
+	blk = buddytab[order - BUDDYMINORD].bofree;
+	buddyunlink(blk);
+
+	/* Split down, keeping the low half and freeing the high one	*/
+
+	while (order > want) {
+		order--;
+		buddylink((struct buddyblk *)((uint32)blk + (1 << order)),
+								order);
+		buddysplits++;
+	}
+
+	/* Give back the part of the block past the request */
+
+	if (nbytes < (1 << order)) {
+		buddyrange((uint32)blk + nbytes, (1 << order) - nbytes);
+	}
+	return (char *)blk;
+}
+
+/*------------------------------------------------------------------------
+ *  buddyfree  -  Free nbytes at blkaddr (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+status	buddyfree(
+	  char		*blkaddr,	/* Pointer to memory block	*/
+	  uint32	nbytes		/* Size of block in bytes	*/
+	)
+{
+	if (((uint32)blkaddr & ((1 << BUDDYMINORD) - 1)) != 0
+	    || (mapbit(blkaddr) >> 3) >= buddymapsize) {
+		return SYSERR;
+	}
+	buddyrange((uint32)blkaddr, roundbuddy(nbytes));
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  buddystat  -  Free bytes, free blocks and largest free block
+ *------------------------------------------------------------------------
+ */
+void	buddystat(
+	  uint32	*freebytes,	/* Set to the free bytes	*/
+	  uint32	*nblocks,	/* Set to the free blocks	*/
+	  uint32	*largest	/* Set to the largest block	*/
+	)
+{
+	int32	i;			/* Index into buddytab		*/
+
+	*freebytes = buddyavail;
+	*nblocks = 0;
+	*largest = 0;
+	for (i = 0; i < NBUDDYORD; i++) {
+		*nblocks += buddytab[i].bocount;
+		if (buddytab[i].bocount > 0) {
+			*largest = 1 << (i + BUDDYMINORD);
+		}
+	}
+}
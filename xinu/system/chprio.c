@@ -16,13 +16,19 @@ pri16	chprio(
 	pri16	oldprio;		/* Priority to return		*/
 
 	mask = disable();
-	if (isbadpid(pid)) {
+	if (isbadpid(pid) || newprio < 0) {
 		restore(mask);
 		return (pri16) SYSERR;
 	}
 	prptr = &proctab[pid];
-	oldprio = prptr->prprio;
-	prptr->prprio = newprio;
+	oldprio = prptr->prbaseprio;
+	prptr->prbaseprio = newprio;
+
+	/* A process holding a mutex keeps any higher priority it	*/
+	/*   inherits; mutexprio also moves a ready process to the FIFO	*/
+	/*   of its new priority and re-sorts a mutex waiter		*/
+
+	mutexprio(pid, mutexinherit(pid));
 	restore(mask);
 	return oldprio;
 }
@@ -8,32 +8,31 @@
  */
 void	clkhandler()
 {
-	static	uint32	count1000 = 1000;	/* Count to 1000 ms	*/
+	clkirqs++;
 
-	/* Decrement the ms counter, and see if a second has passed */
+	/* Count the ms that has passed, or all of them if the	*/
+	/*   null process had stopped the tick			*/
 
-	if((--count1000) <= 0) {
+	if(clkstopped) {
+		clkwake(TRUE);
+	} else {
+		ctr1000++;
+	}
 
-		/* One second has passed, so increment seconds count */
+	/* See if a second has passed */
 
-		clktime++;
+	if((ctr1000 - clksecond) >= 1000) {
 
-		/* Reset the local ms counter for the next second */
+		/* One second has passed, so increment seconds count */
 
-		count1000 = 1000;
+		clktime++;
+		clksecond += 1000;
 	}
 
-	/* Handle sleeping processes if any exist */
-
-	if(!isempty(sleepq)) {
+	/* Fire the timers that expire on this tick (sleeping	*/
+	/*   processes and receive timeouts among them)		*/
 
-		/* Decrement the delay for the first process on the	*/
-		/*   sleep queue, and awaken if the count reaches zero	*/
-
-		if((--queuetab[firstid(sleepq)].qkey) <= 0) {
-			wakeup();
-		}
-	}
+	tmrtick();
 
 	/* Decrement the preemption counter, and reschedule when the */
 	/*   remaining time reaches zero			     */
@@ -0,0 +1,115 @@
+/* clkidle.c - clkidle, clkwake */
+
+#include <xinu.h>
+#include <icu.h>
+
+bool8	clkstopped;		/* Is a one-shot replacing the tick?	*/
+local	uint32	clkidlems;	/* Length of the one-shot in ms		*/
+
+/*------------------------------------------------------------------------
+ *  clkidle  -  Called by the null process: stop the 1 ms tick until the
+ *		  next timer is due and halt the CPU until an interrupt
+ *------------------------------------------------------------------------
+ */
+void	clkidle(void)
+{
+	intmask	mask;		/* Saved interrupt mask			*/
+	uint32	ms;		/* ms until the wheel next has work	*/
+	uint16	count;		/* One-shot count for the PIT		*/
+
+	mask = disable();
+
+	/* An interrupt other than the clock ended the last idle period	*/
+	/*   without rescheduling; account for it before starting over	*/
+
+	if (clkstopped) {
+		clkwake(FALSE);
+	}
+
+	/* While idle nothing can be preempted, so the only deadline is	*/
+	/*   the earliest timer; skip the one-shot if that is next tick	*/
+
+	ms = tmrnext(CLKIDLEMAX);
+	if (ms > 1) {
+		count = ms * CLKINTV;
+		outb(CLKCNTL, CLK_ONESHOT);
+		outb(CLOCK0, (char) (0xff & count) );
+		outb(CLOCK0, (char) (0xff & (count>>8)));
+		clkidlems = ms;
+		clkstopped = TRUE;
+	}
+
+	pause();		/* Enables interrupts and halts		*/
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  clkwake  -  Add the ms spent in the one-shot to ctr1000 and clktime,
+ *		  and go back to the periodic 1 ms tick (interrupts must
+ *		  be disabled).  On an early wake up the part of a ms that
+ *		  has passed shortens the first period, so no time is lost
+ *------------------------------------------------------------------------
+ */
+void	clkwake(
+	  bool8		expired		/* Called for the one-shot's	*/
+					/*   own interrupt?		*/
+	)
+{
+	uint8	pitstatus;	/* Status byte of timer 0		*/
+	uint32	left;		/* Counts left in the one-shot		*/
+	uint32	elapsed;	/* Counts that have passed		*/
+	uint32	ms;		/* ms that have passed			*/
+	uint16	first;		/* Count of the first periodic tick	*/
+	uint16	intv;		/* Periodic count			*/
+
+	intv = CLKINTV;
+	if (expired) {
+		ms = clkidlems;
+		first = intv;
+	} else {
+
+		/* Latch the one-shot and restart the tick right away; the	*/
+		/*   arithmetic in between is all the tick loses, and	*/
+		/*   CLKWAKEIO accounts for the I/O			*/
+
+		outb(CLKCNTL, CLK_READBACK);
+		pitstatus = inb(CLOCK0);
+		left = inb(CLOCK0) & 0xff;
+		left |= (inb(CLOCK0) & 0xff) << 8;
+		elapsed = clkidlems * CLKINTV;
+		if (!(pitstatus & CLK_OUTHIGH)) {
+			elapsed += CLKWAKEIO - left;
+		}
+		ms = elapsed / CLKINTV;
+		first = CLKINTV - elapsed % CLKINTV;
+	}
+
+	/* Back to the 1 ms rate generator set up by clkinit.  The	*/
+	/*   second count is loaded when the first one runs out		*/
+
+	outb(CLKCNTL, CLK_PERIODIC);
+	outb(CLOCK0, (char) (0xff & first) );
+	outb(CLOCK0, (char) (0xff & (first>>8)));
+	if (first != intv) {
+		outb(CLOCK0, (char) (0xff & intv) );
+		outb(CLOCK0, (char) (0xff & (intv>>8)));
+	}
+
+	/* The one-shot may have run out before it was replaced: its	*/
+	/*   interrupt is then pending, and clkhandler will count that	*/
+	/*   ms as a normal tick					*/
+
+	if (!expired) {
+		outb(OCR, READIRR);
+		if ((inb(OCR) & IRQCLK) && ms > 0) {
+			ms--;
+		}
+	}
+	clkstopped = FALSE;
+
+	ctr1000 += ms;
+	while ((ctr1000 - clksecond) >= 1000) {
+		clktime++;
+		clksecond += 1000;
+	}
+}
@@ -4,20 +4,23 @@
 
 uint32	clktime;		/* Seconds since boot			*/
 uint32	ctr1000 = 0;		/* Milliseconds since boot		*/
-qid16	sleepq;			/* Queue of sleeping processes		*/
+uint32	clksecond;		/* ctr1000 at the last whole second	*/
+bool8	clktickless;		/* Stop the tick while idle?		*/
+uint32	clkirqs;		/* Clock interrupts taken		*/
 uint32	preempt;		/* Preemption counter			*/
 
 /*------------------------------------------------------------------------
- * clkinit  -  Initialize the clock and sleep queue at startup (x86)
+ * clkinit  -  Initialize the clock and timing wheel at startup (x86)
  *------------------------------------------------------------------------
  */
 void	clkinit(void)
 {
 	uint16	intv;		/* Clock rate in KHz			*/
+	char	arg[4];		/* Value of the tickless boot argument	*/
 
-	/* Allocate a queue to hold the delta list of sleeping processes*/
+	/* Empty the timing wheel used for sleeping processes	*/
 
-	sleepq = newqueue();
+	tmrinit();
 
 	/* Initialize the preemption count */
 
@@ -26,6 +29,13 @@ void	clkinit(void)
 	/* Initialize the time since boot to zero */
 
 	clktime = 0;
+	clksecond = ctr1000;
+
+	/* With "tickless" on the boot command line, the null process	*/
+	/*   replaces the tick with a one-shot up to the next timer	*/
+
+	clktickless = (getbootarg("tickless", arg, sizeof(arg)) == OK);
+	clkstopped = FALSE;
 
 	/* Set interrupt vector for the clock to invoke clkdisp */
 
@@ -34,11 +44,11 @@ void	clkinit(void)
 	/* Set the hardware clock: timer 0, 16-bit counter, rate */
 	/*   generator mode, and counter runs in binary		 */
 
-	outb(CLKCNTL, 0x34);
+	outb(CLKCNTL, CLK_PERIODIC);
 
 	/* Set the clock rate to 1.190 Mhz; this is 1 ms interrupt rate */
 
-	intv = 1193;	/* Using 1193 instead of 1190 to fix clock skew	*/
+	intv = CLKINTV;	/* Using 1193 instead of 1190 to fix clock skew	*/
 
 	/* Must write LSB first, then MSB */
 
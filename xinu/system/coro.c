@@ -0,0 +1,482 @@
+/* coro.c - coinit, cocreate, corun, codone, coreclaim, coyield,	*/
+/*	    cosleep, cowait, corecvtime, coudprecv			*/
+
+#include <xinu.h>
+
+struct	cosched	**cosched;		/* Scheduler of each process	*/
+struct	coown	*coown;			/* Storage of each scheduler	*/
+
+/*------------------------------------------------------------------------
+ *  coready  -  Append a coroutine to the ready list
+ *------------------------------------------------------------------------
+ */
+local	void	coready(
+	  struct cosched *cs,		/* Scheduler of the coroutine	*/
+	  struct coro	*co		/* Coroutine to make ready	*/
+	)
+{
+	co->costate = CO_READY;
+	co->conext = NULL;
+	if (cs->coreadytail == NULL) {
+		cs->coready = co;
+	} else {
+		cs->coreadytail->conext = co;
+	}
+	cs->coreadytail = co;
+}
+
+/*------------------------------------------------------------------------
+ *  costart  -  First code run by a coroutine: call its function and,
+ *		  when that returns, go back to corun for good
+ *------------------------------------------------------------------------
+ */
+local	void	costart(void)
+{
+	struct	cosched	*cs = cosched[currpid];
+	struct	coro	*co = cs->cocurr;
+
+	co->cofunc(co->coarg);
+	co->costate = CO_DEAD;		/* corun frees the stack	*/
+	coswitch(&co->cosp, cs->cosp);
+}
+
+/*------------------------------------------------------------------------
+ *  coinit  -  Set up a scheduler for up to maxcoro coroutines with
+ *		 stacks of stksize bytes (0 for COSTK)
+ *------------------------------------------------------------------------
+ */
+status	coinit(
+	  struct cosched *cs,		/* Scheduler to set up		*/
+	  int32		maxcoro,	/* Most coroutines at once	*/
+	  uint32	stksize		/* Stack size of each		*/
+	)
+{
+	int32	i;			/* Index into cotab		*/
+
+	if (stksize == 0) {
+		stksize = COSTK;
+	}
+	if (maxcoro <= 0 || stksize < COMINSTK) {
+		return SYSERR;
+	}
+	cs->cotab = (struct coro *)getmem(maxcoro * sizeof(struct coro));
+	if ((int32)cs->cotab == SYSERR) {
+		return SYSERR;
+	}
+	cs->comax = maxcoro;
+	cs->costklen = stksize;
+	cs->cofree = NULL;
+	for (i = maxcoro - 1; i >= 0; i--) {
+		cs->cotab[i].costate = CO_FREE;
+		cs->cotab[i].conext = cs->cofree;
+		cs->cofree = &cs->cotab[i];
+	}
+	cs->coready = cs->coreadytail = NULL;
+	cs->cowaiting = NULL;
+	cs->cocurr = NULL;
+	cs->colive = 0;
+	cs->coswitches = cs->coblocks = 0;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  cocreate  -  Create a ready coroutine that calls func(arg) and
+ *		   return its index in the table
+ *------------------------------------------------------------------------
+ */
+int32	cocreate(
+	  struct cosched *cs,		/* Scheduler to add it to	*/
+	  void		(*func)(int32),	/* Function to run		*/
+	  int32		arg		/* Argument passed to func	*/
+	)
+{
+	struct	coro	*co;		/* Table entry for the new one	*/
+	char	*stk;			/* Its stack			*/
+	uint32	*sp;			/* Builds the initial frame	*/
+
+	co = cs->cofree;
+	if (co == NULL) {
+		return SYSERR;
+	}
+	stk = getmem(cs->costklen);
+	if ((int32)stk == SYSERR) {
+		return SYSERR;
+	}
+	cs->cofree = co->conext;
+
+	/* Make the stack look as if coswitch had saved it on the way	*/
+	/*   into costart						*/
+
+	sp = (uint32 *)(((uint32)stk + cs->costklen) & ~0xF);
+	*--sp = 0;			/* costart never returns	*/
+	*--sp = (uint32)costart;	/* Return address of coswitch	*/
+	*--sp = 0;			/* %ebp				*/
+	*--sp = 0;			/* %ebx				*/
+	*--sp = 0;			/* %esi				*/
+	*--sp = 0;			/* %edi				*/
+
+	co->cosp = sp;
+	co->costk = stk;
+	co->cofunc = func;
+	co->coarg = arg;
+	cs->colive++;
+	coready(cs, co);
+	return co - cs->cotab;
+}
+
+/*------------------------------------------------------------------------
+ *  copoll  -  Make ready every waiting coroutine whose event is ready
+ *		 (taking a semaphore count for it) or whose time is up
+ *------------------------------------------------------------------------
+ */
+local	void	copoll(
+	  struct cosched *cs		/* Scheduler to poll		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	coro	*co;		/* Coroutine being checked	*/
+	struct	coro	**prev;		/* Link that points to co	*/
+
+	mask = disable();
+	prev = &cs->cowaiting;
+	while ((co = *prev) != NULL) {
+		if (co->coev.evtype != EV_NONE && evready(&co->coev)) {
+			if (co->coev.evtype == EV_SEM) {
+				semtab[co->coev.evid].scount--;
+			}
+			co->coresult = OK;
+		} else if (co->cotimed && (int32)(ctr1000 - co->codue) >= 0) {
+			co->coresult = TIMEOUT;
+		} else {
+			prev = &co->conext;
+			continue;
+		}
+		*prev = co->conext;
+		coready(cs, co);
+	}
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  coblock  -  Block the process until an event some coroutine waits
+ *		  for is ready or the earliest timeout passes
+ *------------------------------------------------------------------------
+ */
+local	void	coblock(
+	  struct cosched *cs		/* Scheduler with no ready one	*/
+	)
+{
+	struct	evwait	evs[EV_MAX];	/* Distinct events waited for	*/
+	int32	nevs = 0;		/* Entries in evs		*/
+	int32	maxwait = -1;		/* Time to the earliest timeout	*/
+	int32	left;			/* Time left for one coroutine	*/
+	struct	coro	*co;		/* Coroutine being checked	*/
+	struct	coro	**prev;		/* Link that points to co	*/
+	struct	coro	**match;	/* Link to the oldest waiter on	*/
+					/*   the semaphore waitany took	*/
+	int32	i;			/* Index into evs		*/
+
+	for (co = cs->cowaiting; co != NULL; co = co->conext) {
+		if (co->cotimed) {
+			left = (int32)(co->codue - ctr1000);
+			if (left < 0) {
+				left = 0;
+			}
+			if (maxwait < 0 || left < maxwait) {
+				maxwait = left;
+			}
+		}
+		if (co->coev.evtype == EV_NONE) {
+			continue;
+		}
+		for (i = 0; i < nevs; i++) {
+			if (evs[i].evtype == co->coev.evtype
+			    && evs[i].evid == co->coev.evid) {
+				break;
+			}
+		}
+		if (i < nevs) {
+			continue;
+		}
+		if (nevs == EV_MAX) {	/* Too many: poll every ms	*/
+			maxwait = (maxwait < 0 || maxwait > 1) ? 1 : maxwait;
+			continue;
+		}
+		evs[nevs++] = co->coev;
+	}
+
+	cs->coblocks++;
+	if (nevs == 0) {
+		if (maxwait > 0) {
+			sleepms(maxwait);
+		}
+		return;
+	}
+	i = waitany(evs, nevs, maxwait);
+	if (i < 0 || evs[i].evtype != EV_SEM) {
+		return;
+	}
+
+	/* The count waitany took goes straight to the coroutine that	*/
+	/*   has waited longest on the semaphore (the list is newest	*/
+	/*   first); signaling it back could hand it to another process	*/
+
+	match = NULL;
+	for (prev = &cs->cowaiting; (co = *prev) != NULL;
+	     prev = &co->conext) {
+		if (co->coev.evtype == EV_SEM
+		    && co->coev.evid == evs[i].evid) {
+			match = prev;
+		}
+	}
+	co = *match;
+	*match = co->conext;
+	co->coresult = OK;
+	coready(cs, co);
+}
+
+/*------------------------------------------------------------------------
+ *  corun  -  Run the coroutines of a scheduler in the calling process
+ *		until all of them have returned
+ *------------------------------------------------------------------------
+ */
+status	corun(
+	  struct cosched *cs		/* Scheduler to run		*/
+	)
+{
+	struct	coro	*co;		/* Coroutine being run		*/
+	struct	coro	*next;		/* Next in this pass		*/
+
+	if (cosched[currpid] != NULL) {	/* No nesting			*/
+		return SYSERR;
+	}
+	cosched[currpid] = cs;
+	coown[currpid].cotab = cs->cotab;
+	coown[currpid].comax = cs->comax;
+	coown[currpid].costklen = cs->costklen;
+	while (cs->colive > 0) {
+		copoll(cs);
+		if (cs->coready == NULL) {
+			coblock(cs);
+			continue;
+		}
+
+		/* Run each ready coroutine once; those that yield go	*/
+		/*   on the list for the next pass			*/
+
+		co = cs->coready;
+		cs->coready = cs->coreadytail = NULL;
+		for (; co != NULL; co = next) {
+			next = co->conext;
+			co->costate = CO_CURR;
+			cs->cocurr = co;
+			cs->coswitches++;
+			coswitch(&cs->cosp, co->cosp);
+			cs->cocurr = NULL;
+			if (co->costate == CO_DEAD) {
+				freemem(co->costk, cs->costklen);
+				co->costate = CO_FREE;
+				co->conext = cs->cofree;
+				cs->cofree = co;
+				cs->colive--;
+			}
+		}
+	}
+	cosched[currpid] = NULL;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  codone  -  Release the table of a scheduler whose coroutines have
+ *		 all returned
+ *------------------------------------------------------------------------
+ */
+status	codone(
+	  struct cosched *cs		/* Scheduler to release		*/
+	)
+{
+	if (cs->colive > 0) {
+		return SYSERR;
+	}
+	return freemem((char *)cs->cotab, cs->comax * sizeof(struct coro));
+}
+
+/*------------------------------------------------------------------------
+ *  coreclaim  -  Free the coroutine stacks and table of a process that
+ *		    is killed inside corun; only coown is used, since the
+ *		    scheduler itself may be on the process's private stack
+ *		    (called from kill and oom_kill with interrupts disabled)
+ *------------------------------------------------------------------------
+ */
+void	coreclaim(
+	  pid32		pid		/* ID of process being removed	*/
+	)
+{
+	struct	coown	*own = &coown[pid];
+	int32	i;			/* Index into cotab		*/
+
+	if (cosched[pid] == NULL) {
+		return;
+	}
+	cosched[pid] = NULL;
+	for (i = 0; i < own->comax; i++) {
+		if (own->cotab[i].costate != CO_FREE) {
+			freemem(own->cotab[i].costk, own->costklen);
+		}
+	}
+	freemem((char *)own->cotab, own->comax * sizeof(struct coro));
+}
+
+/*------------------------------------------------------------------------
+ *  coyield  -  Let the other ready coroutines run
+ *------------------------------------------------------------------------
+ */
+status	coyield(void)
+{
+	struct	cosched	*cs = cosched[currpid];
+	struct	coro	*co;		/* Coroutine yielding		*/
+
+	if (cs == NULL || (co = cs->cocurr) == NULL) {
+		return SYSERR;
+	}
+	coready(cs, co);
+	coswitch(&co->cosp, cs->cosp);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  cowait  -  Park the current coroutine until an event is ready
+ *		 (taking one count of an EV_SEM) or maxwait msec pass.
+ *		 ev may be NULL to sleep; maxwait 0 polls and a negative
+ *		 maxwait waits forever.  Returns OK or TIMEOUT
+ *------------------------------------------------------------------------
+ */
+int32	cowait(
+	  struct evwait	*ev,		/* Event, or NULL		*/
+	  int32		maxwait		/* Timeout in msec		*/
+	)
+{
+	struct	cosched	*cs = cosched[currpid];
+	struct	coro	*co;		/* Coroutine waiting		*/
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	if (cs == NULL || (co = cs->cocurr) == NULL
+	    || (ev == NULL && maxwait < 0)) {
+		return SYSERR;
+	}
+
+	/* Take an event that is ready without switching */
+
+	if (ev != NULL) {
+		mask = disable();
+		if (evbad(ev)) {
+			restore(mask);
+			return SYSERR;
+		}
+		if (evready(ev)) {
+			if (ev->evtype == EV_SEM) {
+				semtab[ev->evid].scount--;
+			}
+			restore(mask);
+			return OK;
+		}
+		restore(mask);
+		co->coev = *ev;
+	} else {
+		co->coev.evtype = EV_NONE;
+	}
+	if (maxwait == 0) {
+		return TIMEOUT;
+	}
+
+	co->cotimed = (maxwait > 0);
+	co->codue = ctr1000 + maxwait;
+	co->costate = CO_WAIT;
+	co->conext = cs->cowaiting;
+	cs->cowaiting = co;
+	coswitch(&co->cosp, cs->cosp);
+	return co->coresult;
+}
+
+/*------------------------------------------------------------------------
+ *  cosleep  -  Park the current coroutine for delay msec
+ *------------------------------------------------------------------------
+ */
+status	cosleep(
+	  int32		delay		/* Time to sleep in msec	*/
+	)
+{
+	if (delay <= 0) {
+		return coyield();
+	}
+	return (cowait(NULL, delay) == SYSERR) ? SYSERR : OK;
+}
+
+/*------------------------------------------------------------------------
+ *  corecvtime  -  Receive a message for the process, parking only the
+ *		     current coroutine while none is waiting
+ *------------------------------------------------------------------------
+ */
+umsg32	corecvtime(
+	  int32		maxwait		/* Timeout in msec, <0: forever	*/
+	)
+{
+	struct	evwait	ev;		/* The process's message	*/
+	uint32	due = ctr1000 + maxwait;/* When to give up		*/
+	umsg32	msg;			/* Message received		*/
+	int32	left;			/* Time left to wait		*/
+
+	ev.evtype = EV_MSG;
+	ev.evid = currpid;
+	while (TRUE) {
+		msg = recvtime(0);
+		if (msg != TIMEOUT) {
+			return msg;
+		}
+
+		/* Another coroutine may take the message first */
+
+		left = (maxwait < 0) ? -1 : (int32)(due - ctr1000);
+		if (maxwait >= 0 && left <= 0) {
+			return TIMEOUT;
+		}
+		if (cowait(&ev, left) != OK) {
+			return TIMEOUT;
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  coudprecv  -  Receive a UDP datagram, parking only the current
+ *		    coroutine while the slot is empty
+ *------------------------------------------------------------------------
+ */
+int32	coudprecv(
+	  uid32		slot,		/* Slot in table to use		*/
+	  char		*buff,		/* Buffer to hold UDP data	*/
+	  int32		len,		/* Length of buffer		*/
+	  int32		timeout		/* Timeout in msec, <0: forever	*/
+	)
+{
+	struct	evwait	ev;		/* The slot's queue		*/
+	uint32	due = ctr1000 + timeout;/* When to give up		*/
+	int32	retval;			/* Length or TIMEOUT		*/
+	int32	left;			/* Time left to wait		*/
+
+	ev.evtype = EV_UDP;
+	ev.evid = slot;
+	while (TRUE) {
+		retval = udp_recv(slot, buff, len, 0);
+		if (retval != TIMEOUT) {
+			return retval;
+		}
+		left = (timeout < 0) ? -1 : (int32)(due - ctr1000);
+		if (timeout >= 0 && left <= 0) {
+			return TIMEOUT;
+		}
+		retval = cowait(&ev, left);
+		if (retval != OK) {
+			return retval;
+		}
+	}
+}
@@ -1,7 +1,14 @@
-/* create.c - create, newpid */
+/* create.c - create, newpid, freepid */
 
 #include <xinu.h>
 
+/* Free process IDs are kept in a FIFO list linked through prnextfree,	*/
+/*   so an ID is reused as late as possible, like the old round-robin	*/
+/*   search of the table did					*/
+
+local	pid32	pidfirst = EMPTY;	/* Next ID newpid hands out	*/
+local	pid32	pidlast = EMPTY;	/* Last ID freed		*/
+
 /*------------------------------------------------------------------------
  *  create  -  Create a process to start running a function on x86
  *------------------------------------------------------------------------
@@ -38,14 +45,22 @@ pid32	create(
 	/* Initialize process table entry for new process */
 	prptr->prstate = PR_SUSP;	/* Initial state is suspended	*/
 	prptr->prprio = priority;
+	prptr->prbaseprio = priority;
 	prptr->prstklen = ssize;
 	prptr->prname[PNMLEN-1] = NULLCH;
 	for (i=0 ; i<PNMLEN-1 && (prptr->prname[i]=name[i])!=NULLCH; i++)
 		;
 	prptr->prsem = -1;
+	prptr->prmutex = -1;
+	prptr->prmheld = EMPTY;
 	prptr->prparent = (pid32)getpid();
 	prptr->prhasmsg = FALSE;
 	prptr->pruser   = FALSE;
+	prptr->prfair   = FALSE;
+	prptr->prcycles = prptr->prsvccyc = 0;
+	prptr->prnvcsw  = prptr->prnivcsw = 0;
+	prptr->prwaketsc = 0;
+	prptr->prfpuused = FALSE;
 
 	/* Set up stdin, stdout, and stderr descriptors for the shell	*/
 	prptr->prdesc[0] = CONSOLE;
@@ -56,6 +71,9 @@ pid32	create(
    prptr->pdbr     = proctab[0].pdbr;
    prptr->hsize    = 0;
    prptr->vfree    = 0;
+   prptr->nffs     = prptr->nswap   = 0;
+   prptr->npt      = prptr->nstk    = 0;
+   prptr->nfaults  = prptr->nevicts = 0;
 
 	/* Initialize stack as if the process was called		*/
 
@@ -105,23 +123,38 @@ pid32	create(
 
 /*------------------------------------------------------------------------
  *  newpid  -  Obtain a new (free) process ID
+ *		 (assumes interrupts are disabled)
  *------------------------------------------------------------------------
  */
 pid32	newpid(void)
 {
-	uint32	i;			/* Iterate through all processes*/
-	static	pid32 nextpid = 1;	/* Position in table to try or	*/
-					/*   one beyond end of table	*/
-
-	/* Check all NPROC slots */
-
-	for (i = 0; i < NPROC; i++) {
-		nextpid %= NPROC;	/* Wrap around to beginning */
-		if (proctab[nextpid].prstate == PR_FREE) {
-			return nextpid++;
-		} else {
-			nextpid++;
-		}
+	pid32	pid;			/* ID to return			*/
+
+	if ((pid = pidfirst) == EMPTY) {
+		return (pid32) SYSERR;
+	}
+	pidfirst = proctab[pid].prnextfree;
+	if (pidfirst == EMPTY) {
+		pidlast = EMPTY;
+	}
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  freepid  -  Mark a process table entry free and put its ID at the
+ *		  end of the free list (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	freepid(
+	  pid32		pid		/* ID of the entry to free	*/
+	)
+{
+	proctab[pid].prstate = PR_FREE;
+	proctab[pid].prnextfree = EMPTY;
+	if (pidlast == EMPTY) {
+		pidfirst = pid;
+	} else {
+		proctab[pidlast].prnextfree = pid;
 	}
-	return (pid32) SYSERR;
+	pidlast = pid;
 }
@@ -0,0 +1,248 @@
+/* fairsched.c - fairinit, fairinsert, fairremove, fairdequeue,	*/
+/*		   faircharge, fairkeep					*/
+
+#include <xinu.h>
+#include <stdlib.h>
+
+bool8	fairenabled;			/* Do user processes use it?	*/
+pri16	fairprio;			/* Priority of the class	*/
+int32	nfair;				/* Processes in the heap	*/
+uint32	fairvtime;			/* Pass of the last one picked	*/
+
+local	pid32	*fairheap;		/* Ready fair processes, a heap	*/
+					/*   with the least pass first	*/
+local	int32	*fairpos;		/* Index of each in fairheap	*/
+
+#define	fairpass(i)	(proctab[fairheap[i]].prpass)
+
+/*------------------------------------------------------------------------
+ *  fairinit  -  Initialize the fair-share class from the boot arguments
+ *		   (called after tabinit has sized the process table)
+ *------------------------------------------------------------------------
+ */
+void	fairinit(void)
+{
+	char	arg[8];			/* Value of the fair argument	*/
+
+	fairheap = (pid32 *)tabget(nproc * sizeof(pid32));
+	fairpos = (int32 *)tabget(nproc * sizeof(int32));
+	nfair = 0;
+	fairvtime = 0;
+	fairprio = FAIRPRIO;
+	fairenabled = (getbootarg("fair", arg, sizeof(arg)) == OK);
+	if (fairenabled) {
+		if (arg[0] != NULLCH && atoi(arg) > 0) {
+			fairprio = atoi(arg);
+		}
+		kprintf("Fair-share class for user processes at priority %d\n",
+								fairprio);
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  fairset  -  Put a process at index i of the heap
+ *------------------------------------------------------------------------
+ */
+local	void	fairset(
+	  int32		i,		/* Index into fairheap		*/
+	  pid32		pid		/* Process to put there		*/
+	)
+{
+	fairheap[i] = pid;
+	fairpos[pid] = i;
+}
+
+/*------------------------------------------------------------------------
+ *  fairup  -  Move the entry at index i toward the root while its pass
+ *		 is less than its parent's
+ *------------------------------------------------------------------------
+ */
+local	void	fairup(
+	  int32		i		/* Index into fairheap		*/
+	)
+{
+	pid32	pid = fairheap[i];	/* Process being moved		*/
+	int32	parent;			/* Index of i's parent		*/
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (fairpass(parent) <= proctab[pid].prpass) {
+			break;
+		}
+		fairset(i, fairheap[parent]);
+		i = parent;
+	}
+	fairset(i, pid);
+}
+
+/*------------------------------------------------------------------------
+ *  fairdown  -  Move the entry at index i toward the leaves while a
+ *		   child has a lesser pass
+ *------------------------------------------------------------------------
+ */
+local	void	fairdown(
+	  int32		i		/* Index into fairheap		*/
+	)
+{
+	pid32	pid = fairheap[i];	/* Process being moved		*/
+	int32	child;			/* Index of i's lesser child	*/
+
+	while ((child = 2 * i + 1) < nfair) {
+		if (child + 1 < nfair && fairpass(child + 1) < fairpass(child)) {
+			child++;
+		}
+		if (proctab[pid].prpass <= fairpass(child)) {
+			break;
+		}
+		fairset(i, fairheap[child]);
+		i = child;
+	}
+	fairset(i, pid);
+}
+
+/*------------------------------------------------------------------------
+ *  fairrenorm  -  Shift every fair process's pass back by fairvtime so
+ *		     that passes stay far from overflowing
+ *------------------------------------------------------------------------
+ */
+local	void	fairrenorm(void)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	pid32	pid;			/* Process being shifted	*/
+
+	/* Clamping keeps the order, so the heap stays valid	*/
+
+	for (pid = 0; pid < nproc; pid++) {
+		prptr = &proctab[pid];
+		if (prptr->prstate == PR_FREE || !prptr->prfair) {
+			continue;
+		}
+		if (prptr->prpass > fairvtime) {
+			prptr->prpass -= fairvtime;
+		} else {
+			prptr->prpass = 0;
+		}
+	}
+	fairvtime = 0;
+}
+
+/*------------------------------------------------------------------------
+ *  fairinsert  -  Add a fair process to the heap (assumes interrupts
+ *		     are disabled)
+ *------------------------------------------------------------------------
+ */
+status	fairinsert(
+	  pid32		pid		/* ID of process to insert	*/
+	)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+
+	/* A process that was blocked gets no credit for the time it	*/
+	/*   did not run: it starts level with the class		*/
+
+	prptr = &proctab[pid];
+	if (prptr->prpass < fairvtime) {
+		prptr->prpass = fairvtime;
+	}
+	fairset(nfair++, pid);
+	fairup(nfair - 1);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  fairremove  -  Remove a fair process from the heap
+ *------------------------------------------------------------------------
+ */
+pid32	fairremove(
+	  pid32		pid		/* ID of process to remove	*/
+	)
+{
+	int32	i = fairpos[pid];	/* Where pid is in the heap	*/
+	pid32	last;			/* Process moved into its place	*/
+
+	nfair--;
+	if (i < nfair) {
+		last = fairheap[nfair];
+		fairset(i, last);
+		fairup(i);
+		fairdown(fairpos[last]);
+	}
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  fairdequeue  -  Remove and return the fair process with least pass
+ *------------------------------------------------------------------------
+ */
+pid32	fairdequeue(void)
+{
+	pid32	pid;			/* Process picked		*/
+
+	pid = fairheap[0];
+	fairremove(pid);
+	if (proctab[pid].prpass > fairvtime) {
+		fairvtime = proctab[pid].prpass;
+	}
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  faircharge  -  Add the CPU time used since the last charge, read
+ *		     from the TSC, to the pass of a fair process
+ *------------------------------------------------------------------------
+ */
+void	faircharge(
+	  pid32		pid		/* ID of process to charge	*/
+	)
+{
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	uint32	weight;			/* Share weight from prprio	*/
+	uint32	vtime;			/* Least pass that can run	*/
+	uint64	now;			/* TSC at the charge		*/
+	uint64	units;			/* 2^FAIRSHIFT ticks used	*/
+
+	prptr = &proctab[pid];
+	weight = prptr->prprio;
+	if (weight < 1) {
+		weight = 1;
+	}
+
+	/* Ticks below a whole unit (about a microsecond) stay in	*/
+	/*   prstart for the next charge				*/
+
+	now = getticks();
+	units = (now - prptr->prstart) >> FAIRSHIFT;
+	prptr->prstart += units << FAIRSHIFT;
+	if (units > FAIRMAXUNITS) {
+		units = FAIRMAXUNITS;
+	}
+	prptr->prpass += (uint32)units * FAIRSTRIDE / weight;
+
+	/* The class's virtual time follows the least pass among the	*/
+	/*   process that ran and the ready ones			*/
+
+	vtime = prptr->prpass;
+	if (nfair > 0 && fairpass(0) < vtime) {
+		vtime = fairpass(0);
+	}
+	if (vtime > fairvtime) {
+		fairvtime = vtime;
+	}
+	if (prptr->prpass >= FAIRRENORM) {
+		fairrenorm();
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  fairkeep  -  Should the current (fair) process keep the CPU?
+ *------------------------------------------------------------------------
+ */
+bool8	fairkeep(
+	  pid32		pid		/* ID of the current process	*/
+	)
+{
+	if (readystrictkey() >= fairprio) {
+		return FALSE;
+	}
+	return (nfair == 0) || (proctab[pid].prpass <= fairpass(0));
+}
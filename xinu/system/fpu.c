@@ -0,0 +1,137 @@
+/* fpu.c - fpuinit, fpuhandler, fpuswitch, fpurelease, fpukernel,	*/
+/*	   fpukerneldone						*/
+
+#include <xinu.h>
+
+bool8	fpuenabled;			/* Can processes use x87/SSE?	*/
+pid32	fpuowner = FPU_NONE;		/* Whose state is loaded	*/
+uint32	fpusaves;			/* FXSAVEs by the trap handler	*/
+uint32	fpurestores;			/* FXRSTORs by the trap handler	*/
+
+local	bool8	fputrap;		/* Is CR0.TS set?		*/
+local	byte	fpuclean[FXSAVESIZE]	/* State a process starts with	*/
+			__attribute__ ((aligned (16)));
+
+/*------------------------------------------------------------------------
+ *  fpuinit  -  Let processes use x87 and SSE when the CPU has FXSAVE:
+ *		  turn off emulation, enable FXSAVE and SSE in CR4, save
+ *		  a clean state, and install the trap handler
+ *------------------------------------------------------------------------
+ */
+void	fpuinit(void)
+{
+	uint32	mxcsr = MXCSR_DEFAULT;	/* SSE control and status	*/
+
+	if (!(cpuid() & CPUID_FXSR)) {
+		kprintf("FPU: no FXSAVE, processes must not use x87/SSE\n");
+		return;
+	}
+	write_cr0((read_cr0() & ~(CR0_EM | CR0_TS)) | CR0_MP | CR0_NE);
+	write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+	asm volatile ("fninit");
+	asm volatile ("ldmxcsr %0" : : "m" (mxcsr));
+	asm volatile ("fxsave %0" : "=m" (fpuclean));
+	set_evec(IRQFPU, (uint32)fpudisp);
+
+	/* Nobody owns the registers yet, so the first use must trap	*/
+
+	write_cr0(read_cr0() | CR0_TS);
+	fputrap = TRUE;
+	fpuenabled = TRUE;
+}
+
+/*------------------------------------------------------------------------
+ *  fpuhandler  -  Device-not-available trap: save the owner's registers
+ *		     and load those of the current process
+ *------------------------------------------------------------------------
+ */
+void	fpuhandler(void)
+{
+	struct	procent	*prptr;		/* Current process		*/
+
+	if (!fpuenabled) {
+		panic("FPU instruction without FXSAVE support");
+	}
+	asm volatile ("clts");
+	fputrap = FALSE;
+	if (fpuowner == currpid) {
+		return;
+	}
+	if (fpuowner != FPU_NONE) {
+		asm volatile ("fxsave %0" : "=m" (proctab[fpuowner].prfxsave));
+		fpusaves++;
+	}
+	prptr = &proctab[currpid];
+	if (prptr->prfpuused) {
+		asm volatile ("fxrstor %0" : : "m" (prptr->prfxsave));
+		fpurestores++;
+	} else {
+		asm volatile ("fxrstor %0" : : "m" (fpuclean));
+		prptr->prfpuused = TRUE;
+	}
+	fpuowner = currpid;
+}
+
+/*------------------------------------------------------------------------
+ *  fpuswitch  -  Called by resched for the process about to run: only
+ *		    the owner may touch the registers without a trap
+ *------------------------------------------------------------------------
+ */
+void	fpuswitch(
+	  pid32		pid		/* Process about to run		*/
+	)
+{
+	bool8	ts = (pid != fpuowner);	/* Must its FPU use trap?	*/
+
+	if (ts != fputrap) {
+		if (ts) {
+			write_cr0(read_cr0() | CR0_TS);
+		} else {
+			asm volatile ("clts");
+		}
+		fputrap = ts;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  fpurelease  -  Forget the FPU state of a process that is terminating
+ *		     (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	fpurelease(
+	  pid32		pid		/* Process being killed		*/
+	)
+{
+	if (fpuowner == pid) {
+		fpuowner = FPU_NONE;
+	}
+	proctab[pid].prfpuused = FALSE;
+}
+
+/*------------------------------------------------------------------------
+ *  fpukernel  -  Let kernel code use SSE registers: save the owner's
+ *		    state so the next use by a process reloads it
+ *		    (interrupts are disabled until fpukerneldone)
+ *------------------------------------------------------------------------
+ */
+void	fpukernel(void)
+{
+	asm volatile ("clts");
+	fputrap = FALSE;
+	if (fpuowner != FPU_NONE) {
+		asm volatile ("fxsave %0" : "=m" (proctab[fpuowner].prfxsave));
+		fpusaves++;
+		fpuowner = FPU_NONE;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  fpukerneldone  -  End of kernel SSE use: the registers belong to
+ *		        nobody, so the next process use traps
+ *------------------------------------------------------------------------
+ */
+void	fpukerneldone(void)
+{
+	write_cr0(read_cr0() | CR0_TS);
+	fputrap = TRUE;
+}
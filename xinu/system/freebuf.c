@@ -1,4 +1,4 @@
-/* freebuf.c - freebuf */
+/* freebuf.c - freebuf, freebufs */
 
 #include <xinu.h>
 
@@ -33,7 +33,57 @@ syscall	freebuf(
 
 	((struct bpentry *)bufaddr)->bpnext = bpptr->bpnext;
 	bpptr->bpnext = (struct bpentry *)bufaddr;
+	bpptr->bpinuse--;
 	signal(bpptr->bpsem);
 	restore(mask);
 	return OK;
 }
+
+/*------------------------------------------------------------------------
+ *  freebufs  -  Free count buffers, signaling each pool once per run of
+ *		   buffers from it
+ *------------------------------------------------------------------------
+ */
+syscall	freebufs(
+	  char		*bufs[],	/* Buffers to return		*/
+	  int32		count		/* Number of buffers		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	bpid32	poolid;			/* ID of a buffer's pool	*/
+	bpid32	runpool = -1;		/* Pool of the current run	*/
+	int32	runlen = 0;		/* Buffers freed in the run	*/
+	char	*bufaddr;		/* Buffer being freed		*/
+	status	retval = OK;		/* Value to return		*/
+	int32	i;			/* Index into bufs		*/
+
+	mask = disable();
+	resched_cntl(DEFER_START);
+	for (i = 0; i < count; i++) {
+		bufaddr = bufs[i] - sizeof(bpid32);
+		poolid = *(bpid32 *)bufaddr;
+		if (poolid < 0  ||  poolid >= nbpools) {
+			retval = SYSERR;
+			continue;
+		}
+		if (poolid != runpool) {
+			if (runlen > 0) {
+				signaln(buftab[runpool].bpsem, runlen);
+			}
+			runpool = poolid;
+			runlen = 0;
+		}
+		bpptr = &buftab[poolid];
+		((struct bpentry *)bufaddr)->bpnext = bpptr->bpnext;
+		bpptr->bpnext = (struct bpentry *)bufaddr;
+		bpptr->bpinuse--;
+		runlen++;
+	}
+	if (runlen > 0) {
+		signaln(buftab[runpool].bpsem, runlen);
+	}
+	resched_cntl(DEFER_STOP);
+	restore(mask);
+	return retval;
+}
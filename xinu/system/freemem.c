@@ -1,9 +1,10 @@
-/* freemem.c - freemem */
+/* freemem.c - freemem, memlistfree */
 
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  freemem  -  Free a memory block, returning the block to the free list
+ *  freemem  -  Free a memory block, returning it to its slab cache or
+ *		  to the free list
  *------------------------------------------------------------------------
  */
 syscall	freemem(
@@ -12,8 +13,8 @@ syscall	freemem(
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
-	struct	memblk	*next, *prev, *block;
-	uint32	top;
+	int32	cls;			/* Slab class of the block	*/
+	status	retval;			/* Value to return		*/
 
 	mask = disable();
 	if ((nbytes == 0) || ((uint32) blkaddr < (uint32) minheap)
@@ -22,6 +23,29 @@ syscall	freemem(
 		return SYSERR;
 	}
 
+	if ((cls = slabclass(nbytes)) != SYSERR) {
+		slabput(cls, blkaddr, nbytes);
+		retval = OK;
+	} else {
+		retval = heapfree(blkaddr, nbytes);
+	}
+	restore(mask);
+	return retval;
+}
+
+/*------------------------------------------------------------------------
+ *  memlistfree  -  Return a block to the free list, coalescing it with
+ *		      its neighbors (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+status	memlistfree(
+	  char		*blkaddr,	/* Pointer to memory block	*/
+	  uint32	nbytes		/* Size of block in bytes	*/
+	)
+{
+	struct	memblk	*next, *prev, *block;
+	uint32	top;
+
 	nbytes = (uint32) roundmb(nbytes);	/* Use memblk multiples	*/
 	block = (struct memblk *)blkaddr;
 
@@ -42,7 +66,6 @@ syscall	freemem(
 
 	if (((prev != &memlist) && (uint32) block < top)
 	    || ((next != NULL)	&& (uint32) block+nbytes>(uint32)next)) {
-		restore(mask);
 		return SYSERR;
 	}
 
@@ -65,6 +88,5 @@ syscall	freemem(
 		block->mlength += next->mlength;
 		block->mnext = next->mnext;
 	}
-	restore(mask);
 	return OK;
 }
@@ -1,7 +1,84 @@
-/* getbuf.c - getbuf */
+/* getbuf.c - getbuf, trygetbuf, getbufs */
 
 #include <xinu.h>
 
+/*------------------------------------------------------------------------
+ *  bufgrow  -  Add buffers from the heap to a pool that may grow
+ *		  (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	status	bufgrow(
+	  struct bpentry *bpptr		/* Pool to grow			*/
+	)
+{
+	int32	n;			/* Buffers added		*/
+	int32	bufsiz;			/* Buffer size with the pool ID	*/
+	char	*buf;			/* Memory for the new buffers	*/
+	struct	bpentry	*bufptr;	/* Buffer being linked		*/
+	int32	i;			/* Buffer index			*/
+
+	n = bpptr->bpmaxbufs - bpptr->bpnbufs;
+	if (n > bpptr->bpstep) {
+		n = bpptr->bpstep;
+	}
+	if (n <= 0) {
+		return SYSERR;
+	}
+	bufsiz = bpptr->bpsize + sizeof(bpid32);
+	buf = getmem(n * bufsiz);
+	if ((int32)buf == SYSERR) {
+		return SYSERR;
+	}
+	for (i = 0; i < n; i++) {
+		bufptr = (struct bpentry *)(buf + i * bufsiz);
+		bufptr->bpnext = bpptr->bpnext;
+		bpptr->bpnext = bufptr;
+	}
+	bpptr->bpnbufs += n;
+	bpptr->bpgrows++;
+
+	/* Wake waiters, or just count the buffers when there are none	*/
+	/*   so a caller in an interrupt handler is not rescheduled	*/
+
+	if (semtab[bpptr->bpsem].scount >= 0) {
+		semtab[bpptr->bpsem].scount += n;
+	} else {
+		signaln(bpptr->bpsem, n);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  buftake  -  Unlink a buffer the semaphore has been decremented for
+ *		  (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	char	*buftake(
+	  bpid32	poolid,		/* Index of pool in buftab	*/
+	  struct bpentry *bpptr		/* Pointer to entry in buftab	*/
+	)
+{
+	struct	bpentry	*bufptr;	/* Pointer to a buffer		*/
+	int32	nfree;			/* Buffers left in the pool	*/
+
+	bufptr = bpptr->bpnext;
+	bpptr->bpnext = bufptr->bpnext;
+
+	bpptr->bpallocs++;
+	if (++bpptr->bpinuse > bpptr->bphigh) {
+		bpptr->bphigh = bpptr->bpinuse;
+	}
+	nfree = bpptr->bpnbufs - bpptr->bpinuse;
+	if (nfree < bpptr->bplow) {
+		bpptr->bplow = nfree;
+	}
+
+	/* Record pool ID in first four bytes of buffer	and skip */
+
+	*(bpid32 *)bufptr = poolid;
+	return sizeof(bpid32) + (char *)bufptr;
+}
+
 /*------------------------------------------------------------------------
  *  getbuf  -  Get a buffer from a preestablished buffer pool
  *------------------------------------------------------------------------
@@ -12,7 +89,7 @@ char    *getbuf(
 {
 	intmask	mask;			/* Saved interrupt mask		*/
 	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
-	struct	bpentry	*bufptr;	/* Pointer to a buffer		*/
+	char	*buf;			/* Buffer handed out		*/
 
 	mask = disable();
 
@@ -25,19 +102,85 @@ char    *getbuf(
 	}
 	bpptr = &buftab[poolid];
 
-	/* Wait for pool to have > 0 buffers and allocate a buffer */
+	/* Grow an empty pool if it may, otherwise wait for a buffer	*/
 
+	if (semtab[bpptr->bpsem].scount <= 0) {
+		bufgrow(bpptr);
+		if (semtab[bpptr->bpsem].scount <= 0) {
+			bpptr->bpwaits++;
+		}
+	}
 	wait(bpptr->bpsem);
-	bufptr = bpptr->bpnext;
+	buf = buftake(poolid, bpptr);
+	restore(mask);
+	return buf;
+}
 
-	/* Unlink buffer from pool */
+/*------------------------------------------------------------------------
+ *  trygetbuf  -  Get a buffer without blocking; SYSERR if the pool is
+ *		    empty and cannot grow
+ *------------------------------------------------------------------------
+ */
+char    *trygetbuf(
+          bpid32        poolid          /* Index of pool in buftab	*/
+        )
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	char	*buf;			/* Buffer handed out		*/
 
-	bpptr->bpnext = bufptr->bpnext;
+	mask = disable();
+	if ( (poolid < 0  ||  poolid >= nbpools) ) {
+		restore(mask);
+		return (char *)SYSERR;
+	}
+	bpptr = &buftab[poolid];
 
-	/* Record pool ID in first four bytes of buffer	and skip */
+	if (semtab[bpptr->bpsem].scount <= 0
+	    && (bufgrow(bpptr) == SYSERR
+		|| semtab[bpptr->bpsem].scount <= 0)) {
+		bpptr->bpfails++;
+		restore(mask);
+		return (char *)SYSERR;
+	}
+	semtab[bpptr->bpsem].scount--;
+	buf = buftake(poolid, bpptr);
+	restore(mask);
+	return buf;
+}
 
-	*(bpid32 *)bufptr = poolid;
-	bufptr = (struct bpentry *)(sizeof(bpid32) + (char *)bufptr);
+/*------------------------------------------------------------------------
+ *  getbufs  -  Get up to count buffers without blocking; returns the
+ *		  number placed in bufs
+ *------------------------------------------------------------------------
+ */
+int32	getbufs(
+	  bpid32	poolid,		/* Index of pool in buftab	*/
+	  char		*bufs[],	/* Array to fill		*/
+	  int32		count		/* Buffers wanted		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+	int32	n;			/* Buffers obtained		*/
+
+	mask = disable();
+	if (poolid < 0 || poolid >= nbpools || count < 0) {
+		restore(mask);
+		return SYSERR;
+	}
+	bpptr = &buftab[poolid];
+
+	for (n = 0; n < count; n++) {
+		if (semtab[bpptr->bpsem].scount <= 0
+		    && (bufgrow(bpptr) == SYSERR
+			|| semtab[bpptr->bpsem].scount <= 0)) {
+			bpptr->bpfails++;
+			break;
+		}
+		semtab[bpptr->bpsem].scount--;
+		bufs[n] = buftake(poolid, bpptr);
+	}
 	restore(mask);
-	return (char *)bufptr;
+	return n;
 }
@@ -1,7 +1,11 @@
-/* getmem.c - getmem */
+/* getmem.c - getmem, memlistget, memliststat */
 
 #include <xinu.h>
 
+uint32	memlistcalls;			/* Free list walks		*/
+uint64	memlistcycles;			/* TSC ticks spent walking it	*/
+uint32	memlistmax;			/* Longest walk in ticks	*/
+
 /*------------------------------------------------------------------------
  *  getmem  -  Allocate heap storage, returning lowest word address
  *------------------------------------------------------------------------
@@ -11,7 +15,8 @@ char  	*getmem(
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
-	struct	memblk	*prev, *curr, *leftover;
+	int32	cls;			/* Slab class of the request	*/
+	char	*blkaddr;		/* Storage handed out		*/
 
 	mask = disable();
 	if (nbytes == 0) {
@@ -19,7 +24,35 @@ char  	*getmem(
 		return (char *)SYSERR;
 	}
 
+	if ((cls = slabclass(nbytes)) != SYSERR) {
+		blkaddr = slabget(cls, nbytes);
+	} else {
+		blkaddr = heapget(nbytes);
+		if (blkaddr == (char *)SYSERR && slabreclaim() > 0) {
+			blkaddr = heapget(nbytes);
+		}
+	}
+	restore(mask);
+	return blkaddr;
+}
+
+/*------------------------------------------------------------------------
+ *  memlistget  -  Allocate from the free list itself, first fit
+ *		     (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+char  	*memlistget(
+	  uint32	nbytes		/* Size of memory requested	*/
+	)
+{
+	struct	memblk	*prev, *curr, *leftover;
+	uint64	start;			/* TSC at the start of the walk	*/
+	char	*blkaddr;		/* Block found, or SYSERR	*/
+	uint32	ticks;			/* Length of the walk		*/
+
+	start = getticks();
 	nbytes = (uint32) roundmb(nbytes);	/* Use memblk multiples	*/
+	blkaddr = (char *)SYSERR;
 
 	prev = &memlist;
 	curr = memlist.mnext;
@@ -28,8 +61,8 @@ char  	*getmem(
 		if (curr->mlength == nbytes) {	/* Block is exact match	*/
 			prev->mnext = curr->mnext;
 			memlist.mlength -= nbytes;
-			restore(mask);
-			return (char *)(curr);
+			blkaddr = (char *)(curr);
+			break;
 
 		} else if (curr->mlength > nbytes) { /* Split big block	*/
 			leftover = (struct memblk *)((uint32) curr +
@@ -38,13 +71,44 @@ char  	*getmem(
 			leftover->mnext = curr->mnext;
 			leftover->mlength = curr->mlength - nbytes;
 			memlist.mlength -= nbytes;
-			restore(mask);
-			return (char *)(curr);
+			blkaddr = (char *)(curr);
+			break;
 		} else {			/* Move to next block	*/
 			prev = curr;
 			curr = curr->mnext;
 		}
 	}
-	restore(mask);
-	return (char *)SYSERR;
+
+	ticks = (uint32)(getticks() - start);
+	memlistcalls++;
+	memlistcycles += ticks;
+	if (ticks > memlistmax) {
+		memlistmax = ticks;
+	}
+	return blkaddr;
+}
+
+/*------------------------------------------------------------------------
+ *  memliststat  -  Free bytes, free blocks and largest free block on
+ *		      the free list
+ *------------------------------------------------------------------------
+ */
+void	memliststat(
+	  uint32	*freebytes,	/* Set to the free bytes	*/
+	  uint32	*nblocks,	/* Set to the free blocks	*/
+	  uint32	*largest	/* Set to the largest block	*/
+	)
+{
+	struct	memblk	*block;		/* Walks the free list		*/
+
+	*freebytes = 0;
+	*nblocks = 0;
+	*largest = 0;
+	for (block = memlist.mnext; block != NULL; block = block->mnext) {
+		*freebytes += block->mlength;
+		(*nblocks)++;
+		if (block->mlength > *largest) {
+			*largest = block->mlength;
+		}
+	}
 }
@@ -1,7 +1,16 @@
-/* getstk.c - getstk */
+/* getstk.c - getstk, freestk, stkreclaim */
 
 #include <xinu.h>
 
+/* Stacks too large for the slab caches are kept here when freed, so a	*/
+/*   process created with the same stack size (INITSTK for most) takes	*/
+/*   one back without searching the free list				*/
+
+local	char	*stkcache[NSTKCACHE];	/* Lowest address of each stack	*/
+local	uint32	stkcachelen[NSTKCACHE];	/* Its length (mblock multiple)	*/
+uint32	nstkcache = 0;			/* Stacks held in the cache	*/
+uint32	stkcachehits = 0;		/* getstk calls served by it	*/
+
 /*------------------------------------------------------------------------
  *  getstk  -  Allocate stack memory, returning highest word address
  *------------------------------------------------------------------------
@@ -11,8 +20,13 @@ char  	*getstk(
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
+	struct	memblk	*fits;		/* Record block that fits	*/
+#ifndef	BUDDYHEAP
 	struct	memblk	*prev, *curr;	/* Walk through memory list	*/
-	struct	memblk	*fits, *fitsprev; /* Record block that fits	*/
+	struct	memblk	*fitsprev;	/* Block before fits		*/
+#endif
+	int32	cls;			/* Slab class of small stacks	*/
+	int32	i;			/* Index into the stack cache	*/
 
 	mask = disable();
 	if (nbytes == 0) {
@@ -20,22 +34,63 @@ char  	*getstk(
 		return (char *)SYSERR;
 	}
 
-	nbytes = (uint32) roundmb(nbytes);	/* Use mblock multiples	*/
+	/* Small stacks come from a slab cache; freestk rounds the	*/
+	/*   length the same way, so it finds the same cache		*/
+
+	if ((cls = slabclass(nbytes)) != SYSERR) {
+		fits = (struct memblk *)slabget(cls, nbytes);
+		restore(mask);
+		if (fits == (struct memblk *)SYSERR) {
+			return (char *)SYSERR;
+		}
+		return (char *)((uint32) fits + slabtab[cls].scsize
+						- sizeof(uint32));
+	}
 
-	prev = &memlist;
-	curr = memlist.mnext;
-	fits = NULL;
-	fitsprev = NULL;  /* Just to avoid a compiler warning */
+	nbytes = (uint32) roundmb(nbytes);	/* Use mblock multiples	*/
 
-	while (curr != NULL) {			/* Scan entire list	*/
-		if (curr->mlength >= nbytes) {	/* Record block address	*/
-			fits = curr;		/*   when request fits	*/
-			fitsprev = prev;
+	for (i = 0; i < nstkcache; i++) {
+		if (stkcachelen[i] == nbytes) {
+			fits = (struct memblk *)stkcache[i];
+			nstkcache--;
+			stkcache[i] = stkcache[nstkcache];
+			stkcachelen[i] = stkcachelen[nstkcache];
+			stkcachehits++;
+			restore(mask);
+			return (char *)((uint32) fits + nbytes
+						- sizeof(uint32));
 		}
-		prev = curr;
-		curr = curr->mnext;
 	}
 
+#ifdef	BUDDYHEAP
+	fits = (struct memblk *)heapget(nbytes);
+	if (fits == (struct memblk *)SYSERR
+			&& (stkreclaim() > 0 || slabreclaim() > 0)) {
+		fits = (struct memblk *)heapget(nbytes);
+	}
+	restore(mask);
+	if (fits == (struct memblk *)SYSERR) {
+		return (char *)SYSERR;
+	}
+	return (char *)((uint32) fits + nbytes - sizeof(uint32));
+#else
+
+	do {
+		prev = &memlist;
+		curr = memlist.mnext;
+		fits = NULL;
+		fitsprev = NULL;  /* Just to avoid a compiler warning */
+
+		while (curr != NULL) {		/* Scan entire list	*/
+			if (curr->mlength >= nbytes) { /* Record block	*/
+				fits = curr;	/*   when request fits	*/
+				fitsprev = prev;
+			}
+			prev = curr;
+			curr = curr->mnext;
+		}
+	} while (fits == NULL && stkreclaim() > 0);
+
 	if (fits == NULL) {			/* No block was found	*/
 		restore(mask);
 		return (char *)SYSERR;
@@ -49,4 +104,57 @@ char  	*getstk(
 	memlist.mlength -= nbytes;
 	restore(mask);
 	return (char *)((uint32) fits + nbytes - sizeof(uint32));
+#endif
+}
+
+/*------------------------------------------------------------------------
+ *  freestk  -  Free stack memory allocated by getstk, keeping large
+ *		  stacks in the stack cache while it has room
+ *------------------------------------------------------------------------
+ */
+syscall	freestk(
+	  char		*p,		/* Highest word address, as	*/
+					/*   returned by getstk		*/
+	  uint32	len		/* Size passed to getstk	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	char	*blk;			/* Lowest address of the stack	*/
+
+	if (slabclass(len) != SYSERR) {
+		return freemem(p - slabround(len) + sizeof(uint32),
+							(uint32)roundmb(len));
+	}
+
+	len = (uint32) roundmb(len);
+	blk = p - len + sizeof(uint32);
+	mask = disable();
+	if (nstkcache >= NSTKCACHE || (uint32)blk < (uint32)minheap
+			|| (uint32)blk + len > (uint32)maxheap) {
+		restore(mask);
+		return freemem(blk, len);
+	}
+	stkcache[nstkcache] = blk;
+	stkcachelen[nstkcache] = len;
+	nstkcache++;
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  stkreclaim  -  Give every cached stack back to the free list;
+ *		     returns the number of bytes given back
+ *		     (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+uint32	stkreclaim(void)
+{
+	uint32	freed = 0;		/* Bytes given back		*/
+
+	while (nstkcache > 0) {
+		nstkcache--;
+		freemem(stkcache[nstkcache], stkcachelen[nstkcache]);
+		freed += stkcachelen[nstkcache];
+	}
+	return freed;
 }
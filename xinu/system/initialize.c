@@ -17,8 +17,9 @@ local	process startup(void);	/* Process to finish startup tasks	*/
 
 /* Declarations of major kernel variables */
 
-struct	procent	proctab[NPROC];	/* Process table			*/
-struct	sentry	semtab[NSEM];	/* Semaphore table			*/
+struct	procent	*proctab;	/* Process table			*/
+struct	sentry	*semtab;	/* Semaphore table			*/
+struct	mentry	mutextab[NMUTEX]; /* Mutex table			*/
 struct	memblk	memlist;	/* List of free memory blocks		*/
 struct	memblk	pdptlist;	/* Head of PD/PT list	*/
 struct	memblk	ffslist;	/* Head of ffs list	*/
@@ -90,6 +91,10 @@ void	nulluser()
 
 	enable();
 
+	/* Start the kernel worker processes */
+
+	wqinit();
+
 	/* Initialize the network stack and start processes */
 
 	net_init();
@@ -103,7 +108,9 @@ void	nulluser()
 	/*  something to run when no other process is ready to execute)	*/
 
 	while (TRUE) {
-		;		/* Do nothing */
+		if (clktickless) {
+			clkidle();	/* Sleep until the next timer	*/
+		}
 	}
 
 }
@@ -177,10 +184,19 @@ static	void	sysinit()
 	/* Initialize free memory list */
 	
 	meminit();
+#ifdef	BUDDYHEAP
+	buddyinit();
+#endif
+	slabinit();
 
    /* Initialize paging */
    init_paging();
 
+	/* Size and allocate the process, semaphore and port tables */
+
+	tabinit();
+	evinit();
+
 	/* Initialize system variables */
 
 	/* Count the Null process as the first process in the system */
@@ -194,7 +210,7 @@ static	void	sysinit()
    // Add page directory to NULL proc
    // this will create mappings for:
    // text, bss, data, heap, stack
-   null_pdbr = create_directory();
+   ASSERT( create_directory(&null_pdbr) != SYSERR, "Out of PD/PT memory for nullproc\n" );
 
    // Create mappings for:
    // pdpt, ffs, and swap
@@ -205,7 +221,8 @@ static	void	sysinit()
    dir         = (pd_t*)(null_pdbr.pdbr_base << PAGE_OFFSET_BITS);
    for(i = start_dir; i <= end_dir; i++){
       // Create a new directory entry by extending the previous one
-      create_directory_entry(&dir[i], -1, i*N_PAGE_ENTRIES, 0, N_PAGE_ENTRIES);
+      ASSERT( create_directory_entry(&dir[i], -1, i*N_PAGE_ENTRIES, 0, N_PAGE_ENTRIES) != SYSERR,
+            "Out of PD/PT memory for the kernel map\n" );
    }
    
    // Create mapping for FFS region and map onto nullproc
@@ -213,12 +230,13 @@ static	void	sysinit()
 	
 	/* Initialize process table entries free */
 
-	for (i = 0; i < NPROC; i++) {
+	for (i = 0; i < nproc; i++) {
 		prptr = &proctab[i];
 		prptr->prstate = PR_FREE;
 		prptr->prname[0] = NULLCH;
 		prptr->prstkbase = NULL;
 		prptr->prprio = 0;
+		prptr->prmheld = EMPTY;
 	}
 
 	/* Initialize the Null process entry */	
@@ -232,23 +250,49 @@ static	void	sysinit()
 	prptr->prstkptr = 0;
    prptr->pdbr = null_pdbr;
 	currpid = NULLPROC;
+	acctinit();
+
+	/* All other process IDs start on the free list */
+
+	for (i = NULLPROC + 1; i < nproc; i++) {
+		freepid(i);
+	}
 
 	/* Initialize semaphores */
 
-	for (i = 0; i < NSEM; i++) {
+	for (i = 0; i < nsem; i++) {
 		semptr = &semtab[i];
-		semptr->sstate = S_FREE;
 		semptr->scount = 0;
 		semptr->squeue = newqueue();
+		freesem(i);
 	}
 
+	/* Initialize mutexes */
+
+	for (i = 0; i < NMUTEX; i++) {
+		mutextab[i].mstate = M_FREE;
+		mutextab[i].mowner = EMPTY;
+		mutextab[i].mqueue = newqueue();
+		mutextab[i].mnext = EMPTY;
+	}
+
+	/* Initialize the wait queues of locks and rwlocks */
+
+	lockinit();
+
 	/* Initialize buffer pools */
 
 	bufinit();
 
+	/* Initialize the port table */
+
+	ptinit();
+
 	/* Create a ready list for processes */
 
-	readylist = newqueue();
+	readyinit();
+	fairinit();
+	traceinit();
 
 
 	/* initialize the PCI bus */
@@ -1,12 +1,48 @@
 #include <xinu.h>
 
+// The request being served. kernel_service runs it on the kernel stack
+// in the null process's flat-mapped address space, where the caller's
+// (possibly private) stack is not mapped, so like vcreate and kill it
+// keeps what it needs in globals; interrupts stay disabled throughout
+intmask _ksmask;
+bool8   _ksfree;
+char    *_ksptr;
+uint32  _ksnbytes;
+bool8   _ksstack;
+pid32   _kspid;
+
+/*------------------------------------------------------------------------
+ *  kernel_service - run a vmalloc, getvstk or vfree request for pid in
+ *                   kernel mode, in the calling process and so at its
+ *                   priority; nothing is queued that could outlive it
+ *------------------------------------------------------------------------
+ */
+void kernel_service(bool8 isfree, char *ptr, uint32 nbytes, bool8 is_stack, pid32 pid){
+   _ksmask   = disable();
+   _ksfree   = isfree;
+   _ksptr    = ptr;
+   _ksnbytes = nbytes;
+   _ksstack  = is_stack;
+   _kspid    = pid;
+
+   kernel_mode_enter();
+   if( _ksfree ){
+      kernel_service_free(_ksptr, _ksnbytes, _kspid);
+   } else{
+      kernel_service_malloc(_ksnbytes, _ksstack, _kspid);
+   }
+   kernel_mode_exit();
+   restore(_ksmask);
+}
+
 /*------------------------------------------------------------------------
  *  vmalloc -  Allocate heap storage, returning lowest word address
  *------------------------------------------------------------------------
  */
 void kernel_service_malloc(uint32 nbytes, bool8 is_stack, pid32 pid){
 	intmask	mask;			/* Saved interrupt mask		*/
-   uint32 npages, vaddr;
+   uint32 npages, vaddr, frame, zero = 0;
+   uint32 newpd = 0, nnewpt = 0;
    virt_addr_t virt;
    pdbr_t pdbr;
    pd_t *dir;
@@ -26,10 +62,26 @@ void kernel_service_malloc(uint32 nbytes, bool8 is_stack, pid32 pid){
    pdbr   = prptr->pdbr;
    dir    = (pd_t*)(pdbr.pdbr_base << PAGE_OFFSET_BITS);
 
+   // A stack the size of one left by an exited process comes back whole
+   if( is_stack && vstk_cache_get(dir, prptr->vmax, npages) == OK ){
+      prptr->vmax += npages;
+      prptr->npt++;
+      prptr->nstk += npages;
+      restore(mask);
+      return;
+   }
+
    for(i = 0; i < npages; i++){
       virt        = *((virt_addr_t*)&vaddr);
       if( !dir[virt.pd_offset].pd_pres ){
-         create_directory_entry(&dir[virt.pd_offset], -1, -1, 0, 0);
+         if( create_directory_entry(&dir[virt.pd_offset], -1, -1, 0, 0) == SYSERR ){
+            break;
+         }
+         // Tables are added in order, so those of this call are consecutive
+         if( nnewpt++ == 0 ){
+            newpd = virt.pd_offset;
+         }
+         prptr->npt++;
       }
 
       pt                                     = (pt_t*)(dir[virt.pd_offset].pd_base << PAGE_OFFSET_BITS);
@@ -45,11 +97,36 @@ void kernel_service_malloc(uint32 nbytes, bool8 is_stack, pid32 pid){
       pt[virt.pt_offset].pt_isvmalloc        = !is_stack;	/* for programmer's use		*/
       pt[virt.pt_offset].pt_isswapped        = 0;	/* for programmer's use		*/
       pt[virt.pt_offset].pt_already_swapped  = 0;	/* for programmer's use		*/
-      pt[virt.pt_offset].pt_base             = is_stack ? getvstackframe() : 0;
+      pt[virt.pt_offset].pt_base             = 0;
+      if( is_stack ){
+         frame                               = getvstackframe();
+         if( frame == SYSERR ){
+            pt[virt.pt_offset]               = *((pt_t*)&zero);
+            break;
+         }
+         pt[virt.pt_offset].pt_base          = frame;
+         prptr->nstk++;
+      }
 
       vaddr                          += PAGE_SIZE;
    }
 
+   if( i < npages ){
+      // Out of memory and nothing left to kill: undo the pages mapped so
+      // far and the page tables added for them, and leave vmax unchanged
+      // so the caller can tell
+      while( i-- > 0 ){
+         free_vpage(pid, dir, prptr->vmax + i, TRUE);
+      }
+      while( nnewpt-- > 0 ){
+         freepdptframe(dir[newpd + nnewpt].pd_base);
+         *((uint32*)&dir[newpd + nnewpt]) = 0;
+         prptr->npt--;
+      }
+      restore(mask);
+      return;
+   }
+
    prptr->vmax   += npages;
 
    if( !is_stack ){
@@ -60,10 +137,11 @@ void kernel_service_malloc(uint32 nbytes, bool8 is_stack, pid32 pid){
 	restore(mask);
 }
 
-void free_vpage(pd_t *dir, uint32 i, bool8 nofail){
+void free_vpage(pid32 pid, pd_t *dir, uint32 i, bool8 nofail){
    virt_addr_t virt;
    uint32 curraddr, pd_base, frame, maxpdptframe, maxffsframe, zero = 0;
    pt_t *pt;
+	struct procent *prptr = &proctab[pid];
 
    maxpdptframe  = ceil_div( ((uint32)maxpdpt), PAGE_SIZE );
    maxffsframe   = ceil_div( ((uint32)maxffs), PAGE_SIZE );
@@ -81,16 +159,20 @@ void free_vpage(pd_t *dir, uint32 i, bool8 nofail){
       // Handle stack separately
       if( (frame << PAGE_OFFSET_BITS) >= (uint32)minvstack ){
          freevstackframe(frame);
+         prptr->nstk--;
       } else{
          freeffsframe( frame );
          // As an ffs frame is being freed, we should clear the mapping of this page
          // to page table
-         ptmap[frame-maxpdptframe] = NULL;
+         ptmap[frame-maxpdptframe]   = NULL;
+         ffs2pid[frame-maxpdptframe] = -1;
+         prptr->nffs--;
          if(pt[virt.pt_offset].pt_already_swapped){
             // There is an entry in swap that needs to be freed
             ASSERT( ffs2swapmap[frame-maxpdptframe] != -1, "Illegal ffs2swapmap mapping in vfree\n" );
             freeswapframe( ffs2swapmap[frame-maxpdptframe] );
             swap2ffsmap[ffs2swapmap[frame-maxpdptframe] - maxffsframe] = NULL;
+            prptr->nswap--;
          }
          ffs2swapmap[frame-maxpdptframe] = -1;
       }
@@ -99,6 +181,7 @@ void free_vpage(pd_t *dir, uint32 i, bool8 nofail){
       ASSERT( swap2ffsmap[pt[virt.pt_offset].pt_base - maxffsframe] == NULL, "Non null mapping in swap2ffsmap in vfree\n" );
       freeswapframe( pt[virt.pt_offset].pt_base );
       swap2ffsmap[pt[virt.pt_offset].pt_base - maxffsframe] = NULL;
+      prptr->nswap--;
    } else if(!nofail){
       ASSERT(FALSE, "Double free in kernel_service_free %08X %d %d %d %08X\n", pt[virt.pt_offset], i, virt.pt_offset, virt.pd_offset, virt);
    }
@@ -127,12 +210,12 @@ void kernel_service_free(char *ptr, uint32 nbytes, pid32 pid){
 
    for(i = start_page; i < end_page; i++){
       npages++;
-      free_vpage(dir, i, TRUE);
+      free_vpage(pid, dir, i, TRUE);
    }
 
    prptr->vfree    += npages;
    n_free_vpages   += npages;
-   ASSERT( n_free_vpages >= 0 && n_free_vpages <= MAX_HEAP_SIZE, "Illegal value of n_free_vpages (=%d)\n", n_free_vpages );
+   ASSERT( n_free_vpages >= 0 && n_free_vpages <= maxheapframes, "Illegal value of n_free_vpages (=%d)\n", n_free_vpages );
 
 	restore(mask);
 }
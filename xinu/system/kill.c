@@ -36,13 +36,19 @@ syscall	kill(
    }
    freestk(prptr->prstkbase, prptr->prstklen);
 
+   // Hand on the mutexes it holds and leave a mutex queue
+   mutexrelease(pid);
+   fpurelease(pid);
+   evcancel(pid);
+   coreclaim(pid);
+
    _prstate  = prptr->prstate;
    _prsem    = prptr->prsem;
    _pruser   = prptr->pruser;
    _prparent = prptr->prparent;
    _pid      = pid;
 
-   prptr->prstate = PR_FREE;
+   freepid(pid);
 
    // Switch to protected mode/stack
    kernel_mode_enter();
@@ -64,11 +70,16 @@ syscall	kill(
 
       case PR_WAIT:
          semtab[_prsem].scount++;
-         /* Fall through */
+         getitem(_pid);		/* Remove from queue */
+         break;
+
+      case PR_LOCK:
+         getitem(_pid);		/* Remove from lock queue */
+         break;
 
       case PR_READY:
-         getitem(_pid);		/* Remove from queue */
-         /* Fall through */
+         readyremove(_pid);	/* Remove from ready list */
+         break;
 
       default:
          break;
@@ -0,0 +1,138 @@
+/* lock.c - lockinit, lockqget, lockqput, lkinit, lkdelete, lkwait,	*/
+/*	      lkwake							*/
+
+#include <xinu.h>
+
+local	qid16	lockqueues[NLOCK];	/* Wait queues not yet in use	*/
+local	int32	nlockq;			/* Entries in lockqueues	*/
+
+/*------------------------------------------------------------------------
+ *  lockinit  -  Allocate the wait queues handed out by lkinit and rwinit
+ *------------------------------------------------------------------------
+ */
+void	lockinit(void)
+{
+	for (nlockq = 0; nlockq < NLOCK; nlockq++) {
+		lockqueues[nlockq] = newqueue();
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  lockqget  -  Take a free wait queue (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+qid16	lockqget(void)
+{
+	if (nlockq == 0) {
+		return SYSERR;
+	}
+	return lockqueues[--nlockq];
+}
+
+/*------------------------------------------------------------------------
+ *  lockqput  -  Give back an empty wait queue (assumes interrupts are
+ *		   disabled)
+ *------------------------------------------------------------------------
+ */
+void	lockqput(
+	  qid16		q		/* Queue to return		*/
+	)
+{
+	lockqueues[nlockq++] = q;
+}
+
+/*------------------------------------------------------------------------
+ *  lkinit  -  Initialize a lock as free
+ *------------------------------------------------------------------------
+ */
+syscall	lkinit(
+	  struct lock	*lk		/* Lock to initialize		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	qid16	q;			/* Wait queue for the lock	*/
+
+	mask = disable();
+	if ((q = lockqget()) == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	lk->lstate = LK_FREE;
+	lk->lqueue = q;
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  lkdelete  -  Give back the wait queue of a lock nobody holds
+ *------------------------------------------------------------------------
+ */
+syscall	lkdelete(
+	  struct lock	*lk		/* Lock to delete		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (lk->lstate != LK_FREE || isbadqid(lk->lqueue)) {
+		restore(mask);
+		return SYSERR;
+	}
+	lockqput(lk->lqueue);
+	lk->lqueue = EMPTY;
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  lkwait  -  Slow path of lkacquire: wait until the holder hands the
+ *		 lock over
+ *------------------------------------------------------------------------
+ */
+syscall	lkwait(
+	  struct lock	*lk		/* Lock to acquire		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (lk->lstate == LK_FREE) {	/* Released since the fast path	*/
+		lk->lstate = LK_HELD;
+		restore(mask);
+		return OK;
+	}
+	lk->lstate = LK_WAITERS;
+	proctab[currpid].prstate = PR_LOCK;
+	enqueue(currpid, lk->lqueue);
+	resched();			/* lkwake hands us the lock	*/
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  lkwake  -  Slow path of lkrelease: hand the lock to the first waiter
+ *------------------------------------------------------------------------
+ */
+syscall	lkwake(
+	  struct lock	*lk		/* Lock to release		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	pid32	pid;			/* Waiter taking the lock	*/
+
+	mask = disable();
+	if (lk->lstate == LK_FREE) {	/* Not held			*/
+		restore(mask);
+		return SYSERR;
+	}
+	if (isempty(lk->lqueue)) {	/* Waiters were killed		*/
+		lk->lstate = LK_FREE;
+		restore(mask);
+		return OK;
+	}
+	pid = dequeue(lk->lqueue);
+	lk->lstate = nonempty(lk->lqueue) ? LK_WAITERS : LK_HELD;
+	ready(pid);
+	restore(mask);
+	return OK;
+}
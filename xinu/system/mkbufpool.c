@@ -1,4 +1,4 @@
-/* mkbufpool.c - mkbufpool */
+/* mkbufpool.c - mkbufpool, growbufpool */
 
 #include <xinu.h>
 
@@ -36,6 +36,12 @@ bpid32	mkbufpool(
 	bpptr = &buftab[poolid];
 	bpptr->bpnext = (struct bpentry *)buf;
 	bpptr->bpsize = bufsiz;
+	bpptr->bpnbufs = bpptr->bpmaxbufs = numbufs;
+	bpptr->bpstep = 0;
+	bpptr->bpinuse = bpptr->bphigh = 0;
+	bpptr->bplow = numbufs;
+	bpptr->bpallocs = bpptr->bpfails = 0;
+	bpptr->bpwaits = bpptr->bpgrows = 0;
 	if ( (bpptr->bpsem = semcreate(numbufs)) == SYSERR) {
 		freemem(buf, numbufs * (bufsiz+sizeof(bpid32)) );
 		nbpools--;
@@ -53,3 +59,33 @@ bpid32	mkbufpool(
 	restore(mask);
 	return poolid;
 }
+
+/*------------------------------------------------------------------------
+ *  growbufpool  -  Let a pool add step buffers at a time from the heap
+ *		      when it runs out, up to maxbufs buffers in all
+ *------------------------------------------------------------------------
+ */
+syscall	growbufpool(
+	  bpid32	poolid,		/* Index of pool in buftab	*/
+	  int32		step,		/* Buffers added per growth	*/
+	  int32		maxbufs		/* Most buffers the pool owns	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	bpentry	*bpptr;		/* Pointer to entry in buftab	*/
+
+	mask = disable();
+	if (poolid < 0 || poolid >= nbpools || step < 1) {
+		restore(mask);
+		return SYSERR;
+	}
+	bpptr = &buftab[poolid];
+	if (maxbufs < bpptr->bpnbufs) {
+		restore(mask);
+		return SYSERR;
+	}
+	bpptr->bpstep = step;
+	bpptr->bpmaxbufs = maxbufs;
+	restore(mask);
+	return OK;
+}
@@ -0,0 +1,48 @@
+/* mutexcreate.c - mutexcreate, newmutex */
+
+#include <xinu.h>
+
+local	mid32	newmutex(void);
+
+/*------------------------------------------------------------------------
+ *  mutexcreate  -  Create a new (unlocked) mutex and return its ID
+ *------------------------------------------------------------------------
+ */
+mid32	mutexcreate(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	mid32	mtx;			/* Mutex ID to return		*/
+
+	mask = disable();
+
+	if ((mtx = newmutex()) == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	mutextab[mtx].mowner = EMPTY;	/* Initialize table entry	*/
+
+	restore(mask);
+	return mtx;
+}
+
+/*------------------------------------------------------------------------
+ *  newmutex  -  Allocate an unused mutex and return its index
+ *------------------------------------------------------------------------
+ */
+local	mid32	newmutex(void)
+{
+	static	mid32	nextmutex = 0;	/* Next mutex index to try	*/
+	mid32	mtx;			/* Mutex ID to return		*/
+	int32	i;			/* Iterate through # entries	*/
+
+	for (i=0 ; i<NMUTEX ; i++) {
+		mtx = nextmutex++;
+		if (nextmutex >= NMUTEX)
+			nextmutex = 0;
+		if (mutextab[mtx].mstate == M_FREE) {
+			mutextab[mtx].mstate = M_USED;
+			return mtx;
+		}
+	}
+	return SYSERR;
+}
@@ -0,0 +1,45 @@
+/* mutexdelete.c - mutexdelete */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  mutexdelete  -  Delete a mutex; its waiters return SYSERR from
+ *		      mutexlock and its owner stops inheriting through it
+ *------------------------------------------------------------------------
+ */
+syscall	mutexdelete(
+	  mid32		mtx		/* ID of mutex to delete	*/
+	)
+{
+	intmask mask;			/* Saved interrupt mask		*/
+	struct	mentry *mptr;		/* Ptr to mutex table entry	*/
+	pid32	pid;			/* Waiting process		*/
+
+	mask = disable();
+	if (isbadmutex(mtx)) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	mptr = &mutextab[mtx];
+	if (mptr->mstate == M_FREE) {
+		restore(mask);
+		return SYSERR;
+	}
+	mptr->mstate = M_FREE;
+
+	resched_cntl(DEFER_START);
+	while (nonempty(mptr->mqueue)) { /* Free all waiting processes	*/
+		pid = getfirst(mptr->mqueue);
+		proctab[pid].prmutex = SYSERR;
+		ready(pid);
+	}
+	if (mptr->mowner != EMPTY) {
+		pid = mptr->mowner;
+		mutexdisown(mtx);
+		mutexprio(pid, mutexinherit(pid));
+	}
+	resched_cntl(DEFER_STOP);
+	restore(mask);
+	return OK;
+}
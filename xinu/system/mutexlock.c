@@ -0,0 +1,54 @@
+/* mutexlock.c - mutexlock */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  mutexlock  -  Lock a mutex, waiting (and lending the owner the
+ *		    caller's priority) while another process holds it
+ *------------------------------------------------------------------------
+ */
+syscall	mutexlock(
+	  mid32		mtx		/* ID of mutex to lock		*/
+	)
+{
+	intmask mask;			/* Saved interrupt mask		*/
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	struct	mentry *mptr;		/* Ptr to mutex table entry	*/
+
+	mask = disable();
+	if (isbadmutex(mtx)) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	mptr = &mutextab[mtx];
+	if (mptr->mstate == M_FREE || mptr->mowner == currpid) {
+		restore(mask);
+		return SYSERR;		/* Unused, or would deadlock	*/
+	}
+
+	if (mptr->mowner == EMPTY) {	/* Uncontended: take it		*/
+		mutexown(mtx, currpid);
+		restore(mask);
+		return OK;
+	}
+
+	/* Wait in priority order; the owner inherits our priority	*/
+
+	prptr = &proctab[currpid];
+	prptr->prstate = PR_MUTEX;
+	prptr->prmutex = mtx;
+	insert(currpid, mptr->mqueue, prptr->prprio);
+	mutexprio(mptr->mowner, mutexinherit(mptr->mowner));
+	resched();
+
+	/* mutexunlock made us the owner, or mutexdelete woke us up	*/
+
+	if (prptr->prmutex == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	prptr->prmutex = -1;
+	restore(mask);
+	return OK;
+}
@@ -0,0 +1,178 @@
+/* mutexprio.c - mutexown, mutexdisown, mutexinherit, mutexprio,
+ *		 mutexhandoff, mutexrelease */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  mutexown  -  Make a process the owner of an unowned mutex and add
+ *		   the mutex to the list it holds (assumes interrupts are
+ *		   disabled)
+ *------------------------------------------------------------------------
+ */
+void	mutexown(
+	  mid32		mtx,		/* ID of mutex being taken	*/
+	  pid32		pid		/* ID of process taking it	*/
+	)
+{
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+
+	prptr = &proctab[pid];
+	mutextab[mtx].mowner = pid;
+	mutextab[mtx].mnext = prptr->prmheld;
+	prptr->prmheld = mtx;
+}
+
+/*------------------------------------------------------------------------
+ *  mutexdisown  -  Take a mutex off its owner's list and leave it
+ *		      unowned (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	mutexdisown(
+	  mid32		mtx		/* ID of mutex being given up	*/
+	)
+{
+	struct	mentry *mptr;		/* Ptr to mutex table entry	*/
+	mid32	*linkp;			/* Link that points to mtx	*/
+
+	mptr = &mutextab[mtx];
+	linkp = &proctab[mptr->mowner].prmheld;
+	while (*linkp != mtx) {
+		linkp = &mutextab[*linkp].mnext;
+	}
+	*linkp = mptr->mnext;
+	mptr->mnext = EMPTY;
+	mptr->mowner = EMPTY;
+}
+
+/*------------------------------------------------------------------------
+ *  mutexinherit  -  Priority a process should run at: its base priority
+ *		       or that of the best waiter on a mutex it holds
+ *------------------------------------------------------------------------
+ */
+pri16	mutexinherit(
+	  pid32		pid		/* ID of process to look at	*/
+	)
+{
+	struct	mentry *mptr;		/* Ptr to mutex table entry	*/
+	pri16	prio;			/* Highest priority found	*/
+	mid32	mtx;			/* Mutex being examined		*/
+
+	prio = proctab[pid].prbaseprio;
+	for (mtx = proctab[pid].prmheld; mtx != EMPTY; mtx = mptr->mnext) {
+		mptr = &mutextab[mtx];
+		if (nonempty(mptr->mqueue) && firstkey(mptr->mqueue) > prio) {
+			prio = firstkey(mptr->mqueue);
+		}
+	}
+	return prio;
+}
+
+/*------------------------------------------------------------------------
+ *  mutexprio  -  Set the running priority of a process, and pass the
+ *		    change along the chain of mutex owners it waits
+ *		    behind (assumes interrupts are disabled; does not
+ *		    reschedule)
+ *------------------------------------------------------------------------
+ */
+void	mutexprio(
+	  pid32		pid,		/* ID of process to change	*/
+	  pri16		prio		/* Priority it should run at	*/
+	)
+{
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	struct	mentry *mptr;		/* Mutex the process waits on	*/
+
+	while (!isbadpid(pid)) {
+		prptr = &proctab[pid];
+		if (prptr->prprio == prio) {
+			return;
+		}
+		if (prptr->prstate == PR_READY) {
+			readyremove(pid);
+			prptr->prprio = prio;
+			readyinsert(pid, prio);
+		} else {
+			prptr->prprio = prio;
+		}
+		if (prptr->prstate != PR_MUTEX) {
+			return;
+		}
+
+		/* Re-sort the waiter; its mutex's owner follows suit	*/
+
+		mptr = &mutextab[prptr->prmutex];
+		getitem(pid);
+		insert(pid, mptr->mqueue, prio);
+		pid = mptr->mowner;
+		prio = mutexinherit(pid);
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  mutexhandoff  -  Pass a mutex from its owner to the highest priority
+ *		       waiter, if any, and drop what the owner inherited
+ *		       through it (assumes interrupts are disabled; the
+ *		       caller reschedules)
+ *------------------------------------------------------------------------
+ */
+void	mutexhandoff(
+	  mid32		mtx		/* ID of mutex to pass on	*/
+	)
+{
+	struct	mentry *mptr;		/* Ptr to mutex table entry	*/
+	struct	procent *prptr;		/* Ptr to the new owner's entry	*/
+	pid32	owner;			/* Process giving it up		*/
+	pid32	next;			/* Process taking it		*/
+
+	mptr = &mutextab[mtx];
+	owner = mptr->mowner;
+	mutexdisown(mtx);
+	if (isempty(mptr->mqueue)) {
+		return;
+	}
+
+	/* The new owner is on no queue, so its priority can be set	*/
+	/*   directly before it goes on the ready list			*/
+
+	next = dequeue(mptr->mqueue);
+	mutexown(mtx, next);
+	prptr = &proctab[next];
+	prptr->prprio = mutexinherit(next);
+	prptr->prstate = PR_READY;
+	if (traceon) {
+		tracewake(next);
+	}
+	readyinsert(next, prptr->prprio);
+
+	if (!isbadpid(owner)) {
+		mutexprio(owner, mutexinherit(owner));
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  mutexrelease  -  Hand on every mutex held by a process that is being
+ *		       killed, and take it off a mutex queue it waits on
+ *		       (assumes interrupts are disabled; does not
+ *		       reschedule)
+ *------------------------------------------------------------------------
+ */
+void	mutexrelease(
+	  pid32		pid		/* ID of process being killed	*/
+	)
+{
+	struct	procent *prptr;		/* Ptr to process's table entry	*/
+	struct	mentry *mptr;		/* Ptr to mutex table entry	*/
+	pid32	owner;			/* Owner of the awaited mutex	*/
+
+	prptr = &proctab[pid];
+	if (prptr->prstate == PR_MUTEX) {
+		mptr = &mutextab[prptr->prmutex];
+		getitem(pid);
+		owner = mptr->mowner;
+		prptr->prstate = PR_SUSP;	/* On no queue any more	*/
+		mutexprio(owner, mutexinherit(owner));
+	}
+	while (prptr->prmheld != EMPTY) {
+		mutexhandoff(prptr->prmheld);
+	}
+}
@@ -0,0 +1,32 @@
+/* mutexunlock.c - mutexunlock */
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  mutexunlock  -  Unlock a mutex held by the caller, hand it to the
+ *		      highest priority waiter, and give up any priority
+ *		      inherited through it
+ *------------------------------------------------------------------------
+ */
+syscall	mutexunlock(
+	  mid32		mtx		/* ID of mutex to unlock	*/
+	)
+{
+	intmask mask;			/* Saved interrupt mask		*/
+	struct	mentry *mptr;		/* Ptr to mutex table entry	*/
+
+	mask = disable();
+	if (isbadmutex(mtx)) {
+		restore(mask);
+		return SYSERR;
+	}
+	mptr = &mutextab[mtx];
+	if (mptr->mstate == M_FREE || mptr->mowner != currpid) {
+		restore(mask);
+		return SYSERR;
+	}
+	mutexhandoff(mtx);
+	resched();
+	restore(mask);
+	return OK;
+}
@@ -8,9 +8,12 @@
  */
 qid16	newqueue(void)
 {
-	static qid16	nextqid=NPROC;	/* Next list in queuetab to use	*/
+	static qid16	nextqid=EMPTY;	/* Next list in queuetab to use	*/
 	qid16		q;		/* ID of allocated queue 	*/
 
+	if (nextqid == EMPTY) {		/* Lists follow the nproc	*/
+		nextqid = nproc;	/*   process entries		*/
+	}
 	q = nextqid;
 	if (q >= NQENT) {		/* Check for table overflow	*/
 		return SYSERR;
@@ -0,0 +1,129 @@
+/* oom.c - oom_footprint, oom_select, oom_kill */
+
+#include <xinu.h>
+
+int32 oom_prio_bias = OOM_PRIO_BIAS;
+
+/*------------------------------------------------------------------------
+ * oom_footprint - frames held by a user process: page tables, resident
+ *                 heap/stack pages and swap copies
+ *------------------------------------------------------------------------
+ */
+uint32 oom_footprint(pid32 pid){
+   struct procent *prptr = &proctab[pid];
+
+   if( !prptr->pruser ) return 0;
+   return prptr->nffs + prptr->nswap + prptr->npt + prptr->nstk;
+}
+
+/*------------------------------------------------------------------------
+ * oom_select - pick the user process to kill: largest footprint less
+ *              oom_prio_bias frames per priority level. The requester,
+ *              its creator and processes that hold no pages are spared.
+ *              vmalloc, getvstk and vfree run in the requester itself
+ *              (kernel_service), so req is never a stand-in for it; the
+ *              process vcreate is building holds no pages yet
+ *------------------------------------------------------------------------
+ */
+pid32 oom_select(pid32 req){
+   struct procent *prptr;
+   pid32 pid, victim = SYSERR, spare = SYSERR;
+   uint32 nframes, vbase;
+   int32 score, best = 0;
+
+   if( !isbadpid(req) ){
+      spare = proctab[req].prparent;
+   }
+   vbase = ceil_div( ((uint32)maxvstack + 1), PAGE_SIZE );
+
+   for( pid = 1; pid < nproc; pid++ ){
+      prptr = &proctab[pid];
+      if( prptr->prstate == PR_FREE || !prptr->pruser || prptr->prstate == PR_CURR
+            || pid == req || pid == spare ){
+         continue;
+      }
+      // No stack or heap yet (vcreate in progress): nothing to gain
+      if( prptr->vmax == vbase ){
+         continue;
+      }
+      nframes = oom_footprint(pid);
+      score = nframes - oom_prio_bias * prptr->prprio;
+      if( victim == SYSERR || score > best ){
+         victim = pid;
+         best   = score;
+      }
+   }
+   return victim;
+}
+
+/*------------------------------------------------------------------------
+ * oom_kill - kill the process picked by oom_select to free its frames.
+ *            Same teardown as kill(), but callable from kernel mode
+ *            (the fault handler, or vcreate building a directory) since
+ *            it neither switches stacks nor reschedules
+ *------------------------------------------------------------------------
+ */
+pid32 oom_kill(pid32 req){
+   intmask mask;
+   struct procent *prptr;
+   pid32 victim;
+   int32 i;
+
+   mask   = disable();
+   victim = oom_select(req);
+   if( victim == SYSERR ){
+      kprintf("OOM: no process to kill for process %d\n", req);
+      restore(mask);
+      return SYSERR;
+   }
+
+   prptr  = &proctab[victim];
+   kprintf("OOM: killing process %d '%s' (%d frames, priority %d) for process %d\n",
+         victim, prptr->prname, oom_footprint(victim), prptr->prprio, req);
+
+   if (--prcount <= 1) {
+      xdone();
+   }
+   for (i=0; i<3; i++) {
+      close(prptr->prdesc[i]);
+   }
+
+   freevmem(victim);
+   mutexrelease(victim);
+   fpurelease(victim);
+   evcancel(victim);
+   coreclaim(victim);
+
+   switch (prptr->prstate) {
+      case PR_SLEEP:
+      case PR_RECTIM:
+         unsleep(victim);
+         break;
+
+      case PR_WAIT:
+         semtab[prptr->prsem].scount++;
+         getitem(victim);
+         break;
+
+      case PR_LOCK:
+         getitem(victim);
+         break;
+
+      case PR_READY:
+         readyremove(victim);
+         break;
+
+      default:
+         break;
+   }
+   freepid(victim);
+   destroy_directory(victim);
+
+   // Tell the parent like kill does, without rescheduling here
+   Defer.ndefers++;
+   send(prptr->prparent, victim);
+   Defer.ndefers--;
+
+   restore(mask);
+   return victim;
+}
@@ -0,0 +1,59 @@
+/* pagecopy.c - pagecopy_init, page_copy_fpu, page_zero_fpu, page_swap_fpu */
+
+#include <xinu.h>
+
+// Page primitives used by the VM, (dst, src) like memcpy. Frames are
+// flat mapped in the nullproc address space, so callers pass the frame
+// number shifted by PAGE_OFFSET_BITS
+void (*page_copy)(void *, void *) = page_copy_rep;
+void (*page_zero)(void *)         = page_zero_rep;
+void (*page_swap)(void *, void *) = page_swap_rep;
+char *page_variant                = "rep";
+bool8 page_has_sse2               = FALSE;
+
+/*------------------------------------------------------------------------
+ * page_copy_fpu, page_zero_fpu, page_swap_fpu - the SSE2 routines with
+ *                 the FPU taken from its owning process around them, so
+ *                 the clobbered %xmm registers are restored lazily
+ *------------------------------------------------------------------------
+ */
+local void page_copy_fpu(void *dst, void *src){
+   fpukernel();
+   page_copy_sse2(dst, src);
+   fpukerneldone();
+}
+
+local void page_zero_fpu(void *dst){
+   fpukernel();
+   page_zero_sse2(dst);
+   fpukerneldone();
+}
+
+local void page_swap_fpu(void *a, void *b){
+   fpukernel();
+   page_swap_sse2(a, b);
+   fpukerneldone();
+}
+
+/*------------------------------------------------------------------------
+ * pagecopy_init - pick the page copy/zero/swap routines for this CPU.
+ *                 SSE2 is used when CPUID reports it and fpuinit has
+ *                 enabled SSE, unless pagecopy=rep is on the boot
+ *                 command line
+ *------------------------------------------------------------------------
+ */
+void pagecopy_init(){
+   char arg[8];
+
+   if( fpuenabled && (cpuid() & CPUID_SSE2) ){
+      page_has_sse2 = TRUE;
+   }
+
+   if( page_has_sse2 && !(getbootarg("pagecopy", arg, sizeof(arg)) == OK && strncmp(arg, "rep", 4) == 0) ){
+      page_copy    = page_copy_fpu;
+      page_zero    = page_zero_fpu;
+      page_swap    = page_swap_fpu;
+      page_variant = "sse2";
+   }
+   kprintf("Paging: %s page copy\n", page_variant);
+}
@@ -13,6 +13,9 @@ pt_t *ptP;
 pt_t *tmpPtP;
 uint32 cr3;
 bool8 inplace;
+bool8 oom_self;
+pid32 ownerpid;
+uint64 pfstart, pfticks;
 
 local void copy_page(uint32, uint32, bool8);
 local uint32 swap_get_evict_candidate(uint32);
@@ -25,8 +28,10 @@ local uint32 swap_get_evict_candidate(uint32);
  *------------------------------------------------------------------------
  */
 void	pagefault_handler(){
+   pfstart = getticks();
    cr3 = read_cr3();
    inplace = FALSE;
+   oom_self = FALSE;
 
    // Make sure no variables are on stack as it can cause issues
    // during virtual stack scenario
@@ -58,6 +63,7 @@ void	pagefault_handler(){
          if( ptP->pt_isvmalloc || ptP->pt_isswapped ){
             ASSERT( !(ptP->pt_isvmalloc && ptP->pt_isswapped), "isvmalloc and isswapped set together\n" );
 
+oom_retry:
             phys_frame    = getffsframe();
 
             maxpdptframe  = ceil_div( ((uint32)maxpdpt), PAGE_SIZE );
@@ -65,8 +71,9 @@ void	pagefault_handler(){
             if( phys_frame == ((uint32)SYSERR >> PAGE_OFFSET_BITS) ){
                // There is no space in FFS region
                // 1. Find a random FFS frame to swap out
-               ptmapindex  = rand() % MAX_FSS_SIZE;
+               ptmapindex  = rand() % nffsframes;
                evict_frame = maxpdptframe + ptmapindex;
+               ownerpid    = ffs2pid[ptmapindex];
 
                // This is when a page being accessed is not in FFS (time to vmalloc) and:
                // 1. Old page being evicted has no swap memory
@@ -98,8 +105,17 @@ void	pagefault_handler(){
                      //  (ii). Remove pt_already_swapped from the 
                      //        evicted frame
                      swapframe               = swap_get_evict_candidate(cr2);
+                     if( swapframe == SYSERR && !ptP->pt_isswapped ){
+                        // Out of swappable memory. Nothing has been
+                        // changed yet: kill a victim and start over, or
+                        // give up on the faulting process itself
+                        if( oom_kill(currpid) != SYSERR ){
+                           goto oom_retry;
+                        }
+                        oom_self = TRUE;
+                        goto oom_out;
+                     }
                      if( swapframe == SYSERR ){
-                        ASSERT(ptP->pt_isswapped, "Out of swappable memory!\n");
                         swapframe            = ptP->pt_base - maxffsframe;
                         inplace              = TRUE;
                         tmpPtP               = ptP;
@@ -108,6 +124,12 @@ void	pagefault_handler(){
                      }
 
                      tmpPtP->pt_already_swapped = 0;
+                     // Its owner loses the swap copy
+                     if( inplace ){
+                        proctab[currpid].nswap--;
+                     } else{
+                        proctab[ffs2pid[tmpPtP->pt_base - maxpdptframe]].nswap--;
+                     }
                      // Setting dirty so that page can be written back to 
                      // memory if every evicted
                      tmpPtP->pt_dirty           = 1;
@@ -116,6 +138,8 @@ void	pagefault_handler(){
                      }
                      swapframe              += maxffsframe;
                   }
+                  // Either way the evicted page now holds a swap frame
+                  proctab[ownerpid].nswap++;
                }
                // -> For the new page being brought to life, there is no swap associated
                //    with it yet so reset ffs2swap mapping 
@@ -134,6 +158,8 @@ void	pagefault_handler(){
                   copy_page(evict_frame, swapframe, inplace);
                }
                ptmap[ptmapindex]->pt_dirty     = 0;
+               proctab[ownerpid].nffs--;
+               proctab[ownerpid].nevicts++;
 
                // The page being accessed right now is present in swap memory
                // bring it back
@@ -169,6 +195,9 @@ void	pagefault_handler(){
             }
 
             ptmap[ptmapindex]     = ptP;
+            ffs2pid[ptmapindex]   = currpid;
+            proctab[currpid].nffs++;
+            proctab[currpid].nfaults++;
 
             ptP->pt_base          = phys_frame;
             ptP->pt_pres          = 1;
@@ -184,36 +213,35 @@ void	pagefault_handler(){
          ASSERT(FALSE, "SEGMENTATION FAULT (!pdpres) %08X %08X %d\n", cr2, read_cr3(), currpid);
       }
    }
+oom_out:
    kernel_mode_exit();
+   pfticks = getticks() - pfstart;
+   proctab[currpid].prsvccyc += pfticks;
+   if( traceon ){
+      // Runs with interrupts off from the dispatcher on
+      traceirqspan((uint32)pagefault_handler, pfticks);
+   }
+
+   // Back on the process stack, so this is an ordinary self kill
+   if( oom_self ){
+      kprintf("OOM: killing faulting process %d '%s'\n", currpid, proctab[currpid].prname);
+      kill(currpid);
+   }
 }
 
 local void copy_page(uint32 fromframe, uint32 toframe, bool8 bothways){
-   int i;
-   uint32 temp;
-   uint32 *fromuint32;
-   uint32 *touint32;
-
-   fromuint32           = (uint32*)(fromframe << PAGE_OFFSET_BITS);
-   touint32             = (uint32*)(toframe << PAGE_OFFSET_BITS);
-
    if( bothways ){
       // Swap the contents
-      for(i = 0; i < N_PAGE_ENTRIES; i++){
-         temp          = fromuint32[i];
-         fromuint32[i] = touint32[i];
-         touint32[i]   = temp;
-      }
+      page_swap( (void*)(toframe << PAGE_OFFSET_BITS), (void*)(fromframe << PAGE_OFFSET_BITS) );
    } else{
-      for(i = 0; i < N_PAGE_ENTRIES; i++){
-         touint32[i]  = fromuint32[i];
-      }
+      page_copy( (void*)(toframe << PAGE_OFFSET_BITS), (void*)(fromframe << PAGE_OFFSET_BITS) );
    }
 }
 
 local uint32 swap_get_evict_candidate(uint32 cr2){
    int i;
    // Iterate through all swap pages and check if they are non-dirty
-   for( i = 0; i < MAX_SWAP_SIZE; i++ ){
+   for( i = 0; i < nswapframes; i++ ){
       // Give an allocated frame which also exists in FFS and is not dirty
       if( swap2ffsmap[i] != NULL && swap2ffsmap[i]->pt_pres /*&& !swap2ffsmap[i]->pt_dirty*/ ){
          return i;
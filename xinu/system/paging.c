@@ -1,6 +1,7 @@
 /* paging.c */
 
 #include <xinu.h>
+#include <stdlib.h>
 
 #define IRQPAGE 14
 
@@ -16,9 +17,26 @@ void	*maxvstack;
 uint32 n_static_pages;
 uint32 n_free_vpages;
 
-pt_t *ptmap[MAX_FSS_SIZE];
-pt_t *swap2ffsmap[MAX_SWAP_SIZE];
-uint32 ffs2swapmap[MAX_FSS_SIZE];
+uint32 npdptframes;
+uint32 nffsframes;
+uint32 nswapframes;
+uint32 nvstackframes;
+uint32 maxheapframes;
+
+uint32 npdcache;
+uint32 pdcachehits;
+uint32 pdcachemisses;
+local uint32 pdcache[PDCACHE];    /* directory frames ready for reuse */
+
+uint32 nvstkcache;
+uint32 vstkcachehits;
+local uint32 vstkcache[VSTKCACHE];    /* stack page tables ready for reuse */
+local uint32 vstkcachelen[VSTKCACHE]; /* stack pages mapped in each        */
+
+pt_t **ptmap;
+pt_t **swap2ffsmap;
+uint32 *ffs2swapmap;
+pid32 *ffs2pid;
 
 long kernel_sp_space[1024];
 long kernel_sp = &kernel_sp_space[1000];
@@ -39,6 +57,7 @@ void __init(struct	memblk *list, char *__start, uint32 listlength, void **minstr
 
    /* initialize to one block */
    list->mnext     = memptr = (struct memblk *)(minstruct);
+   list->mlength   = listlength;
    memptr->mlength = listlength;
    memptr->mnext   = (struct memblk *) NULL;
 
@@ -155,10 +174,29 @@ local syscall	_freemem(
    return OK;
 }
 
+// PD/PT and virtual stack frames cannot be swapped, so when either region
+// runs dry a victim process is killed (see oom.c) and the allocation is
+// retried. SYSERR is returned only when there is nothing left to kill.
+// Cached directories are given back first, as they cost nothing to rebuild
 uint32 getpdptframe(){
    uint32 frame;
-   frame = (uint32)_getfreemem(&pdptlist, PAGE_SIZE);
-   ASSERT( frame != SYSERR, "Out of pdpt memory!\n");
+   intmask mask;
+   while( (frame = (uint32)_getfreemem(&pdptlist, PAGE_SIZE)) == SYSERR ){
+      mask = disable();
+      if( npdcache > 0 ){
+         freepdptframe(pdcache[--npdcache]);
+         restore(mask);
+         continue;
+      }
+      if( vstk_cache_drain() == OK ){
+         restore(mask);
+         continue;
+      }
+      restore(mask);
+      if( oom_kill(currpid) == SYSERR ){
+         return SYSERR;
+      }
+   }
 
    // Align it
    frame >>= PAGE_OFFSET_BITS;
@@ -188,8 +226,14 @@ uint32 getswapframe(){
 
 uint32 getvstackframe(){
    uint32 frame;
-   frame = (uint32)_getfreemem(&vstacklist, PAGE_SIZE);
-   ASSERT( frame != SYSERR, "Out of virtual stack memory!" );
+   while( (frame = (uint32)_getfreemem(&vstacklist, PAGE_SIZE)) == SYSERR ){
+      if( vstk_cache_drain() == OK ){
+         continue;
+      }
+      if( oom_kill(currpid) == SYSERR ){
+         return SYSERR;
+      }
+   }
 
    // Align it
    frame >>= PAGE_OFFSET_BITS;
@@ -217,15 +261,124 @@ syscall freevstackframe(uint32 frame){
    return _freemem(&vstacklist, blkaddr, PAGE_SIZE, minvstack, maxvstack);
 }
 
-pdbr_t create_directory(){
+/*------------------------------------------------------------------------
+ * vstk_cache_get - map a cached stack of npages pages at vpage in dir by
+ *                  plugging its page table in. Every user stack starts
+ *                  at the first page above maxvstack, so the entries of
+ *                  the cached table are already where they belong
+ *------------------------------------------------------------------------
+ */
+status vstk_cache_get(pd_t *dir, uint32 vpage, uint32 npages){
+   pd_t *pd = &dir[vpage / N_PAGE_ENTRIES];
+   intmask mask;
+   uint32 i;
+
+   if( vpage != ceil_div( ((uint32)maxvstack + 1), PAGE_SIZE ) || pd->pd_pres ){
+      return SYSERR;
+   }
+   mask = disable();
+   for( i = 0; i < nvstkcache; i++ ){
+      if( vstkcachelen[i] == npages ){
+         break;
+      }
+   }
+   if( i == nvstkcache ){
+      restore(mask);
+      return SYSERR;
+   }
+   *((uint32*)pd) = 0;
+   pd->pd_pres    = 1;	/* page table present?		*/
+   pd->pd_write   = 1;	/* page is writable?		*/
+   pd->pd_pcd     = 1;	/* cache disable for this pt?	*/
+   pd->pd_base    = vstkcache[i];
+   nvstkcache--;
+   vstkcache[i]    = vstkcache[nvstkcache];
+   vstkcachelen[i] = vstkcachelen[nvstkcache];
+   vstkcachehits++;
+   restore(mask);
+   return OK;
+}
+
+/*------------------------------------------------------------------------
+ * vstk_cache_put - keep the stack of an exiting process if it is fully
+ *                  built and the cache has room; the caller then skips
+ *                  its pages and unhooks the table from the directory
+ *------------------------------------------------------------------------
+ */
+local bool8 vstk_cache_put(pid32 pid, pd_t *dir, uint32 vpage, uint32 npages){
+   struct procent *prptr = &proctab[pid];
+   pd_t *pd = &dir[vpage / N_PAGE_ENTRIES];
+   intmask mask;
+
+   if( !pd->pd_pres || prptr->nstk != npages
+         || (vpage % N_PAGE_ENTRIES) + npages > N_PAGE_ENTRIES ){
+      return FALSE;
+   }
+   mask = disable();
+   if( nvstkcache == VSTKCACHE ){
+      restore(mask);
+      return FALSE;
+   }
+   vstkcache[nvstkcache]    = pd->pd_base;
+   vstkcachelen[nvstkcache] = npages;
+   nvstkcache++;
+   restore(mask);
+   return TRUE;
+}
+
+/*------------------------------------------------------------------------
+ * vstk_cache_drain - give one cached stack's frames and page table back
+ *                    to their regions; SYSERR if the cache is empty
+ *------------------------------------------------------------------------
+ */
+status vstk_cache_drain(){
+   uint32 vbase, ptframe, npages, i;
+   pt_t *pt;
+   intmask mask;
+
+   mask = disable();
+   if( nvstkcache == 0 ){
+      restore(mask);
+      return SYSERR;
+   }
+   nvstkcache--;
+   ptframe = vstkcache[nvstkcache];
+   npages  = vstkcachelen[nvstkcache];
+   vbase   = ceil_div( ((uint32)maxvstack + 1), PAGE_SIZE ) % N_PAGE_ENTRIES;
+   pt      = (pt_t*)(ptframe << PAGE_OFFSET_BITS);
+   for( i = vbase; i < vbase + npages; i++ ){
+      freevstackframe(pt[i].pt_base);
+      *((uint32*)&pt[i]) = 0;
+   }
+   freepdptframe(ptframe);
+   restore(mask);
+   return OK;
+}
+
+status create_directory(pdbr_t *pdbrP){
    pdbr_t pdbr;
    uint32 dirframeno;
    uint32 i;
    uint32 *diruint;
    uint32 npages;
    uint32 nentries;
+   intmask mask;
+   bool8 cached;
 
-   dirframeno      = getpdptframe();
+   // A cached directory already holds the flat mapping and nothing else
+   mask            = disable();
+   dirframeno      = (npdcache > 0) ? pdcache[--npdcache] : SYSERR;
+   restore(mask);
+   cached          = (dirframeno != SYSERR);
+   if( !cached ){
+      pdcachemisses++;
+      dirframeno   = getpdptframe();
+      if( dirframeno == SYSERR ){
+         return SYSERR;
+      }
+   } else {
+      pdcachehits++;
+   }
    diruint         = (uint32*)(dirframeno << PAGE_OFFSET_BITS);
 
    pdbr.pdbr_mb1   = 0;
@@ -236,30 +389,34 @@ pdbr_t create_directory(){
    pdbr.pdbr_avail = 0;
    pdbr.pdbr_base  = dirframeno;
 
-   // Zero all 1k entries
-   for( i = 0; i < N_PAGE_ENTRIES; i++ ){
-      diruint[i] = 0;
-   }
-
-   // Allocate bare minimum pages a.k.a flat mapping
-   npages           = ceil_div( ((uint32)minpdpt), PAGE_SIZE );
-   nentries         = ceil_div( npages, N_PAGE_ENTRIES );
-   for( i = 0; i < nentries; i++ ){
-      create_directory_entry((pd_t*)&diruint[i], i, i*N_PAGE_ENTRIES, 0, N_PAGE_ENTRIES);
-   }
+   if( !cached ){
+      // Zero all 1k entries
+      page_zero( diruint );
+
+      // Allocate bare minimum pages a.k.a flat mapping
+      npages           = ceil_div( ((uint32)minpdpt), PAGE_SIZE );
+      nentries         = ceil_div( npages, N_PAGE_ENTRIES );
+      for( i = 0; i < nentries; i++ ){
+         if( create_directory_entry((pd_t*)&diruint[i], i, i*N_PAGE_ENTRIES, 0, N_PAGE_ENTRIES) == SYSERR ){
+            // Only nullproc allocates tables here, the rest share them
+            freepdptframe(dirframeno);
+            return SYSERR;
+         }
+      }
 
-   // For the very first time, nullproc will update this variable
-   if( n_static_pages == -1 ){
-      n_static_pages  = nentries;
+      // For the very first time, nullproc will update this variable
+      if( n_static_pages == -1 ){
+         n_static_pages  = nentries;
+      }
    }
-   return pdbr;
+   *pdbrP = pdbr;
+   return OK;
 }
 
 // nullproc_share_index: != -1 if an entry has to be shared from null proc directory (flatmap mem)
-void create_directory_entry(pd_t *pd, uint32 nullproc_share_index, uint32 phybaseaddr, uint32 ventrystart, uint32 nventries){
-   int i;
+status create_directory_entry(pd_t *pd, uint32 nullproc_share_index, uint32 phybaseaddr, uint32 ventrystart, uint32 nventries){
    pd_t   *nullprocdir;
-   uint32 *pageuint;
+   uint32 ptbase;
 
    pd->pd_pres	     = 1;	/* page table present?		*/
    pd->pd_write     = 1;	/* page is writable?		*/
@@ -272,22 +429,20 @@ void create_directory_entry(pd_t *pd, uint32 nullproc_share_index, uint32 phybas
    pd->pd_global    = 0;	/* global (ignored)		*/
    pd->pd_avail     = 0;	/* for programmer's use		*/
 
-   pageuint        = (uint32*)((uint32)pd->pd_base << PAGE_OFFSET_BITS);
-
-   // Flash clear all directory entries
-   // Zero all 1k entries
-   for( i = 0; i < N_PAGE_ENTRIES; i++ ){
-      pageuint[i] = 0;
-   }
-
    // Logic to share static page table amongst all processes
    if( n_static_pages != -1 && nullproc_share_index != -1 ){
       // Steal the entries from nullproc
       nullprocdir  = (pd_t*)((uint32)(proctab[0].pdbr.pdbr_base) << PAGE_OFFSET_BITS);
       pd->pd_base	 = nullprocdir[nullproc_share_index].pd_base;
    } else{
-      pd->pd_base	 = create_pagetable_entries(0, phybaseaddr, ventrystart, nventries);		/* location of page table?	*/
+      ptbase = create_pagetable_entries(0, phybaseaddr, ventrystart, nventries);
+      if( ptbase == SYSERR ){
+         pd->pd_pres = 0;
+         return SYSERR;
+      }
+      pd->pd_base	 = ptbase;		/* location of page table?	*/
    }
+   return OK;
 }
 
 uint32 create_pagetable_entries(uint32 ptbase, uint32 phybaseaddr, uint32 ventrystart, uint32 nventries){
@@ -297,6 +452,11 @@ uint32 create_pagetable_entries(uint32 ptbase, uint32 phybaseaddr, uint32 ventry
    // Allocate page frame if not allocated
    if( ptbase == 0 ){
       ptbase          = getpdptframe();
+      if( ptbase == SYSERR ){
+         return SYSERR;
+      }
+      // Flash clear all 1k entries of the new table
+      page_zero( (void*)(ptbase << PAGE_OFFSET_BITS) );
    }
    pt                 = (pt_t*)(ptbase << PAGE_OFFSET_BITS);
 
@@ -354,6 +514,7 @@ void destroy_directory(pid32 pid){
    pt_t *table;
    uint32 nstart, npages;
    int i, j;
+   intmask mask;
 
    // Destroy directory IFF user process
    if(!proctab[pid].pruser) return;
@@ -373,11 +534,20 @@ void destroy_directory(pid32 pid){
          }
          // Free the table
          ASSERT( freepdptframe(frame[i].pd_base) != SYSERR, "Unable to free PD/PT frame %08X\n", frame[i]);
+         *((uint32*)&frame[i]) = 0;
       }
    }
 
-   // Free directory
-   ASSERT(freepdptframe(dirno) != SYSERR, "Unable to free PD/PT directory");
+   // Keep the directory for the next vcreate if there is room; only the
+   // shared entries are left in it
+   mask = disable();
+   if( npdcache < PDCACHE ){
+      pdcache[npdcache++] = dirno;
+   } else {
+      ASSERT(freepdptframe(dirno) != SYSERR, "Unable to free PD/PT directory");
+   }
+   restore(mask);
+   proctab[pid].npt = 0;
 }
 
 void freevmem(pid32 pid){
@@ -386,12 +556,19 @@ void freevmem(pid32 pid){
    pd_t *frame     = (pd_t*)(dirno << PAGE_OFFSET_BITS);
    pt_t *table;
    virt_addr_t virt_addr;
-   uint32 npages, nstart, addr;
+   uint32 npages, nstart, addr, vbase, nstk;
+   bool8 keepstk;
    int i, j;
 
    // Destroy directory IFF user process
    if(!proctab[pid].pruser) return;
 
+   // Heap pages may share the stack's table: they are freed below while
+   // the stack pages stay mapped in it for the next vcreate
+   vbase   = ceil_div( ((uint32)maxvstack + 1), PAGE_SIZE );
+   nstk    = ceil_div( proctab[pid].prstklen, PAGE_SIZE );
+   keepstk = vstk_cache_put(pid, frame, vbase, nstk);
+
    // No need to free static pages as they are shared and nullproc
    // allocated them
    npages  = ceil_div( ((uint32)minffs), PAGE_SIZE );
@@ -407,41 +584,120 @@ void freevmem(pid32 pid){
                virt_addr.pd_offset = i;
                virt_addr.pt_offset = j;
                addr = *((uint32*)&virt_addr);
+               if( keepstk && (addr >> PAGE_OFFSET_BITS) >= vbase
+                     && (addr >> PAGE_OFFSET_BITS) < vbase + nstk ){
+                  continue;
+               }
                // Free any physical memory associated with it
-               free_vpage(frame, addr >> PAGE_OFFSET_BITS, FALSE);
+               free_vpage(pid, frame, addr >> PAGE_OFFSET_BITS, FALSE);
                ASSERT( !table[j].pt_pres, "Inconsistency in free at freevmem\n" );
             }
          }
       }
    }
+   if( keepstk ){
+      *((uint32*)&frame[vbase / N_PAGE_ENTRIES]) = 0;
+      proctab[pid].npt--;
+      proctab[pid].nstk = 0;
+   }
    n_free_vpages += proctab[pid].hsize - proctab[pid].vfree;
-   ASSERT( n_free_vpages >= 0 && n_free_vpages <= MAX_HEAP_SIZE, "Illegal value of n_free_vpages (=%d)\n", n_free_vpages );
+   ASSERT( n_free_vpages >= 0 && n_free_vpages <= maxheapframes, "Illegal value of n_free_vpages (=%d)\n", n_free_vpages );
 }
 
 
+/*------------------------------------------------------------------------
+ * size_paging - size the PD/PT, FFS, swap and virtual stack regions
+ *------------------------------------------------------------------------
+ */
+local void size_paging(){
+   uint32 memtop, base, kmapframes, avail;
+   char arg[16];
+
+   // Fixed layout unless the boot loader told us how much memory there is
+   npdptframes   = MAX_PT_SIZE;
+   nffsframes    = MAX_FSS_SIZE;
+   nswapframes   = MAX_SWAP_SIZE;
+   nvstackframes = MAX_STACK_SIZE;
+
+   memtop = bootmemtop > PAGING_MAXMEM ? PAGING_MAXMEM : bootmemtop;
+   base   = (uint32)maxheap + 1;
+   if( memtop > base ){
+      // The nullproc flat maps every region, one page table per 4MB
+      kmapframes  = ceil_div( memtop, PAGE_SIZE * N_PAGE_ENTRIES );
+      kmapframes += 1;
+      avail       = (memtop - base) / PAGE_SIZE;
+      if( avail > MAX_PT_SIZE + kmapframes + MAX_FSS_SIZE + MAX_SWAP_SIZE + MAX_STACK_SIZE ){
+         npdptframes   = MAX_PT_SIZE + kmapframes;
+         avail        -= npdptframes;
+         nffsframes    = avail * FFS_SHARE / 100;
+         nswapframes   = avail * SWAP_SHARE / 100;
+         nvstackframes = avail - nffsframes - nswapframes;
+      }
+   }
+
+   if( getbootarg("pdpt", arg, sizeof(arg)) == OK ){
+      npdptframes   = atoi(arg);
+   }
+   if( getbootarg("ffs", arg, sizeof(arg)) == OK ){
+      nffsframes    = atoi(arg);
+   }
+   if( getbootarg("swap", arg, sizeof(arg)) == OK ){
+      nswapframes   = atoi(arg);
+   }
+   if( getbootarg("vstack", arg, sizeof(arg)) == OK ){
+      nvstackframes = atoi(arg);
+   }
+
+   ASSERT( npdptframes > 0 && nffsframes > 0 && nswapframes > 0 && nvstackframes > 0, "Empty paging region\n" );
+   ASSERT( memtop <= base || base + (npdptframes + nffsframes + nswapframes + nvstackframes) * PAGE_SIZE <= memtop,
+         "Paging regions (%d frames) do not fit below 0x%08X\n", npdptframes + nffsframes + nswapframes + nvstackframes, memtop );
+
+   if( getbootarg("oombias", arg, sizeof(arg)) == OK ){
+      oom_prio_bias = atoi(arg);
+   }
+
+   maxheapframes = nffsframes + nswapframes;
+   kprintf("Paging: %d PD/PT, %d FFS, %d swap, %d vstack frames (memory top 0x%08X)\n",
+         npdptframes, nffsframes, nswapframes, nvstackframes, memtop);
+}
+
 void init_paging(){
    int i;
 
+   fpuinit();
+   pagecopy_init();
+   size_paging();
+
+   // Reverse maps are sized with the regions
+   ptmap       = (pt_t**)getmem( nffsframes * sizeof(pt_t*) );
+   ffs2swapmap = (uint32*)getmem( nffsframes * sizeof(uint32) );
+   ffs2pid     = (pid32*)getmem( nffsframes * sizeof(pid32) );
+   swap2ffsmap = (pt_t**)getmem( nswapframes * sizeof(pt_t*) );
+   ASSERT( (int32)ptmap != SYSERR && (int32)ffs2swapmap != SYSERR && (int32)swap2ffsmap != SYSERR
+         && (int32)ffs2pid != SYSERR,
+         "Out of heap for the paging maps\n" );
+
    // Init PD/PT
-   __init( &pdptlist, (char*)((uint32)maxheap + 1), PAGE_SIZE * MAX_PT_SIZE, &minpdpt, &maxpdpt );
+   __init( &pdptlist, (char*)((uint32)maxheap + 1), PAGE_SIZE * npdptframes, &minpdpt, &maxpdpt );
    n_static_pages = -1;
-   n_free_vpages  = MAX_HEAP_SIZE;
+   n_free_vpages  = maxheapframes;
 
    // Init FFS region
-   __init( &ffslist, (char*)((uint32)maxpdpt + 1), PAGE_SIZE * MAX_FSS_SIZE, &minffs, &maxffs );
-   for( i = 0; i < MAX_FSS_SIZE; i++){
+   __init( &ffslist, (char*)((uint32)maxpdpt + 1), PAGE_SIZE * nffsframes, &minffs, &maxffs );
+   for( i = 0; i < nffsframes; i++){
       ptmap[i]       = NULL;
       ffs2swapmap[i] = -1;
+      ffs2pid[i]     = -1;
    }
-   for( i = 0; i < MAX_SWAP_SIZE; i++){
+   for( i = 0; i < nswapframes; i++){
       swap2ffsmap[i] = NULL;
    }
 
    // Init swap region
-   __init( &swaplist, (char*)((uint32)maxffs + 1), PAGE_SIZE * MAX_SWAP_SIZE, &minswap, &maxswap );
+   __init( &swaplist, (char*)((uint32)maxffs + 1), PAGE_SIZE * nswapframes, &minswap, &maxswap );
 
    // Init virtual stack region
-   __init( &vstacklist, (char*)((uint32)maxswap + 1), PAGE_SIZE * MAX_STACK_SIZE, &minvstack, &maxvstack );
+   __init( &vstacklist, (char*)((uint32)maxswap + 1), PAGE_SIZE * nvstackframes, &minvstack, &maxvstack );
 
    /* Set interrupt vector for the pagefault to invoke pagefault_handler_disp */
    set_evec(IRQPAGE, (uint32)pagefault_handler_disp);
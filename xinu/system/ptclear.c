@@ -33,8 +33,8 @@ void	_ptclear(
 
 		/* Link entire message list into the free list */
 
-                (ptptr->pttail)->ptnext = ptfree;
-                ptfree = ptptr->pthead;
+                (ptptr->pttail)->ptnext = ptptr->ptfree;
+                ptptr->ptfree = ptptr->pthead;
         }
 
 	if (newstate == PT_ALLOC) {
@@ -44,6 +44,11 @@ void	_ptclear(
 	} else {
 		semdelete(ptptr->ptssem);
 		semdelete(ptptr->ptrsem);
+		if (ptptr->ptmaxcnt > 0) {
+			freemem((char *)ptptr->ptnodes,
+				ptptr->ptmaxcnt * sizeof(struct ptnode));
+		}
+		ptptr->ptnodes = ptptr->ptfree = NULL;
 	}
 	ptptr->ptstate = newstate;
 	return;
@@ -11,36 +11,43 @@ syscall	ptcreate(
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
-	int32	i;			/* Counts all possible ports	*/
-	int32	ptnum;			/* Candidate port number to try	*/
+	int32	ptnum;			/* Port number taken		*/
 	struct	ptentry	*ptptr;		/* Pointer to port table entry	*/
+	struct	ptnode	*nodes;		/* Message nodes for the port	*/
+	int32	j;			/* Index into nodes		*/
 
 	mask = disable();
-	if (count < 0) {
+	if (count < 0 || count > 0xffff || (ptnum = ptfreelist) == EMPTY) {
 		restore(mask);
 		return SYSERR;
 	}
+	ptptr= &porttab[ptnum];
 
-	for (i=0 ; i<NPORTS ; i++) {	/* Count all table entries	*/
-		ptnum = ptnextid;	/* Get an entry to check	*/
-		if (++ptnextid >= NPORTS) {
-			ptnextid = 0;	/* Reset for next iteration	*/
-		}
-
-		/* Check table entry that corresponds to ID ptnum */
+	/* Allocate one node for each message the port can hold and	*/
+	/*   link them into its free list				*/
 
-		ptptr= &porttab[ptnum];
-		if (ptptr->ptstate == PT_FREE) {
-			ptptr->ptstate = PT_ALLOC;
-			ptptr->ptssem = semcreate(count);
-			ptptr->ptrsem = semcreate(0);
-			ptptr->pthead = ptptr->pttail = NULL;
-			ptptr->ptseq++;
-			ptptr->ptmaxcnt = count;
+	nodes = NULL;
+	if (count > 0) {
+		nodes = (struct ptnode *)getmem(count * sizeof(struct ptnode));
+		if (nodes == (struct ptnode *)SYSERR) {
 			restore(mask);
-			return ptnum;
+			return SYSERR;
 		}
 	}
+	ptptr->ptnodes = ptptr->ptfree = nodes;
+	for (j = 0; j < count - 1; j++) {
+		nodes[j].ptnext = &nodes[j + 1];
+	}
+	if (count > 0) {
+		nodes[count - 1].ptnext = NULL;
+	}
+	ptfreelist = ptptr->ptnextfree;
+	ptptr->ptstate = PT_ALLOC;
+	ptptr->ptssem = semcreate(count);
+	ptptr->ptrsem = semcreate(0);
+	ptptr->pthead = ptptr->pttail = NULL;
+	ptptr->ptseq++;
+	ptptr->ptmaxcnt = count;
 	restore(mask);
-	return SYSERR;
+	return ptnum;
 }
@@ -21,7 +21,8 @@ syscall	ptdelete(
 		return SYSERR;
 	}
 	_ptclear(ptptr, PT_FREE, disp);
-	ptnextid = portid;
+	ptptr->ptnextfree = ptfreelist;	/* Reuse this entry first	*/
+	ptfreelist = portid;
 	restore(mask);
 	return OK;
 }
@@ -1,26 +1,55 @@
-/* ptrecv.c - ptrecv */
+/* ptrecv.c - ptrecv, ptrecvbuf, ptrecvn */
 
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  ptrecv  -  Receive a message from a port, blocking if port empty
+ *  ptdequeue  -  Take the first message from a port's list and return
+ *		    its node to the port (a message has been taken from
+ *		    the receiver semaphore)
  *------------------------------------------------------------------------
  */
-uint32	ptrecv(
-	  int32		portid		/* ID of port to use		*/
+local	uint32	ptdequeue(
+	  struct ptentry *ptptr,	/* Pointer to table entry	*/
+	  uint32	*lenp		/* Set to the length, or NULL	*/
+	)
+{
+	struct	ptnode	*msgnode;	/* First node on message list	*/
+	uint32	msg;			/* Message to return		*/
+
+	msgnode = ptptr->pthead;
+	msg = msgnode->ptmsg;
+	if (lenp != NULL) {
+		*lenp = msgnode->ptlen;
+	}
+	if (ptptr->pthead == ptptr->pttail)	/* Delete last item	*/
+		ptptr->pthead = ptptr->pttail = NULL;
+	else
+		ptptr->pthead = msgnode->ptnext;
+	msgnode->ptnext = ptptr->ptfree;	/* Return to free list	*/
+	ptptr->ptfree = msgnode;
+	return msg;
+}
+
+/*------------------------------------------------------------------------
+ *  ptrecvbuf  -  Receive a message and its length from a port, blocking
+ *		    if port empty
+ *------------------------------------------------------------------------
+ */
+char	*ptrecvbuf(
+	  int32		portid,		/* ID of port to use		*/
+	  uint32	*lenp		/* Set to the length, or NULL	*/
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
 	struct	ptentry	*ptptr;		/* Pointer to table entry	*/
 	int32	seq;			/* Local copy of sequence num.	*/
-	umsg32	msg;			/* Message to return		*/
-	struct	ptnode	*msgnode;	/* First node on message list	*/
+	uint32	msg;			/* Message to return		*/
 
 	mask = disable();
 	if ( isbadport(portid) ||
 	     (ptptr= &porttab[portid])->ptstate != PT_ALLOC ) {
 		restore(mask);
-		return (uint32)SYSERR;
+		return (char *)SYSERR;
 	}
 
 	/* Wait for message and verify that the port is still allocated */
@@ -29,20 +58,76 @@ uint32	ptrecv(
 	if (wait(ptptr->ptrsem) == SYSERR || ptptr->ptstate != PT_ALLOC
 	    || ptptr->ptseq != seq) {
 		restore(mask);
-		return (uint32)SYSERR;
+		return (char *)SYSERR;
 	}
 
 	/* Dequeue first message that is waiting in the port */
 
-	msgnode = ptptr->pthead;
-	msg = msgnode->ptmsg;
-	if (ptptr->pthead == ptptr->pttail)	/* Delete last item	*/
-		ptptr->pthead = ptptr->pttail = NULL;
-	else
-		ptptr->pthead = msgnode->ptnext;
-	msgnode->ptnext = ptfree;		/* Return to free list	*/
-	ptfree = msgnode;
+	msg = ptdequeue(ptptr, lenp);
 	signal(ptptr->ptssem);
 	restore(mask);
-	return msg;
+	return (char *)msg;
+}
+
+/*------------------------------------------------------------------------
+ *  ptrecv  -  Receive a message from a port, blocking if port empty
+ *------------------------------------------------------------------------
+ */
+uint32	ptrecv(
+	  int32		portid		/* ID of port to use		*/
+	)
+{
+	return (uint32)ptrecvbuf(portid, NULL);
+}
+
+/*------------------------------------------------------------------------
+ *  ptrecvn  -  Receive up to count messages (and lengths, unless lens
+ *		  is NULL), blocking only until the first one arrives;
+ *		  returns the number received
+ *------------------------------------------------------------------------
+ */
+int32	ptrecvn(
+	  int32		portid,		/* ID of port to use		*/
+	  umsg32	msgs[],		/* Array for the messages	*/
+	  uint32	lens[],		/* Array for lengths, or NULL	*/
+	  int32		count		/* Most messages to receive	*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	ptentry	*ptptr;		/* Pointer to table entry	*/
+	int32	seq;			/* Local copy of sequence num.	*/
+	int32	n;			/* Messages received		*/
+	int32	i;			/* Index into msgs		*/
+
+	mask = disable();
+	if ( isbadport(portid) || count < 1 ||
+	     (ptptr= &porttab[portid])->ptstate != PT_ALLOC ) {
+		restore(mask);
+		return SYSERR;
+	}
+
+	/* Wait for one message, then take the rest that are queued	*/
+
+	seq = ptptr->ptseq;		/* Record orignal sequence	*/
+	if (wait(ptptr->ptrsem) == SYSERR || ptptr->ptstate != PT_ALLOC
+	    || ptptr->ptseq != seq) {
+		restore(mask);
+		return SYSERR;
+	}
+	n = semtab[ptptr->ptrsem].scount;
+	if (n > count - 1) {
+		n = count - 1;
+	}
+	if (n < 0) {
+		n = 0;
+	}
+	semtab[ptptr->ptrsem].scount -= n;
+	n++;
+
+	for (i = 0; i < n; i++) {
+		msgs[i] = ptdequeue(ptptr, lens == NULL ? NULL : &lens[i]);
+	}
+	signaln(ptptr->ptssem, n);
+	restore(mask);
+	return n;
 }
@@ -1,21 +1,54 @@
-/* ptsend.c - ptsend */
+/* ptsend.c - ptsend, ptsendbuf, ptsendn */
 
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  ptsend  -  Send a message to a port by adding it to the queue
+ *  ptenqueue  -  Put a message on a port's list using one of its nodes
+ *		    (a slot has been taken from the sender semaphore)
  *------------------------------------------------------------------------
  */
-syscall	ptsend(
+local	void	ptenqueue(
+	  struct ptentry *ptptr,	/* Pointer to table entry	*/
+	  uint32	msg,		/* Message or buffer		*/
+	  uint32	len		/* Length of the buffer		*/
+	)
+{
+	struct	ptnode	*msgnode;	/* Allocated message node 	*/
+	struct	ptnode	*tailnode;	/* Last node in port or NULL	*/
+
+	/* Obtain node from free list by unlinking */
+
+	msgnode = ptptr->ptfree;	/* Point to first free node	*/
+	ptptr->ptfree = msgnode->ptnext;/* Unlink from the free list	*/
+	msgnode->ptnext = NULL;		/* Set fields in the node	*/
+	msgnode->ptmsg  = msg;
+	msgnode->ptlen  = len;
+
+	/* Link into queue for the specified port */
+
+	tailnode = ptptr->pttail;
+	if (tailnode == NULL) {		/* Queue for port was empty	*/
+		ptptr->pttail = ptptr->pthead = msgnode;
+	} else {			/* Insert new node at tail	*/
+		tailnode->ptnext = msgnode;
+		ptptr->pttail = msgnode;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  ptsendbuf  -  Send a buffer and its length to a port; the receiver
+ *		    owns the buffer once it is sent
+ *------------------------------------------------------------------------
+ */
+syscall	ptsendbuf(
 	  int32		portid,		/* ID of port to use		*/
-	  umsg32	msg		/* Message to send		*/
+	  char		*buf,		/* Buffer to hand over		*/
+	  uint32	len		/* Bytes used in the buffer	*/
 	)
 {
 	intmask	mask;			/* Saved interrupt mask		*/
 	struct	ptentry	*ptptr;		/* Pointer to table entry	*/
 	int32	seq;			/* Local copy of sequence num.	*/
-	struct	ptnode	*msgnode;	/* Allocated message node 	*/
-	struct	ptnode	*tailnode;	/* Last node in port or NULL	*/
 
 	mask = disable();
 	if ( isbadport(portid) ||
@@ -33,27 +66,89 @@ syscall	ptsend(
 		restore(mask);
 		return SYSERR;
 	}
-	if (ptfree == NULL) {
-		panic("Port system ran out of message nodes");
-	}
+	ptenqueue(ptptr, (uint32)buf, len);
+	signal(ptptr->ptrsem);
+	restore(mask);
+	return OK;
+}
 
-	/* Obtain node from free list by unlinking */
+/*------------------------------------------------------------------------
+ *  ptsend  -  Send a message to a port by adding it to the queue
+ *------------------------------------------------------------------------
+ */
+syscall	ptsend(
+	  int32		portid,		/* ID of port to use		*/
+	  umsg32	msg		/* Message to send		*/
+	)
+{
+	return ptsendbuf(portid, (char *)msg, 0);
+}
 
-	msgnode = ptfree;		/* Point to first free node	*/
-	ptfree  = msgnode->ptnext;	/* Unlink from the free list	*/
-	msgnode->ptnext = NULL;		/* Set fields in the node	*/
-	msgnode->ptmsg  = msg;
+/*------------------------------------------------------------------------
+ *  ptsendn  -  Send count messages (and lengths, unless lens is NULL),
+ *		  taking every free slot at once and blocking only when
+ *		  the port is full; if the port is reset or deleted part
+ *		  way through, return the number already sent (SYSERR
+ *		  only if none were)
+ *------------------------------------------------------------------------
+ */
+syscall	ptsendn(
+	  int32		portid,		/* ID of port to use		*/
+	  umsg32	msgs[],		/* Messages or buffers to send	*/
+	  uint32	lens[],		/* Their lengths, or NULL	*/
+	  int32		count		/* Number of messages		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	ptentry	*ptptr;		/* Pointer to table entry	*/
+	int32	seq;			/* Local copy of sequence num.	*/
+	int32	sent = 0;		/* Messages queued so far	*/
+	int32	batch = 0;		/* Queued but not yet signaled	*/
+	int32	n;			/* Slots taken in one step	*/
+	int32	i;			/* Index within a step		*/
 
-	/* Link into queue for the specified port */
+	mask = disable();
+	if ( isbadport(portid) || count < 0 ||
+	     (ptptr= &porttab[portid])->ptstate != PT_ALLOC ) {
+		restore(mask);
+		return SYSERR;
+	}
+	seq = ptptr->ptseq;		/* Record original sequence	*/
 
-	tailnode = ptptr->pttail;
-	if (tailnode == NULL) {		/* Queue for port was empty	*/
-		ptptr->pttail = ptptr->pthead = msgnode;
-	} else {			/* Insert new node at tail	*/
-		tailnode->ptnext = msgnode;
-		ptptr->pttail = msgnode;
+	while (sent < count) {
+		n = semtab[ptptr->ptssem].scount;
+		if (n > 0) {		/* Take all free slots needed	*/
+			if (n > count - sent) {
+				n = count - sent;
+			}
+			semtab[ptptr->ptssem].scount -= n;
+		} else {
+
+			/* Port is full: let receivers have what is	*/
+			/*   queued, then wait for one slot		*/
+
+			if (batch > 0) {
+				signaln(ptptr->ptrsem, batch);
+				batch = 0;
+			}
+			if (wait(ptptr->ptssem) == SYSERR
+			    || ptptr->ptstate != PT_ALLOC
+			    || ptptr->ptseq != seq) {
+				restore(mask);
+				return sent > 0 ? sent : SYSERR;
+			}
+			n = 1;
+		}
+		for (i = 0; i < n; i++) {
+			ptenqueue(ptptr, msgs[sent + i],
+				  lens == NULL ? 0 : lens[sent + i]);
+		}
+		sent += n;
+		batch += n;
+	}
+	if (batch > 0) {
+		signaln(ptptr->ptrsem, batch);
 	}
-	signal(ptptr->ptrsem);
 	restore(mask);
-	return OK;
+	return count;
 }
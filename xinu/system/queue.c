@@ -2,7 +2,7 @@
 
 #include <xinu.h>
 
-struct qentry	queuetab[NQENT];	/* Table of process queues	*/
+struct qentry	*queuetab;		/* Table of process queues	*/
 
 /*------------------------------------------------------------------------
  *  enqueue  -  Insert a process at the tail of a queue
@@ -2,8 +2,6 @@
 
 #include <xinu.h>
 
-qid16	readylist;			/* Index of ready list		*/
-
 /*------------------------------------------------------------------------
  *  ready  -  Make a process eligible for CPU service
  *------------------------------------------------------------------------
@@ -22,7 +20,10 @@ status	ready(
 
 	prptr = &proctab[pid];
 	prptr->prstate = PR_READY;
-	insert(pid, readylist, prptr->prprio);
+	if (traceon) {
+		tracewake(pid);
+	}
+	readyinsert(pid, prptr->prprio);
 	resched();
 
 	return OK;
@@ -0,0 +1,187 @@
+/* readyq.c - readyinit, readyinsert, readyremove, readystrictkey,	*/
+/*		readyfirstkey, readydequeue				*/
+
+#include <xinu.h>
+
+struct	readyq	readyq;			/* Ready processes by priority	*/
+
+/*------------------------------------------------------------------------
+ *  msbit  -  Index of the most significant bit set in a nonzero word
+ *------------------------------------------------------------------------
+ */
+local	uint32	msbit(
+	  uint32	x		/* Word to scan (nonzero)	*/
+	)
+{
+	uint32	bit;			/* Index of the bit found	*/
+
+	asm("bsrl %1, %0" : "=r" (bit) : "rm" (x));
+	return bit;
+}
+
+/*------------------------------------------------------------------------
+ *  readyinit  -  Initialize the ready list to empty
+ *------------------------------------------------------------------------
+ */
+void	readyinit(void)
+{
+	int32	i;			/* Index into the tables	*/
+
+	readyq.rqtop = 0;
+	for (i = 0; i < RDYWORDS / 32; i++) {
+		readyq.rqmid[i] = 0;
+	}
+	for (i = 0; i < RDYWORDS; i++) {
+		readyq.rqbits[i] = 0;
+	}
+	for (i = 0; i < NRDYPRIO; i++) {
+		readyq.rqhead[i] = EMPTY;
+		readyq.rqtail[i] = EMPTY;
+	}
+	readyq.rqcount = 0;
+}
+
+/*------------------------------------------------------------------------
+ *  readyinsert  -  Add a process at the tail of its priority's FIFO
+ *			(assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+status	readyinsert(
+	  pid32		pid,		/* ID of process to insert	*/
+	  pri16		prio		/* Priority to queue it at	*/
+	)
+{
+	qid16	tail;			/* Last process at this prio	*/
+	uint32	word;			/* Index into rqbits		*/
+
+	if (isbadpid(pid) || prio < 0) {
+		return SYSERR;
+	}
+	if (proctab[pid].prfair) {	/* Queued by pass, not prio	*/
+		return fairinsert(pid);
+	}
+
+	tail = readyq.rqtail[prio];
+	queuetab[pid].qkey  = prio;
+	queuetab[pid].qnext = EMPTY;
+	queuetab[pid].qprev = tail;
+	if (tail == EMPTY) {
+
+		/* First process at this priority: mark it in the bitmap */
+
+		readyq.rqhead[prio] = pid;
+		word = prio >> 5;
+		readyq.rqbits[word] |= 1 << (prio & 31);
+		readyq.rqmid[word >> 5] |= 1 << (word & 31);
+		readyq.rqtop |= 1 << (word >> 5);
+	} else {
+		queuetab[tail].qnext = pid;
+	}
+	readyq.rqtail[prio] = pid;
+	readyq.rqcount++;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  readyremove  -  Remove a process from the ready list
+ *			(assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+pid32	readyremove(
+	  pid32		pid		/* ID of process to remove	*/
+	)
+{
+	int32	prio;			/* Priority it was queued at	*/
+	qid16	prev, next;		/* Neighbours in the FIFO	*/
+	uint32	word;			/* Index into rqbits		*/
+
+	if (proctab[pid].prfair) {
+		return fairremove(pid);
+	}
+
+	prio = queuetab[pid].qkey;	/* chprio may have changed the	*/
+	prev = queuetab[pid].qprev;	/*   process's own priority	*/
+	next = queuetab[pid].qnext;
+
+	if (prev == EMPTY) {
+		readyq.rqhead[prio] = next;
+	} else {
+		queuetab[prev].qnext = next;
+	}
+	if (next == EMPTY) {
+		readyq.rqtail[prio] = prev;
+	} else {
+		queuetab[next].qprev = prev;
+	}
+
+	/* Clear the bitmap bits that no longer have a process under them */
+
+	if (readyq.rqhead[prio] == EMPTY) {
+		word = prio >> 5;
+		readyq.rqbits[word] &= ~(1 << (prio & 31));
+		if (readyq.rqbits[word] == 0) {
+			readyq.rqmid[word >> 5] &= ~(1 << (word & 31));
+			if (readyq.rqmid[word >> 5] == 0) {
+				readyq.rqtop &= ~(1 << (word >> 5));
+			}
+		}
+	}
+
+	queuetab[pid].qnext = EMPTY;
+	queuetab[pid].qprev = EMPTY;
+	readyq.rqcount--;
+	return pid;
+}
+
+/*------------------------------------------------------------------------
+ *  readystrictkey  -  Highest priority of a ready process outside the
+ *			 fair-share class (MINKEY if there is none)
+ *------------------------------------------------------------------------
+ */
+int32	readystrictkey(void)
+{
+	uint32	top, mid, word;		/* Bit found at each level	*/
+
+	if (readyempty()) {
+		return (int32)MINKEY;
+	}
+	top = msbit(readyq.rqtop);
+	mid = msbit(readyq.rqmid[top]);
+	word = (top << 5) | mid;
+	return (word << 5) | msbit(readyq.rqbits[word]);
+}
+
+/*------------------------------------------------------------------------
+ *  readyfirstkey  -  Highest priority on the ready list, counting the
+ *			fair-share class at fairprio (MINKEY if empty)
+ *------------------------------------------------------------------------
+ */
+int32	readyfirstkey(void)
+{
+	int32	key;			/* Highest strict priority	*/
+
+	key = readystrictkey();
+	if (nfair > 0 && fairprio > key) {
+		return fairprio;
+	}
+	return key;
+}
+
+/*------------------------------------------------------------------------
+ *  readydequeue  -  Remove and return the first process at the highest
+ *			priority (EMPTY if there is none)
+ *------------------------------------------------------------------------
+ */
+pid32	readydequeue(void)
+{
+	int32	key;			/* Highest strict priority	*/
+
+	key = readystrictkey();
+	if (nfair > 0 && fairprio > key) {
+		return fairdequeue();
+	}
+	if (readyempty()) {
+		return EMPTY;
+	}
+	return readyremove(readyq.rqhead[key]);
+}
@@ -4,6 +4,7 @@
 
 /*------------------------------------------------------------------------
  *  recvtime  -  Wait specified time to receive a message and return
+ *		  (a maxwait of 0 polls)
  *------------------------------------------------------------------------
  */
 umsg32	recvtime(
@@ -23,7 +24,12 @@ umsg32	recvtime(
 
 	prptr = &proctab[currpid];
 	if (prptr->prhasmsg == FALSE) {	/* Delay if no message waiting	*/
-		if (insertd(currpid,sleepq,maxwait) == SYSERR) {
+		if (maxwait == 0) {	/* Caller only polls		*/
+			restore(mask);
+			return TIMEOUT;
+		}
+		if (tmrset(&proctimer[currpid], maxwait, wakeup,
+						currpid) == SYSERR) {
 			restore(mask);
 			return SYSERR;
 		}
@@ -20,28 +20,52 @@ void	resched(void)		/* Assumes interrupts are disabled	*/
 		return;
 	}
 
+	/* Leaving the null process: restart the tick it stopped */
+
+	if (clkstopped) {
+		clkwake(FALSE);
+	}
+
 	/* Point to process table entry for the current (old) process */
 
 	ptold = &proctab[currpid];
    oldpid = currpid;
 
+	/* A fair-share process pays for the CPU it has used */
+
+	if (ptold->prfair) {
+		faircharge(currpid);
+	}
+
 	if (ptold->prstate == PR_CURR) {  /* Process remains eligible */
-		if (ptold->prprio > firstkey(readylist)) {
+		if (ptold->prfair ? fairkeep(currpid)
+				  : ptold->prprio > readyfirstkey()) {
 			return;
 		}
 
 		/* Old process will no longer remain current */
 
 		ptold->prstate = PR_READY;
-		insert(currpid, readylist, ptold->prprio);
+		readyinsert(currpid, ptold->prprio);
 	}
 
+	/* Charge the old process the ticks it ran since it started	*/
+
+	acctswitch(ptold, ptold->prstate == PR_READY);
+
 	/* Force context switch to highest priority ready process */
 
-	currpid = dequeue(readylist);
+	currpid = readydequeue();
 	ptnew = &proctab[currpid];
 	ptnew->prstate = PR_CURR;
+	ptnew->prstart = getticks();	/* Start of the fair-share charge */
 	preempt = QUANTUM;		/* Reset time slice for process	*/
+	if (traceon) {
+		tracerun(currpid);
+	}
+	if (fpuenabled) {
+		fpuswitch(currpid);	/* Trap its first FPU use	*/
+	}
 
    // Swap the pdbr of new process so that we can remove
    // directory of killed processes
@@ -0,0 +1,178 @@
+/* rwlock.c - rwinit, rwdelete, rwrdwait, rwwrwait, rwrdwake, rwwrwake	*/
+
+#include <xinu.h>
+
+/*------------------------------------------------------------------------
+ *  rwinit  -  Initialize a reader-writer lock as free
+ *------------------------------------------------------------------------
+ */
+syscall	rwinit(
+	  struct rwlock	*rw		/* Lock to initialize		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	qid16	q;			/* Wait queue for the lock	*/
+
+	mask = disable();
+	if ((q = lockqget()) == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	rw->rwstate = 0;
+	rw->rwqueue = q;
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  rwdelete  -  Give back the wait queue of a rwlock nobody holds
+ *------------------------------------------------------------------------
+ */
+syscall	rwdelete(
+	  struct rwlock	*rw		/* Lock to delete		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (rw->rwstate != 0 || isbadqid(rw->rwqueue)) {
+		restore(mask);
+		return SYSERR;
+	}
+	lockqput(rw->rwqueue);
+	rw->rwqueue = EMPTY;
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  rwblock  -  Queue the current process on a rwlock until a release
+ *		  hands it the lock (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	rwblock(
+	  struct rwlock	*rw,		/* Lock to wait for		*/
+	  int32		how		/* RW_READ or RW_WRITE		*/
+	)
+{
+	rw->rwstate |= RW_WAITERS;
+	proctab[currpid].prstate = PR_LOCK;
+	enqueue(currpid, rw->rwqueue);
+	queuetab[currpid].qkey = how;	/* FIFO queue: key is free	*/
+	resched();
+}
+
+/*------------------------------------------------------------------------
+ *  rwgrant  -  Hand a rwlock nobody holds to the writer at the head of
+ *		  its queue, or to every reader ahead of the first writer
+ *		  (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	rwgrant(
+	  struct rwlock	*rw		/* Lock being released		*/
+	)
+{
+	qid16	q = rw->rwqueue;	/* Processes waiting		*/
+
+	rw->rwstate = 0;
+	resched_cntl(DEFER_START);
+	if (nonempty(q) && firstkey(q) == RW_WRITE) {
+		rw->rwstate = RW_WRITER;
+		ready(dequeue(q));
+	} else {
+		while (nonempty(q) && firstkey(q) == RW_READ) {
+			rw->rwstate++;
+			ready(dequeue(q));
+		}
+	}
+	if (nonempty(q)) {
+		rw->rwstate |= RW_WAITERS;
+	}
+	resched_cntl(DEFER_STOP);
+}
+
+/*------------------------------------------------------------------------
+ *  rwrdwait  -  Slow path of rwrdacquire: a writer holds the lock or
+ *		   processes wait for it
+ *------------------------------------------------------------------------
+ */
+syscall	rwrdwait(
+	  struct rwlock	*rw		/* Lock to acquire		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (!(rw->rwstate & RW_WRITER) && isempty(rw->rwqueue)) {
+		rw->rwstate = (rw->rwstate & RW_READERS) + 1;
+		restore(mask);
+		return OK;
+	}
+	rwblock(rw, RW_READ);
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  rwwrwait  -  Slow path of rwwracquire: the lock is held
+ *------------------------------------------------------------------------
+ */
+syscall	rwwrwait(
+	  struct rwlock	*rw		/* Lock to acquire		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if ((rw->rwstate & ~RW_WAITERS) == 0 && isempty(rw->rwqueue)) {
+		rw->rwstate = RW_WRITER;
+		restore(mask);
+		return OK;
+	}
+	rwblock(rw, RW_WRITE);
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  rwrdwake  -  Slow path of rwrdrelease: processes wait, so the last
+ *		   reader out hands the lock on
+ *------------------------------------------------------------------------
+ */
+syscall	rwrdwake(
+	  struct rwlock	*rw		/* Lock to release		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if ((rw->rwstate & RW_READERS) == 0) {	/* No reader holds it	*/
+		restore(mask);
+		return SYSERR;
+	}
+	if ((--rw->rwstate & RW_READERS) == 0) {
+		rwgrant(rw);
+	}
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  rwwrwake  -  Slow path of rwwrrelease: hand the lock on
+ *------------------------------------------------------------------------
+ */
+syscall	rwwrwake(
+	  struct rwlock	*rw		/* Lock to release		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (!(rw->rwstate & RW_WRITER)) {
+		restore(mask);
+		return SYSERR;
+	}
+	rwgrant(rw);
+	restore(mask);
+	return OK;
+}
@@ -1,9 +1,14 @@
-/* semcreate.c - semcreate, newsem */
+/* semcreate.c - semcreate, newsem, freesem */
 
 #include <xinu.h>
 
 local	sid32	newsem(void);
 
+/* Free semaphores are kept in a FIFO list linked through snextfree	*/
+
+local	sid32	semfirst = EMPTY;	/* Next ID newsem hands out	*/
+local	sid32	semlast = EMPTY;	/* Last ID freed		*/
+
 /*------------------------------------------------------------------------
  *  semcreate  -  Create a new semaphore and return the ID to the caller
  *------------------------------------------------------------------------
@@ -33,18 +38,34 @@ sid32	semcreate(
  */
 local	sid32	newsem(void)
 {
-	static	sid32	nextsem = 0;	/* Next semaphore index to try	*/
 	sid32	sem;			/* Semaphore ID to return	*/
-	int32	i;			/* Iterate through # entries	*/
-
-	for (i=0 ; i<NSEM ; i++) {
-		sem = nextsem++;
-		if (nextsem >= NSEM)
-			nextsem = 0;
-		if (semtab[sem].sstate == S_FREE) {
-			semtab[sem].sstate = S_USED;
-			return sem;
-		}
+
+	if ((sem = semfirst) == EMPTY) {
+		return SYSERR;
+	}
+	semfirst = semtab[sem].snextfree;
+	if (semfirst == EMPTY) {
+		semlast = EMPTY;
+	}
+	semtab[sem].sstate = S_USED;
+	return sem;
+}
+
+/*------------------------------------------------------------------------
+ *  freesem  -  Mark a semaphore table entry free and put it at the end
+ *		  of the free list (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	freesem(
+	  sid32		sem		/* ID of the entry to free	*/
+	)
+{
+	semtab[sem].sstate = S_FREE;
+	semtab[sem].snextfree = EMPTY;
+	if (semlast == EMPTY) {
+		semfirst = sem;
+	} else {
+		semtab[semlast].snextfree = sem;
 	}
-	return SYSERR;
+	semlast = sem;
 }
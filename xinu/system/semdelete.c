@@ -24,7 +24,7 @@ syscall	semdelete(
 		restore(mask);
 		return SYSERR;
 	}
-	semptr->sstate = S_FREE;
+	freesem(sem);
 
 	resched_cntl(DEFER_START);
 	while (semptr->scount++ < 0) {	/* Free all waiting processes	*/
@@ -35,6 +35,8 @@ syscall	send(
 	} else if (prptr->prstate == PR_RECTIM) {
 		unsleep(pid);
 		ready(pid);
+	} else if (prptr->prstate == PR_EVENT) {
+		evnotify(EV_MSG, pid);
 	}
 	restore(mask);		/* Restore interrupts */
 	return OK;
@@ -25,6 +25,8 @@ syscall	signal(
 	}
 	if ((semptr->scount++) < 0) {	/* Release a waiting process */
 		ready(dequeue(semptr->squeue));
+	} else if (nevwaiters > 0) {	/* Count is now positive	*/
+		evnotify(EV_SEM, sem);
 	}
 	restore(mask);
 	return OK;
@@ -31,6 +31,9 @@ syscall	signaln(
 			ready(dequeue(semptr->squeue));
 		}
 	}
+	if (semptr->scount > 0 && nevwaiters > 0) {
+		evnotify(EV_SEM, sem);
+	}
 	resched_cntl(DEFER_STOP);
 	restore(mask);
 	return OK;
@@ -0,0 +1,184 @@
+/* slab.c - slabinit, slabclass, slabround, slabget, slabput,		*/
+/*	    slabreclaim							*/
+
+#include <xinu.h>
+
+struct	slabcache slabtab[NSLAB];	/* One cache per size class	*/
+
+/* Class sizes grow by about 1.5 so internal fragmentation stays	*/
+/*   under a third; 1536 holds an Ethernet frame			*/
+
+local	uint32	slabsizes[NSLAB] = {
+	16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024,
+	1536, 2048, 3072, 4096, 6144, 8192 };
+
+local	byte	slabindex[SLABMAX / SLABQUANT + 1]; /* Class for each	*/
+					/*   multiple of SLABQUANT	*/
+
+/*------------------------------------------------------------------------
+ *  slabinit  -  Set up empty caches and the size-to-class table
+ *------------------------------------------------------------------------
+ */
+void	slabinit(void)
+{
+	int32	i;			/* Index into slabindex		*/
+	int32	cls = 0;		/* Class for that size		*/
+
+	for (i = 0; i < NSLAB; i++) {
+		slabtab[i].scsize = slabsizes[i];
+		slabtab[i].scfree = NULL;
+	}
+	for (i = 0; i <= SLABMAX / SLABQUANT; i++) {
+		while (slabsizes[cls] < i * SLABQUANT) {
+			cls++;
+		}
+		slabindex[i] = cls;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  slabclass  -  Size class for a request, or SYSERR if it is too big
+ *------------------------------------------------------------------------
+ */
+int32	slabclass(
+	  uint32	nbytes		/* Size requested		*/
+	)
+{
+	if (nbytes == 0 || nbytes > SLABMAX) {
+		return SYSERR;
+	}
+	return slabindex[(nbytes + SLABQUANT - 1) / SLABQUANT];
+}
+
+/*------------------------------------------------------------------------
+ *  slabround  -  Bytes actually allocated for a request of nbytes
+ *------------------------------------------------------------------------
+ */
+uint32	slabround(
+	  uint32	nbytes		/* Size requested		*/
+	)
+{
+	int32	cls;			/* Size class of the request	*/
+
+	if ((cls = slabclass(nbytes)) == SYSERR) {
+		return (uint32) roundmb(nbytes);
+	}
+	return slabtab[cls].scsize;
+}
+
+/*------------------------------------------------------------------------
+ *  slabrefill  -  Carve a chunk of the free list into objects of a
+ *		     class (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	status	slabrefill(
+	  struct slabcache *scptr	/* Cache to fill		*/
+	)
+{
+	char	*chunk;			/* Memory taken from the list	*/
+	uint32	nobj;			/* Objects in the chunk		*/
+	uint32	i;			/* Object index			*/
+	struct	memblk	*obj;		/* Object being cached		*/
+
+	nobj = SLABCHUNK / scptr->scsize;
+	if (nobj < 2) {
+		nobj = 2;
+	}
+	chunk = heapget(nobj * scptr->scsize);
+	if (chunk == (char *)SYSERR) {
+
+		/* Short of memory: take just one object, giving back	*/
+		/*   what the other caches hold if need be		*/
+
+		nobj = 1;
+		chunk = heapget(scptr->scsize);
+		if (chunk == (char *)SYSERR && slabreclaim() > 0) {
+			chunk = heapget(scptr->scsize);
+		}
+		if (chunk == (char *)SYSERR) {
+			return SYSERR;
+		}
+	}
+	for (i = 0; i < nobj; i++) {
+		obj = (struct memblk *)(chunk + i * scptr->scsize);
+		obj->mnext = scptr->scfree;
+		scptr->scfree = obj;
+	}
+	scptr->scnfree += nobj;
+	scptr->screfills++;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  slabget  -  Take an object of a class (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+char	*slabget(
+	  int32		cls,		/* Size class			*/
+	  uint32	nbytes		/* Size requested (for stats)	*/
+	)
+{
+	struct	slabcache *scptr;	/* Cache of the class		*/
+	struct	memblk	*obj;		/* Object handed out		*/
+
+	scptr = &slabtab[cls];
+	scptr->scallocs++;
+	if (scptr->scfree != NULL) {
+		scptr->schits++;
+	} else if (slabrefill(scptr) == SYSERR) {
+		return (char *)SYSERR;
+	}
+	obj = scptr->scfree;
+	scptr->scfree = obj->mnext;
+	scptr->scnfree--;
+	scptr->scinuse++;
+	scptr->screq += (uint32) roundmb(nbytes);
+	return (char *)obj;
+}
+
+/*------------------------------------------------------------------------
+ *  slabput  -  Return an object to its class (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	slabput(
+	  int32		cls,		/* Size class			*/
+	  char		*blkaddr,	/* Object being freed		*/
+	  uint32	nbytes		/* Size requested (for stats)	*/
+	)
+{
+	struct	slabcache *scptr;	/* Cache of the class		*/
+	struct	memblk	*obj;		/* Object being freed		*/
+
+	scptr = &slabtab[cls];
+	obj = (struct memblk *)blkaddr;
+	obj->mnext = scptr->scfree;
+	scptr->scfree = obj;
+	scptr->scnfree++;
+	scptr->scinuse--;
+	scptr->screq -= (uint32) roundmb(nbytes);
+}
+
+/*------------------------------------------------------------------------
+ *  slabreclaim  -  Give every cached object back to the free list;
+ *		      returns the number of bytes given back
+ *		      (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+uint32	slabreclaim(void)
+{
+	struct	slabcache *scptr;	/* Cache being emptied		*/
+	struct	memblk	*obj;		/* Object being returned	*/
+	uint32	nbytes = 0;		/* Bytes returned		*/
+	int32	cls;			/* Index into slabtab		*/
+
+	for (cls = 0; cls < NSLAB; cls++) {
+		scptr = &slabtab[cls];
+		while ((obj = scptr->scfree) != NULL) {
+			scptr->scfree = obj->mnext;
+			heapfree((char *)obj, scptr->scsize);
+			nbytes += scptr->scsize;
+		}
+		scptr->scnfree = 0;
+	}
+	return nbytes;
+}
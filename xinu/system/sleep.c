@@ -41,7 +41,7 @@ syscall	sleepms(
 	/* Delay calling process */
 
 	mask = disable();
-	if (insertd(currpid, sleepq, delay) == SYSERR) {
+	if (tmrset(&proctimer[currpid], delay, wakeup, currpid) == SYSERR) {
 		restore(mask);
 		return SYSERR;
 	}
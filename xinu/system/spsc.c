@@ -0,0 +1,177 @@
+/* spsc.c - spscinit, spscdelete, spscenq, spscdeq, spscput, spscget	*/
+
+#include <xinu.h>
+
+/* Order the ring's memory accesses: a locked add is a full barrier	*/
+/*   on the i586 (there is no mfence), and the clobber stops the	*/
+/*   compiler from moving loads or stores across it			*/
+
+#define	spfence()	asm volatile("lock; addl $0, 0(%%esp)" : : : "memory")
+
+/*------------------------------------------------------------------------
+ *  spscinit  -  Initialize an empty ring over nslots words of storage
+ *------------------------------------------------------------------------
+ */
+status	spscinit(
+	  struct spsc	*r,		/* Ring to initialize		*/
+	  uint32	*slots,		/* Storage for the words	*/
+	  uint32	nslots		/* Size, a power of two		*/
+	)
+{
+	if (nslots == 0 || (nslots & (nslots - 1)) != 0) {
+		return SYSERR;
+	}
+	r->sphead = r->sptail = 0;
+	r->spmask = nslots - 1;
+	r->spslots = slots;
+	r->spgetwait = r->spputwait = FALSE;
+	r->spgetsem = semcreate(0);
+	r->spputsem = semcreate(0);
+	if (r->spgetsem == SYSERR || r->spputsem == SYSERR) {
+		semdelete(r->spgetsem);
+		semdelete(r->spputsem);
+		return SYSERR;
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  spscdelete  -  Release a ring's semaphores, waking a blocked side
+ *------------------------------------------------------------------------
+ */
+status	spscdelete(
+	  struct spsc	*r		/* Ring to delete		*/
+	)
+{
+	semdelete(r->spgetsem);
+	semdelete(r->spputsem);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  spscwake  -  Signal a side that blocked, if it still is
+ *------------------------------------------------------------------------
+ */
+local	void	spscwake(
+	  volatile bool8 *waitp,	/* That side's wait flag	*/
+	  sid32		sem		/* Where it blocks		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	if (*waitp) {
+		*waitp = FALSE;
+		signal(sem);
+	}
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  spscenq  -  Add a word without blocking; SYSERR if the ring is full
+ *		  (producer only)
+ *------------------------------------------------------------------------
+ */
+status	spscenq(
+	  struct spsc	*r,		/* Ring to add to		*/
+	  uint32	word		/* Word to add			*/
+	)
+{
+	uint32	tail = r->sptail;	/* Only the producer writes it	*/
+
+	if (tail - r->sphead > r->spmask) {
+		return SYSERR;
+	}
+	r->spslots[tail & r->spmask] = word;
+	spfence();
+	r->sptail = tail + 1;
+
+	/* The tail must be visible before the flag is read, or a	*/
+	/*   consumer that just found the ring empty is never woken	*/
+
+	spfence();
+	if (r->spgetwait) {
+		spscwake(&r->spgetwait, r->spgetsem);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  spscdeq  -  Remove a word without blocking; SYSERR if the ring is
+ *		  empty (consumer only)
+ *------------------------------------------------------------------------
+ */
+status	spscdeq(
+	  struct spsc	*r,		/* Ring to remove from		*/
+	  uint32	*wordp		/* Set to the word removed	*/
+	)
+{
+	uint32	head = r->sphead;	/* Only the consumer writes it	*/
+
+	if (head == r->sptail) {
+		return SYSERR;
+	}
+	*wordp = r->spslots[head & r->spmask];
+	spfence();
+	r->sphead = head + 1;
+
+	spfence();
+	if (r->spputwait) {
+		spscwake(&r->spputwait, r->spputsem);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  spscput  -  Add a word, blocking while the ring is full
+ *------------------------------------------------------------------------
+ */
+status	spscput(
+	  struct spsc	*r,		/* Ring to add to		*/
+	  uint32	word		/* Word to add			*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	while (spscenq(r, word) == SYSERR) {
+
+		/* Set the flag, then look again: a get that ran in	*/
+		/*   between either left room or will see the flag	*/
+
+		mask = disable();
+		r->spputwait = TRUE;
+		spfence();
+		if (spscfull(r) && wait(r->spputsem) == SYSERR) {
+			restore(mask);
+			return SYSERR;
+		}
+		r->spputwait = FALSE;
+		restore(mask);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  spscget  -  Remove a word, blocking while the ring is empty
+ *------------------------------------------------------------------------
+ */
+uint32	spscget(
+	  struct spsc	*r		/* Ring to remove from		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint32	word;			/* Word removed			*/
+
+	while (spscdeq(r, &word) == SYSERR) {
+		mask = disable();
+		r->spgetwait = TRUE;
+		spfence();
+		if (spscempty(r) && wait(r->spgetsem) == SYSERR) {
+			restore(mask);
+			return (uint32)SYSERR;
+		}
+		r->spgetwait = FALSE;
+		restore(mask);
+	}
+	return word;
+}
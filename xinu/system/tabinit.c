@@ -0,0 +1,82 @@
+/* tabinit.c - tabinit, tabget */
+
+#include <xinu.h>
+#include <stdlib.h>
+
+int32	nproc = NPROC;			/* Entries in proctab		*/
+int32	nsem = NSEM;			/* Entries in semtab		*/
+int32	nports = NPORTS;		/* Entries in porttab		*/
+
+/*------------------------------------------------------------------------
+ *  tabsize  -  Size of a table: the default, or "name=n" from the boot
+ *		  command line if n lies between the default and max
+ *------------------------------------------------------------------------
+ */
+local	int32	tabsize(
+	  char		*name,		/* Boot argument to look for	*/
+	  int32		dflt,		/* Size configured at build	*/
+	  int32		max		/* Largest size accepted	*/
+	)
+{
+	char	arg[16];		/* Value of the boot argument	*/
+	int32	n;			/* Size requested		*/
+
+	if (getbootarg(name, arg, sizeof(arg)) != OK) {
+		return dflt;
+	}
+	n = atoi(arg);
+	if (n < dflt || n > max) {
+		kprintf("%s=%d ignored: must be %d to %d\n", name, n,
+							dflt, max);
+		return dflt;
+	}
+	return n;
+}
+
+/*------------------------------------------------------------------------
+ *  tabget  -  Allocate a zeroed kernel table at boot, aligned on 16
+ *		 bytes for prfxsave; the table is never freed, and the
+ *		 call panics if the heap cannot hold it
+ *------------------------------------------------------------------------
+ */
+void	*tabget(
+	  uint32	nbytes		/* Size of the table in bytes	*/
+	)
+{
+	char	*tab;			/* Memory for the table		*/
+
+	tab = getmem(nbytes + 15);
+	if (tab == (char *)SYSERR) {
+		panic("tabget: no memory for the kernel tables");
+	}
+	tab = (char *)(((uint32)tab + 15) & ~15);
+	memset(tab, 0, nbytes);
+	return tab;
+}
+
+/*------------------------------------------------------------------------
+ *  tabinit  -  Size the tables indexed by process, semaphore and port
+ *		  ID from the boot command line (nproc=, nsem=, nports=)
+ *		  and allocate them (called once from sysinit)
+ *------------------------------------------------------------------------
+ */
+void	tabinit(void)
+{
+	nproc = tabsize("nproc", NPROC, NPROCMAX);
+	nsem = tabsize("nsem", NSEM, NSEMMAX);
+	nports = tabsize("nports", NPORTS, NPORTSMAX);
+
+	proctab = (struct procent *)tabget(nproc * sizeof(struct procent));
+	proctimer = (struct timer *)tabget(nproc * sizeof(struct timer));
+	cosched = (struct cosched **)tabget(nproc
+						* sizeof(struct cosched *));
+	coown = (struct coown *)tabget(nproc * sizeof(struct coown));
+	semtab = (struct sentry *)tabget(nsem * sizeof(struct sentry));
+	queuetab = (struct qentry *)tabget(NQENT * sizeof(struct qentry));
+	porttab = (struct ptentry *)tabget(nports * sizeof(struct ptentry));
+
+	if (nproc != NPROC || nsem != NSEM || nports != NPORTS) {
+		kprintf("Tables: %d processes, %d semaphores, %d ports\n",
+						nproc, nsem, nports);
+	}
+}
@@ -0,0 +1,237 @@
+/* timer.c - tmrinit, tmrset, tmrcancel, tmrtick, tmrnext */
+
+#include <xinu.h>
+
+struct	timer	*proctimer;		/* Sleep/recvtime timer per	*/
+					/*   process			*/
+uint32	ntimers;			/* Timers currently pending	*/
+
+local	struct	timer	*tmrroot[TMR_ROOTSIZE];	/* 1 ms slots		*/
+local	struct	timer	*tmrlvl[TMR_NLEVELS][TMR_LVLSIZE];
+					/* Coarser slots		*/
+local	uint32	tmrbase;		/* Next tick the wheel handles	*/
+
+/*------------------------------------------------------------------------
+ *  tmrlink  -  Place a timer in the slot that covers its expiry time
+ *------------------------------------------------------------------------
+ */
+local	void	tmrlink(
+	  struct timer	*tp		/* Timer to place		*/
+	)
+{
+	uint32	delta;			/* Ticks from tmrbase to expiry	*/
+	uint32	shift;			/* Bits covered below a level	*/
+	int32	lvl;			/* Level of the wheel		*/
+	struct	timer	**slot;		/* Slot the timer goes in	*/
+
+	delta = tp->texpires - tmrbase;
+	if ((int32)delta < 0) {		/* Already due: next tick	*/
+		tp->texpires = tmrbase;
+		delta = 0;
+	}
+
+	if (delta < TMR_ROOTSIZE) {
+		slot = &tmrroot[tp->texpires & (TMR_ROOTSIZE - 1)];
+	} else {
+		shift = TMR_ROOTBITS;
+		for (lvl = 0; lvl < TMR_NLEVELS - 1; lvl++) {
+			if (delta < (1 << (shift + TMR_LVLBITS))) {
+				break;
+			}
+			shift += TMR_LVLBITS;
+		}
+		slot = &tmrlvl[lvl][(tp->texpires >> shift)
+						& (TMR_LVLSIZE - 1)];
+	}
+
+	tp->tslot = slot;
+	tp->tprev = NULL;
+	tp->tnext = *slot;
+	if (*slot != NULL) {
+		(*slot)->tprev = tp;
+	}
+	*slot = tp;
+}
+
+/*------------------------------------------------------------------------
+ *  tmrunlink  -  Remove a pending timer from its slot
+ *------------------------------------------------------------------------
+ */
+local	void	tmrunlink(
+	  struct timer	*tp		/* Timer to remove		*/
+	)
+{
+	if (tp->tprev == NULL) {
+		*tp->tslot = tp->tnext;
+	} else {
+		tp->tprev->tnext = tp->tnext;
+	}
+	if (tp->tnext != NULL) {
+		tp->tnext->tprev = tp->tprev;
+	}
+	tp->tslot = NULL;
+}
+
+/*------------------------------------------------------------------------
+ *  tmrcascade  -  Move the timers of one coarse slot down the wheel and
+ *		     return the slot index
+ *------------------------------------------------------------------------
+ */
+local	int32	tmrcascade(
+	  int32		lvl,		/* Level to take the slot from	*/
+	  int32		index		/* Slot in that level		*/
+	)
+{
+	struct	timer	*tp, *next;	/* Walk the detached list	*/
+
+	tp = tmrlvl[lvl][index];
+	tmrlvl[lvl][index] = NULL;
+	for (; tp != NULL; tp = next) {
+		next = tp->tnext;
+		tmrlink(tp);
+	}
+	return index;
+}
+
+/*------------------------------------------------------------------------
+ *  tmrinit  -  Initialize the timing wheel (called once from clkinit)
+ *------------------------------------------------------------------------
+ */
+void	tmrinit(void)
+{
+	int32	i, lvl;			/* Slot and level indexes	*/
+
+	for (i = 0; i < TMR_ROOTSIZE; i++) {
+		tmrroot[i] = NULL;
+	}
+	for (lvl = 0; lvl < TMR_NLEVELS; lvl++) {
+		for (i = 0; i < TMR_LVLSIZE; i++) {
+			tmrlvl[lvl][i] = NULL;
+		}
+	}
+	for (i = 0; i < nproc; i++) {
+		proctimer[i].tslot = NULL;
+	}
+	tmrbase = ctr1000;
+	ntimers = 0;
+}
+
+/*------------------------------------------------------------------------
+ *  tmrset  -  Arm a timer to call func(arg) after delay ms, replacing
+ *		 any earlier setting (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+status	tmrset(
+	  struct timer	*tp,		/* Timer to arm			*/
+	  int32		delay,		/* Delay in ms (0: next tick)	*/
+	  void		(*func)(int32),	/* Function to call		*/
+	  int32		arg		/* Argument to pass to func	*/
+	)
+{
+	if (delay < 0 || func == NULL) {
+		return SYSERR;
+	}
+	if (tmrpending(tp)) {
+		tmrunlink(tp);
+		ntimers--;
+	}
+	tp->texpires = ctr1000 + delay;
+	tp->tfunc = func;
+	tp->targ = arg;
+	tmrlink(tp);
+	ntimers++;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  tmrcancel  -  Disarm a timer (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+status	tmrcancel(
+	  struct timer	*tp		/* Timer to disarm		*/
+	)
+{
+	if (!tmrpending(tp)) {
+		return SYSERR;
+	}
+	tmrunlink(tp);
+	ntimers--;
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  tmrtick  -  Advance the wheel to ctr1000 and run every timer that
+ *		  has expired (called from the clock interrupt)
+ *------------------------------------------------------------------------
+ */
+void	tmrtick(void)
+{
+	struct	timer	*tp;		/* Timer being fired		*/
+	int32	index;			/* Slot in the first level	*/
+	int32	lvl;			/* Level being cascaded		*/
+	uint32	shift;			/* Bits covered below a level	*/
+
+	/* Readying several processes causes a single reschedule */
+
+	resched_cntl(DEFER_START);
+	while ((int32)(ctr1000 - tmrbase) >= 0) {
+		index = tmrbase & (TMR_ROOTSIZE - 1);
+
+		/* At the start of each turn, pull the next coarse slot	*/
+		/*   of each level down until one is not at its start	*/
+
+		if (index == 0) {
+			shift = TMR_ROOTBITS;
+			for (lvl = 0; lvl < TMR_NLEVELS; lvl++) {
+				if (tmrcascade(lvl, (tmrbase >> shift)
+						& (TMR_LVLSIZE - 1)) != 0) {
+					break;
+				}
+				shift += TMR_LVLBITS;
+			}
+		}
+
+		/* Fire the timers of this slot; each is unlinked first	*/
+		/*   so that its function may set it again		*/
+
+		while ((tp = tmrroot[index]) != NULL) {
+			tmrunlink(tp);
+			ntimers--;
+			tp->tfunc(tp->targ);
+		}
+		tmrbase++;
+	}
+	resched_cntl(DEFER_STOP);
+}
+
+/*------------------------------------------------------------------------
+ *  tmrnext  -  Return the ms until the next tick on which the wheel has
+ *		  work (a timer to fire or a coarse slot to pull down),
+ *		  or limit if there is none that soon
+ *------------------------------------------------------------------------
+ */
+uint32	tmrnext(
+	  uint32	limit		/* Longest delay of interest	*/
+	)
+{
+	uint32	k;			/* Ticks after tmrbase		*/
+	int32	index;			/* Slot in the first level	*/
+
+	/* Ticks counted by clkwake that the wheel has not caught up	*/
+	/*   with yet are handled on the very next tick			*/
+
+	if ((int32)(tmrbase - ctr1000) <= 0) {
+		return 1;
+	}
+	for (k = 0; k < limit; k++) {
+		index = (tmrbase + k) & (TMR_ROOTSIZE - 1);
+
+		/* Timers on the coarse levels expire no earlier than	*/
+		/*   the start of a turn of the first level		*/
+
+		if (index == 0 || tmrroot[index] != NULL) {
+			return k + 1;
+		}
+	}
+	return limit;
+}
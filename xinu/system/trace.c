@@ -0,0 +1,217 @@
+/* trace.c - traceinit, traceclear, traceevent, tracewake, tracerun,	*/
+/*	       traceirqoff, traceirqon, traceirqspan, traceirqdrop	*/
+
+#include <xinu.h>
+
+bool8	traceon;			/* Is the tracer recording?	*/
+struct	trevent	trring[NTREVENT];	/* Ring of recent events	*/
+uint32	trnext;				/* Events ever recorded		*/
+struct	trsite	trsites[NTRSITE];	/* Interrupts-off by site	*/
+struct	trworst	trworst[NTRWORST];	/* Worst wakeups, worst first	*/
+uint32	trwakehist[NTRHIST];		/* Wakeup latency histogram	*/
+uint32	troffhist[NTRHIST];		/* Interrupts-off histogram	*/
+
+local	uint64	troffstart;		/* TSC when interrupts went off	*/
+local	uint32	troffsite;		/*   and where, or 0 if on	*/
+
+/*------------------------------------------------------------------------
+ *  traceinit  -  Clear the tracer and start it if "trace" is on the boot
+ *		    command line
+ *------------------------------------------------------------------------
+ */
+void	traceinit(void)
+{
+	char	arg[4];			/* Unused argument value	*/
+
+	traceclear();
+	traceon = (getbootarg("trace", arg, sizeof(arg)) == OK);
+}
+
+/*------------------------------------------------------------------------
+ *  traceclear  -  Forget everything recorded so far
+ *------------------------------------------------------------------------
+ */
+void	traceclear(void)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	memset((char *)trring, NULLCH, sizeof(trring));
+	memset((char *)trsites, NULLCH, sizeof(trsites));
+	memset((char *)trworst, NULLCH, sizeof(trworst));
+	memset((char *)trwakehist, NULLCH, sizeof(trwakehist));
+	memset((char *)troffhist, NULLCH, sizeof(troffhist));
+	trnext = 0;
+	troffsite = 0;
+	restore(mask);
+}
+
+/*------------------------------------------------------------------------
+ *  trbucket  -  Histogram bucket of a number of ticks (its log2)
+ *------------------------------------------------------------------------
+ */
+local	int32	trbucket(
+	  uint32	ticks		/* Ticks measured		*/
+	)
+{
+	int32	b = 0;			/* Bucket			*/
+
+	while (ticks > 1 && b < NTRHIST - 1) {
+		ticks >>= 1;
+		b++;
+	}
+	return b;
+}
+
+/*------------------------------------------------------------------------
+ *  trclamp  -  Ticks as 32 bits, saturating
+ *------------------------------------------------------------------------
+ */
+local	uint32	trclamp(
+	  uint64	ticks		/* Interval in ticks		*/
+	)
+{
+	return (ticks >> 32) ? 0xffffffff : (uint32)ticks;
+}
+
+/*------------------------------------------------------------------------
+ *  traceevent  -  Add an event to the ring (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	traceevent(
+	  uint16	type,		/* TR_SWITCH, TR_WAKE, ...	*/
+	  uint32	site,		/* Call site, or 0		*/
+	  uint32	arg		/* Depends on the type		*/
+	)
+{
+	struct	trevent	*evptr;		/* Slot to fill			*/
+
+	evptr = &trring[trnext++ % NTREVENT];
+	evptr->ttime = getticks();
+	evptr->ttype = type;
+	evptr->tpid = currpid;
+	evptr->tsite = site;
+	evptr->targ = arg;
+}
+
+/*------------------------------------------------------------------------
+ *  tracewake  -  Note when a process was made ready (interrupts are
+ *		    disabled)
+ *------------------------------------------------------------------------
+ */
+void	tracewake(
+	  pid32		pid		/* Process made ready		*/
+	)
+{
+	proctab[pid].prwaketsc = getticks();
+}
+
+/*------------------------------------------------------------------------
+ *  tracerun  -  Called by resched for the process about to run: record
+ *		   the switch and, if it was woken, its wakeup latency
+ *------------------------------------------------------------------------
+ */
+void	tracerun(
+	  pid32		pid		/* Process about to run		*/
+	)
+{
+	struct	procent	*prptr;		/* Its process table entry	*/
+	uint32	ticks;			/* ready() to running		*/
+	int32	i, j;			/* Indexes into trworst		*/
+
+	traceevent(TR_SWITCH, 0, pid);
+	prptr = &proctab[pid];
+	if (prptr->prwaketsc == 0) {	/* Preempted, not woken		*/
+		return;
+	}
+	ticks = trclamp(getticks() - prptr->prwaketsc);
+	prptr->prwaketsc = 0;
+	trwakehist[trbucket(ticks)]++;
+	traceevent(TR_WAKE, 0, ticks);
+
+	/* Keep the NTRWORST longest waits, longest first		*/
+
+	for (i = 0; i < NTRWORST && trworst[i].twticks >= ticks; i++) {
+		;
+	}
+	if (i == NTRWORST) {
+		return;
+	}
+	for (j = NTRWORST - 1; j > i; j--) {
+		trworst[j] = trworst[j-1];
+	}
+	trworst[i].twpid = pid;
+	trworst[i].twprio = prptr->prprio;
+	strncpy(trworst[i].twname, prptr->prname, PNMLEN);
+	trworst[i].twticks = ticks;
+}
+
+/*------------------------------------------------------------------------
+ *  traceirqspan  -  Record that interrupts were off for ticks because
+ *		       of the code at site (interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	traceirqspan(
+	  uint32	site,		/* Call site			*/
+	  uint64	ticks		/* Ticks interrupts were off	*/
+	)
+{
+	struct	trsite	*sptr;		/* Record of the site		*/
+	uint32	t = trclamp(ticks);	/* Ticks as 32 bits		*/
+	int32	i, h;			/* Probe count and slot		*/
+
+	troffhist[trbucket(t)]++;
+	h = (site >> 2) % NTRSITE;
+	for (i = 0; i < NTRSITE; i++, h = (h + 1) % NTRSITE) {
+		sptr = &trsites[h];
+		if (sptr->tsaddr == site || sptr->tsaddr == 0) {
+			break;
+		}
+	}
+	if (i == NTRSITE) {		/* Table full: histogram only	*/
+		return;
+	}
+	sptr->tsaddr = site;
+	sptr->tscount++;
+	sptr->tstotal += t;
+	if (t > sptr->tsmax) {
+		sptr->tsmax = t;
+		traceevent(TR_IRQOFF, site, t);
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  traceirqoff  -  Called by disable() when it turns interrupts off
+ *------------------------------------------------------------------------
+ */
+void	traceirqoff(
+	  uint32	site		/* Return address of disable()	*/
+	)
+{
+	troffstart = getticks();
+	troffsite = site;
+}
+
+/*------------------------------------------------------------------------
+ *  traceirqon  -  Called by restore(), enable() and pause() when they
+ *		     turn interrupts back on
+ *------------------------------------------------------------------------
+ */
+void	traceirqon(void)
+{
+	if (troffsite != 0) {
+		traceirqspan(troffsite, getticks() - troffstart);
+		troffsite = 0;
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  traceirqdrop  -  Called on interrupt entry: interrupts were on, so an
+ *		       open interval was ended by a path that is not traced
+ *		       (a new process starting with its initial flags)
+ *------------------------------------------------------------------------
+ */
+void	traceirqdrop(void)
+{
+	troffsite = 0;
+}
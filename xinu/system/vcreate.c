@@ -12,6 +12,7 @@ uint32		*saddr;		/* Stack address		*/
 uint32   _nargs;
 void    *_funcaddr;
 uint32  arg_container[1024];
+status  _status;
 
 /*------------------------------------------------------------------------
  *  create  -  Create a process to start running a function on x86
@@ -31,7 +32,7 @@ pid32	vcreate(
    if (ssize < MINSTK)
       ssize = MINSTK;
    ssize = (uint32) roundmb(ssize);
-   if ( (priority < 1) || ((pid=newpid()) == SYSERR) || (hsize > MAX_HEAP_SIZE) ) {
+   if ( (priority < 1) || (hsize > maxheapframes) || ((pid=newpid()) == SYSERR) ) {
       restore(mask);
       return SYSERR;
    }
@@ -43,14 +44,24 @@ pid32	vcreate(
    /* Initialize process table entry for new process */
    prptr->prstate = PR_SUSP;	/* Initial state is suspended	*/
    prptr->prprio = priority;
+   prptr->prbaseprio = priority;
    prptr->prstklen = ssize;
    prptr->prname[PNMLEN-1] = NULLCH;
    for (i=0 ; i<PNMLEN-1 && (prptr->prname[i]=name[i])!=NULLCH; i++)
       ;
    prptr->prsem = -1;
+   prptr->prmutex = -1;
+   prptr->prmheld = EMPTY;
    prptr->prparent = (pid32)getpid();
    prptr->prhasmsg = FALSE;
    prptr->pruser   = TRUE;
+   prptr->prfair   = fairenabled;
+   prptr->prpass   = fairvtime;
+   prptr->prstart  = getticks();
+   prptr->prcycles = prptr->prsvccyc = 0;
+   prptr->prnvcsw  = prptr->prnivcsw = 0;
+   prptr->prwaketsc = 0;
+   prptr->prfpuused = FALSE;
 
    /* Set up stdin, stdout, and stderr descriptors for the shell	*/
    prptr->prdesc[0] = CONSOLE;
@@ -59,12 +70,22 @@ pid32	vcreate(
 
    /* The following is required to support paging */
    kernel_mode_enter();
-   prptr->pdbr      = create_directory();
+   _status          = create_directory(&prptr->pdbr);
    kernel_mode_exit();
+   if( _status == SYSERR ){
+      prcount--;
+      freepid(pid);
+      restore(mask);
+      return SYSERR;
+   }
 
    prptr->hsize     = hsize;
    prptr->vmax      = ceil_div(((uint32)maxvstack + 1), PAGE_SIZE);
    prptr->vfree     = hsize;
+   prptr->nffs      = prptr->nswap   = 0;
+   prptr->npt       = 1;     /* the directory */
+   prptr->nstk      = 0;
+   prptr->nfaults   = prptr->nevicts = 0;
 
    // Stash everything to safe location before changing pdbr
    _funcaddr        = funcaddr;
@@ -83,6 +104,16 @@ pid32	vcreate(
 #else
    saddr = (uint32 *)getstk(ssize);
 #endif
+   if( (uint32)saddr == SYSERR ){
+      // Out of stack memory even after the OOM killer ran
+      kernel_mode_enter();
+      destroy_directory(pid);
+      kernel_mode_exit();
+      prcount--;
+      freepid(pid);
+      restore(mask);
+      return SYSERR;
+   }
    
    // ------------ POINT OF NO RETURN -------------------
    write_pdbr(prptr->pdbr);
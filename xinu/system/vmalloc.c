@@ -18,8 +18,12 @@ char *vmalloc(uint32 nbytes){
 	}
 
 	vaddr          = prptr->vmax << PAGE_OFFSET_BITS;
-   resume(create(kernel_service_malloc, 1024, prptr->prprio + 1, "malloc", 3, nbytes, FALSE, getpid()));
+   kernel_service(FALSE, NULL, nbytes, FALSE, getpid());
 
+   // The service leaves vmax alone when it runs out of page tables
+   if( (prptr->vmax << PAGE_OFFSET_BITS) == vaddr ){
+      return (char *)SYSERR;
+   }
    return (char*)vaddr;
 }
 
@@ -32,7 +36,10 @@ char *getvstk(uint32 nbytes, pid32 pid){
 	}
 
 	vaddr          = prptr->vmax << PAGE_OFFSET_BITS;
-   resume(create(kernel_service_malloc, 1024, proctab[getpid()].prprio + 1, "getvstk", 3, nbytes, TRUE, pid));
+   kernel_service(FALSE, NULL, nbytes, TRUE, pid);
 
+   if( (prptr->vmax << PAGE_OFFSET_BITS) == vaddr ){
+      return (char *)SYSERR;
+   }
    return (char*)(vaddr + nbytes - sizeof(uint32));
 }
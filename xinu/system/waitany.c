@@ -0,0 +1,253 @@
+/* waitany.c - evinit, evlink, evunlink, waitany, evready, evbad, evnotify, evcancel */
+
+#include <xinu.h>
+
+int32	nevwaiters = 0;			/* Processes inside waitany	*/
+
+local	struct	evwait	**evset;	/* Set a process waits on, or	*/
+					/*   NULL when not in waitany	*/
+local	int32	*evcount;		/* Entries in the set		*/
+local	pid32	evhead = EMPTY;		/* First process in waitany	*/
+local	pid32	*evnext;		/* Next and previous process in	*/
+local	pid32	*evprev;		/*   waitany, or EMPTY		*/
+
+/*------------------------------------------------------------------------
+ *  evinit  -  Allocate the per-process waitany sets (called once from
+ *		 sysinit, after tabinit has sized the process table)
+ *------------------------------------------------------------------------
+ */
+void	evinit(void)
+{
+	evset = (struct evwait **)tabget(nproc * sizeof(struct evwait *));
+	evcount = (int32 *)tabget(nproc * sizeof(int32));
+	evnext = (pid32 *)tabget(nproc * sizeof(pid32));
+	evprev = (pid32 *)tabget(nproc * sizeof(pid32));
+}
+
+/*------------------------------------------------------------------------
+ *  evlink  -  Register a process's set and add it to the list of
+ *		 processes in waitany (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	evlink(
+	  pid32		pid,		/* Process about to block	*/
+	  struct evwait	*evs,		/* Events it waits for		*/
+	  int32		nevs		/* Number of events in evs	*/
+	)
+{
+	evset[pid] = evs;
+	evcount[pid] = nevs;
+	evprev[pid] = EMPTY;
+	evnext[pid] = evhead;
+	if (evhead != EMPTY) {
+		evprev[evhead] = pid;
+	}
+	evhead = pid;
+	nevwaiters++;
+}
+
+/*------------------------------------------------------------------------
+ *  evunlink  -  Drop a process's set and remove it from the list of
+ *		   processes in waitany (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	evunlink(
+	  pid32		pid		/* Process leaving waitany	*/
+	)
+{
+	if (evprev[pid] == EMPTY) {
+		evhead = evnext[pid];
+	} else {
+		evnext[evprev[pid]] = evnext[pid];
+	}
+	if (evnext[pid] != EMPTY) {
+		evprev[evnext[pid]] = evprev[pid];
+	}
+	evset[pid] = NULL;
+	nevwaiters--;
+}
+
+/*------------------------------------------------------------------------
+ *  evready  -  Return TRUE if an event can be consumed without blocking
+ *		  (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+bool8	evready(
+	  struct evwait	*ev		/* Event to check		*/
+	)
+{
+	switch (ev->evtype) {
+	case EV_SEM:
+		return semtab[ev->evid].scount > 0;
+
+	case EV_PORT:
+		return semtab[porttab[ev->evid].ptrsem].scount > 0;
+
+	case EV_UDP:
+		return udptab[ev->evid].udcount > 0;
+
+	case EV_MSG:
+		return proctab[currpid].prhasmsg;
+	}
+	return FALSE;
+}
+
+/*------------------------------------------------------------------------
+ *  evbad  -  Return TRUE if an event names a bad or unallocated object
+ *------------------------------------------------------------------------
+ */
+bool8	evbad(
+	  struct evwait	*ev		/* Event to check		*/
+	)
+{
+	int32	id = ev->evid;		/* Object the event refers to	*/
+
+	switch (ev->evtype) {
+	case EV_SEM:
+		return isbadsem(id) || semtab[id].sstate == S_FREE;
+
+	case EV_PORT:
+		return isbadport(id) || porttab[id].ptstate != PT_ALLOC;
+
+	case EV_UDP:
+		return id < 0 || id >= UDP_SLOTS
+			|| udptab[id].udstate == UDP_FREE;
+
+	case EV_MSG:
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*------------------------------------------------------------------------
+ *  waitany  -  Block until one of a set of events is ready and return
+ *		  its index in the set.  maxwait is in msec: 0 polls and
+ *		  a negative value waits forever.  EV_SEM consumes one
+ *		  count; for the other types the caller receives with
+ *		  ptrecv, udp_recv or receive, which will not block
+ *------------------------------------------------------------------------
+ */
+int32	waitany(
+	  struct evwait	evs[],		/* Events to wait for		*/
+	  int32		nevs,		/* Number of events in evs	*/
+	  int32		maxwait		/* Timeout in msec		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
+	struct	timer	*tp;		/* Timer of the current process	*/
+	bool8	armed = FALSE;		/* Has the timeout been set?	*/
+	int32	i;			/* Index into evs		*/
+
+	if (nevs <= 0 || nevs > EV_MAX) {
+		return SYSERR;
+	}
+	mask = disable();
+	for (i = 0; i < nevs; i++) {
+		if (evbad(&evs[i])) {
+			restore(mask);
+			return SYSERR;
+		}
+	}
+
+	prptr = &proctab[currpid];
+	tp = &proctimer[currpid];
+	while (TRUE) {
+		for (i = 0; i < nevs; i++) {
+			if (evready(&evs[i])) {
+				break;
+			}
+		}
+		if (i < nevs) {
+			break;
+		}
+
+		/* Nothing is ready: give up once the timer has fired */
+
+		if (maxwait == 0 || (armed && !tmrpending(tp))) {
+			restore(mask);
+			return TIMEOUT;
+		}
+		if (maxwait > 0 && !armed) {
+			if (tmrset(tp, maxwait, wakeup, currpid) == SYSERR) {
+				restore(mask);
+				return SYSERR;
+			}
+			armed = TRUE;
+		}
+
+		/* Register the set and block until evnotify or the	*/
+		/*   timer readies this process, then check again	*/
+
+		evlink(currpid, evs, nevs);
+		prptr->prstate = PR_EVENT;
+		resched();
+		evunlink(currpid);
+	}
+
+	if (evs[i].evtype == EV_SEM) {
+		semtab[evs[i].evid].scount--;
+	}
+	if (armed) {
+		tmrcancel(tp);
+	}
+	restore(mask);
+	return i;
+}
+
+/*------------------------------------------------------------------------
+ *  evnotify  -  Ready every process in waitany on an event that has
+ *		   just become ready; only the processes on the waitany
+ *		   list are checked (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	evnotify(
+	  int32		evtype,		/* EV_SEM, EV_UDP or EV_MSG	*/
+	  int32		evid		/* Semaphore, UDP slot or pid	*/
+	)
+{
+	pid32	pid;			/* Process being checked	*/
+	pid32	next;			/* Process after pid		*/
+	struct	evwait	*ev;		/* Event in the process's set	*/
+	int32	i;			/* Index into the set		*/
+
+	resched_cntl(DEFER_START);
+	for (pid = evhead; pid != EMPTY; pid = next) {
+		next = evnext[pid];
+		if (proctab[pid].prstate != PR_EVENT) {
+			continue;	/* Readied, not yet running	*/
+		}
+		for (i = 0; i < evcount[pid]; i++) {
+			ev = &evset[pid][i];
+
+			/* A port becomes ready when its receiver	*/
+			/*   semaphore is signaled			*/
+
+			if ((ev->evtype == evtype && ev->evid == evid
+					&& evtype != EV_MSG)
+			    || (evtype == EV_SEM && ev->evtype == EV_PORT
+					&& porttab[ev->evid].ptrsem == evid)
+			    || (evtype == EV_MSG && ev->evtype == EV_MSG
+					&& pid == evid)) {
+				ready(pid);
+				break;
+			}
+		}
+	}
+	resched_cntl(DEFER_STOP);
+}
+
+/*------------------------------------------------------------------------
+ *  evcancel  -  Drop the waitany registration and timeout of a process
+ *		   being killed (assumes interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+void	evcancel(
+	  pid32		pid		/* ID of process being removed	*/
+	)
+{
+	if (evset[pid] != NULL) {
+		evunlink(pid);
+		tmrcancel(&proctimer[pid]);
+	}
+}
@@ -3,18 +3,21 @@
 #include <xinu.h>
 
 /*------------------------------------------------------------------------
- *  wakeup  -  Called by clock interrupt handler to awaken processes
+ *  wakeup  -  Timer function that awakens a sleeping process, or ends
+ *		 a timed receive or waitany, when its delay runs out
+ *		 (called from tmrtick with rescheduling deferred)
  *------------------------------------------------------------------------
  */
-void	wakeup(void)
+void	wakeup(
+	  int32		pid		/* ID of process to awaken	*/
+	)
 {
-	/* Awaken all processes that have no more time to sleep */
+	struct	procent	*prptr;		/* Ptr to process's table entry	*/
 
-	resched_cntl(DEFER_START);
-	while (nonempty(sleepq) && (firstkey(sleepq) <= 0)) {
-		ready(dequeue(sleepq));
+	prptr = &proctab[pid];
+	if ((prptr->prstate == PR_SLEEP) || (prptr->prstate == PR_RECTIM)
+	    || (prptr->prstate == PR_EVENT)) {
+		ready(pid);
 	}
-
-	resched_cntl(DEFER_STOP);
 	return;
 }
@@ -0,0 +1,294 @@
+/* workq.c - wqinit, wksubmit, wkdelay, wkcancel, wkwait */
+
+#include <xinu.h>
+
+struct	workq	workqtab[NWORKQ];	/* Table of work queues		*/
+
+/*------------------------------------------------------------------------
+ *  wkenqueue  -  Append a job to a queue and wake a worker (assumes
+ *		    interrupts are disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	wkenqueue(
+	  struct work	*w,		/* Job to queue			*/
+	  int32		q		/* Queue to put it on		*/
+	)
+{
+	struct	workq	*wqptr = &workqtab[q];
+
+	w->wkq = q;
+	w->wkstate = WK_QUEUED;
+	w->wkstamp = getticks();
+	w->wknext = NULL;
+	w->wkprev = wqptr->wqtail;
+	if (wqptr->wqtail == NULL) {
+		wqptr->wqhead = w;
+	} else {
+		wqptr->wqtail->wknext = w;
+	}
+	wqptr->wqtail = w;
+	if (++wqptr->wqdepth > wqptr->wqmaxdepth) {
+		wqptr->wqmaxdepth = wqptr->wqdepth;
+	}
+	wqptr->wqsubmits++;
+	signal(wqptr->wqsem);
+}
+
+/*------------------------------------------------------------------------
+ *  wkunlink  -  Remove a job from its queue (assumes interrupts are
+ *		   disabled)
+ *------------------------------------------------------------------------
+ */
+local	void	wkunlink(
+	  struct work	*w		/* Job on the queue		*/
+	)
+{
+	struct	workq	*wqptr = &workqtab[w->wkq];
+
+	if (w->wkprev == NULL) {
+		wqptr->wqhead = w->wknext;
+	} else {
+		w->wkprev->wknext = w->wknext;
+	}
+	if (w->wknext == NULL) {
+		wqptr->wqtail = w->wkprev;
+	} else {
+		w->wknext->wkprev = w->wkprev;
+	}
+	wqptr->wqdepth--;
+}
+
+/*------------------------------------------------------------------------
+ *  wkfire  -  Timer function that queues a delayed job (called from
+ *		 tmrtick with rescheduling deferred)
+ *------------------------------------------------------------------------
+ */
+local	void	wkfire(
+	  int32		arg		/* The job, as an integer	*/
+	)
+{
+	struct	work	*w = (struct work *)arg;
+
+	if (w->wkstate == WK_DELAYED) {
+		wkenqueue(w, w->wkq);
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  wkworker  -  Worker process: run the jobs of one queue in order
+ *------------------------------------------------------------------------
+ */
+local	process	wkworker(
+	  int32		q		/* Queue to serve		*/
+	)
+{
+	struct	workq	*wqptr = &workqtab[q];
+	struct	work	*w;		/* Job being run		*/
+	intmask	mask;			/* Saved interrupt mask		*/
+	uint32	lat;			/* Ticks the job was queued	*/
+	pid32	waiter;			/* Process in wkwait		*/
+
+	while (TRUE) {
+		wait(wqptr->wqsem);
+		mask = disable();
+		w = wqptr->wqhead;
+		if (w == NULL) {	/* Cancelled after the signal	*/
+			restore(mask);
+			continue;
+		}
+		wkunlink(w);
+		lat = (uint32)(getticks() - w->wkstamp);
+		wqptr->wqstarts++;
+		wqptr->wqlatsum += lat;
+		if (lat > wqptr->wqlatmax) {
+			wqptr->wqlatmax = lat;
+		}
+		w->wkstate = WK_RUNNING;
+		restore(mask);
+
+		w->wkfunc(w->wkarg);
+
+		/* The job is idle unless it queued or delayed itself	*/
+
+		mask = disable();
+		wqptr->wqdone++;
+		if (w->wkstate == WK_RUNNING) {
+			w->wkstate = WK_IDLE;
+			waiter = w->wkwaiter;
+			w->wkwaiter = -1;
+			if (waiter >= 0 && proctab[waiter].prstate == PR_WKWAIT) {
+				ready(waiter);
+			}
+		}
+		restore(mask);
+	}
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  wqinit  -  Create the work queues and start their workers
+ *------------------------------------------------------------------------
+ */
+void	wqinit(void)
+{
+	struct	workq	*wqptr;		/* Queue being initialized	*/
+	int32	q;			/* Index into workqtab		*/
+	int32	i;			/* Index of a worker		*/
+	static	char	*wqnames[NWORKQ] = { "wkhigh", "wklow" };
+
+	workqtab[WQ_HIGH].wqprio = WQHIGHPRIO;
+	workqtab[WQ_HIGH].wqnworkers = WQHIGHWORKERS;
+	workqtab[WQ_LOW].wqprio = WQLOWPRIO;
+	workqtab[WQ_LOW].wqnworkers = WQLOWWORKERS;
+
+	for (q = 0; q < NWORKQ; q++) {
+		wqptr = &workqtab[q];
+		wqptr->wqhead = wqptr->wqtail = NULL;
+		wqptr->wqsem = semcreate(0);
+		wqptr->wqdepth = wqptr->wqmaxdepth = 0;
+		wqptr->wqsubmits = wqptr->wqstarts = 0;
+		wqptr->wqdone = wqptr->wqcancels = 0;
+		wqptr->wqlatsum = 0;
+		wqptr->wqlatmax = 0;
+		for (i = 0; i < wqptr->wqnworkers; i++) {
+			wqptr->wqworkers[i] = create(wkworker, WQSTK,
+					wqptr->wqprio, wqnames[q], 1, q);
+			resume(wqptr->wqworkers[i]);
+		}
+	}
+}
+
+/*------------------------------------------------------------------------
+ *  wksubmit  -  Queue a job to run as soon as a worker is free (may be
+ *		   called from interrupt code)
+ *------------------------------------------------------------------------
+ */
+status	wksubmit(
+	  struct work	*w,		/* Job set up with wkinit	*/
+	  int32		q		/* WQ_HIGH or WQ_LOW		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	if (q < 0 || q >= NWORKQ) {
+		return SYSERR;
+	}
+	mask = disable();
+	if (w->wkstate != WK_QUEUED) {	/* A queued job runs once	*/
+		if (w->wkstate == WK_DELAYED) {
+			tmrcancel(&w->wktimer);
+		}
+		wkenqueue(w, q);
+	}
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  wkdelay  -  Queue a job after a delay in msec, replacing any delay
+ *		  already set (may be called from interrupt code)
+ *------------------------------------------------------------------------
+ */
+status	wkdelay(
+	  struct work	*w,		/* Job set up with wkinit	*/
+	  int32		q,		/* WQ_HIGH or WQ_LOW		*/
+	  int32		delay		/* Delay in msec		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	if (delay <= 0) {
+		return wksubmit(w, q);
+	}
+	if (q < 0 || q >= NWORKQ) {
+		return SYSERR;
+	}
+	mask = disable();
+	if (w->wkstate == WK_QUEUED) {	/* It will run sooner anyway	*/
+		restore(mask);
+		return OK;
+	}
+	if (tmrset(&w->wktimer, delay, wkfire, (int32)w) == SYSERR) {
+		restore(mask);
+		return SYSERR;
+	}
+	w->wkq = q;
+	w->wkstate = WK_DELAYED;
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  wkcancel  -  Stop a job that is delayed or queued but not started;
+ *		   return SYSERR if it is idle or already running
+ *------------------------------------------------------------------------
+ */
+status	wkcancel(
+	  struct work	*w		/* Job to cancel		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+	struct	sentry	*semptr;	/* Semaphore of the job's queue	*/
+	pid32	waiter;			/* Process in wkwait		*/
+
+	mask = disable();
+	switch (w->wkstate) {
+	case WK_DELAYED:
+		tmrcancel(&w->wktimer);
+		break;
+
+	case WK_QUEUED:
+		wkunlink(w);
+
+		/* A worker may already have taken the signal; it will	*/
+		/*   find the queue one job short and wait again	*/
+
+		semptr = &semtab[workqtab[w->wkq].wqsem];
+		if (semptr->scount > 0) {
+			semptr->scount--;
+		}
+		break;
+
+	default:
+		restore(mask);
+		return SYSERR;
+	}
+	w->wkstate = WK_IDLE;
+	workqtab[w->wkq].wqcancels++;
+	waiter = w->wkwaiter;
+	w->wkwaiter = -1;
+	if (waiter >= 0 && proctab[waiter].prstate == PR_WKWAIT) {
+		ready(waiter);
+	}
+	restore(mask);
+	return OK;
+}
+
+/*------------------------------------------------------------------------
+ *  wkwait  -  Block until a job is idle: run, cancelled or never
+ *		 queued (one process may wait for a job at a time)
+ *------------------------------------------------------------------------
+ */
+status	wkwait(
+	  struct work	*w		/* Job to wait for		*/
+	)
+{
+	intmask	mask;			/* Saved interrupt mask		*/
+
+	mask = disable();
+	while (w->wkstate != WK_IDLE) {
+
+		/* A waiter that is no longer in wkwait was killed	*/
+
+		if (w->wkwaiter >= 0 && w->wkwaiter != currpid
+		    && proctab[w->wkwaiter].prstate == PR_WKWAIT) {
+			restore(mask);
+			return SYSERR;
+		}
+		w->wkwaiter = currpid;
+		proctab[currpid].prstate = PR_WKWAIT;
+		resched();
+	}
+	restore(mask);
+	return OK;
+}